@@ -0,0 +1,63 @@
+#include "Corpus.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using namespace std;
+using namespace nmea0183_benchmark;
+
+string nmea0183_benchmark::loadCorpus(string const& name)
+{
+    string path = string(NMEA0183_CORPUS_DIR) + "/" + name;
+    ifstream file(path, ios::binary);
+    if (!file) {
+        throw invalid_argument("cannot open corpus file " + path);
+    }
+    stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+vector<string> nmea0183_benchmark::splitSentences(string const& corpus)
+{
+    vector<string> result;
+    size_t start = 0;
+    while (start < corpus.size()) {
+        size_t end = corpus.find('\n', start);
+        if (end == string::npos) {
+            break;
+        }
+        result.push_back(corpus.substr(start, end + 1 - start));
+        start = end + 1;
+    }
+    return result;
+}
+
+string nmea0183_benchmark::sentenceTag(string const& sentence)
+{
+    return sentence.substr(3, 3);
+}
+
+AllocationCounter::AllocationCounter()
+    : m_start(allocationCount())
+{
+}
+
+void AllocationCounter::pause()
+{
+    m_total += allocationCount() - m_start;
+}
+
+void AllocationCounter::resume()
+{
+    m_start = allocationCount();
+}
+
+void AllocationCounter::report(benchmark::State& state, int64_t processed_messages)
+{
+    pause();
+    state.SetItemsProcessed(processed_messages);
+    state.counters["allocs_per_msg"] =
+        processed_messages ? static_cast<double>(m_total) / processed_messages : 0;
+}
@@ -0,0 +1,40 @@
+#ifndef NMEA0183_BENCHMARK_CORPUS_HPP
+#define NMEA0183_BENCHMARK_CORPUS_HPP
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nmea0183_benchmark {
+    /** Raw contents of a file in the bundled corpus directory */
+    std::string loadCorpus(std::string const& name);
+
+    /** Splits a corpus in its sentences, keeping the trailing CR/LF */
+    std::vector<std::string> splitSentences(std::string const& corpus);
+
+    /** Returns the sentence tag (e.g. RMC or VDM) of a raw sentence */
+    std::string sentenceTag(std::string const& sentence);
+
+    /** Number of calls to operator new since the start of the process */
+    uint64_t allocationCount();
+
+    /**
+     * Counts the allocations done since construction, excluding the periods
+     * between pause() and resume()
+     */
+    class AllocationCounter {
+        uint64_t m_start;
+        uint64_t m_total = 0;
+
+    public:
+        AllocationCounter();
+        void pause();
+        void resume();
+
+        /** Reports the counted allocations as an average per processed message */
+        void report(benchmark::State& state, int64_t processed_messages);
+    };
+}
+
+#endif
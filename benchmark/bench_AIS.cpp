@@ -0,0 +1,165 @@
+#include "Corpus.hpp"
+
+#include <marnav/ais/ais.hpp>
+#include <marnav/nmea/nmea.hpp>
+#include <marnav/nmea/vdm.hpp>
+#include <nmea0183/AIS.hpp>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+using namespace nmea0183_benchmark;
+
+namespace {
+    struct AISCorpus {
+        /** VDM sentences of single-fragment messages */
+        vector<unique_ptr<nmea::sentence>> single_fragment;
+        /** VDM sentences of multi-fragment messages, in order */
+        vector<unique_ptr<nmea::sentence>> multi_fragment;
+        /** Framed VDM sentences of single-fragment messages */
+        vector<string> single_fragment_framed;
+        vector<unique_ptr<ais::message>> messages;
+
+        AISCorpus()
+        {
+            Driver driver;
+            AIS ais(driver);
+            for (auto const& line : splitSentences(loadCorpus("ais.nmea"))) {
+                auto sentence = nmea::make_sentence(line.substr(0, line.size() - 2));
+                auto vdm = nmea::sentence_cast<nmea::vdm>(sentence.get());
+                if (auto msg = ais.processSentence(*sentence)) {
+                    messages.push_back(move(msg));
+                }
+
+                if (vdm->get_n_fragments() == 1) {
+                    single_fragment.push_back(move(sentence));
+                    single_fragment_framed.push_back(line);
+                }
+                else {
+                    multi_fragment.push_back(move(sentence));
+                }
+            }
+        }
+
+        template <typename Message>
+        vector<Message> messagesOfType(ais::message_id type) const
+        {
+            vector<Message> result;
+            for (auto const& msg : messages) {
+                if (msg->type() == type) {
+                    result.push_back(*ais::message_cast<Message>(msg.get()));
+                }
+            }
+            return result;
+        }
+    };
+
+    AISCorpus const& corpus()
+    {
+        static AISCorpus corpus;
+        return corpus;
+    }
+
+    void processSentences(benchmark::State& state,
+        vector<unique_ptr<nmea::sentence>> const& sentences)
+    {
+        Driver driver;
+        AIS ais(driver);
+
+        int64_t count = 0;
+        AllocationCounter allocations;
+        for (auto _ : state) {
+            for (auto const& sentence : sentences) {
+                if (ais.processSentence(*sentence)) {
+                    ++count;
+                }
+            }
+        }
+        allocations.report(state, count);
+    }
+}
+
+static void BM_processSentence_single_fragment(benchmark::State& state)
+{
+    processSentences(state, corpus().single_fragment);
+}
+BENCHMARK(BM_processSentence_single_fragment);
+
+static void BM_processSentence_multi_fragment(benchmark::State& state)
+{
+    processSentences(state, corpus().multi_fragment);
+}
+BENCHMARK(BM_processSentence_multi_fragment);
+
+static void BM_reassemble_framed_single_fragment(benchmark::State& state)
+{
+    AIS ais;
+    AIS::Payloads payloads;
+
+    int64_t count = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        for (auto const& line : corpus().single_fragment_framed) {
+            auto buffer = reinterpret_cast<uint8_t const*>(line.data());
+            if (ais.reassemble(buffer, line.size(), payloads)) {
+                ++count;
+            }
+        }
+    }
+    allocations.report(state, count);
+}
+BENCHMARK(BM_reassemble_framed_single_fragment);
+
+static void BM_getPosition(benchmark::State& state)
+{
+    auto messages = corpus().messagesOfType<ais::message_01>(
+        ais::message_id::position_report_class_a);
+
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        for (auto const& msg : messages) {
+            benchmark::DoNotOptimize(AIS::getPosition(msg));
+        }
+    }
+    allocations.report(state, state.iterations() * messages.size());
+}
+BENCHMARK(BM_getPosition);
+
+static void BM_getVesselInformation(benchmark::State& state)
+{
+    auto messages = corpus().messagesOfType<ais::message_05>(
+        ais::message_id::static_and_voyage_related_data);
+
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        for (auto const& msg : messages) {
+            benchmark::DoNotOptimize(AIS::getVesselInformation(msg));
+        }
+    }
+    allocations.report(state, state.iterations() * messages.size());
+}
+BENCHMARK(BM_getVesselInformation);
+
+static void BM_applyPositionCorrection(benchmark::State& state)
+{
+    vector<ais_base::Position> positions;
+    for (auto const& msg : corpus().messagesOfType<ais::message_01>(
+             ais::message_id::position_report_class_a)) {
+        positions.push_back(AIS::getPosition(msg));
+    }
+
+    // The corpora are recorded around Rio de Janeiro, UTM zone 23 south
+    gps_base::UTMConversionParameters parameters = {Eigen::Vector3d::Zero(), 23, false};
+    gps_base::UTMConverter converter(parameters);
+    base::Vector3d sensor2vessel_pos(-10, 2, 0);
+
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        for (auto const& position : positions) {
+            benchmark::DoNotOptimize(
+                AIS::applyPositionCorrection(position, sensor2vessel_pos, converter));
+        }
+    }
+    allocations.report(state, state.iterations() * positions.size());
+}
+BENCHMARK(BM_applyPositionCorrection);
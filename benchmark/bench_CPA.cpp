@@ -0,0 +1,56 @@
+#include "Corpus.hpp"
+
+#include <nmea0183/CPA.hpp>
+#include <random>
+
+using namespace std;
+using namespace nmea0183;
+using namespace nmea0183_benchmark;
+
+namespace {
+    /** Targets spread over 20 nm around own ship, with random course and speed */
+    CPATargets makeTargets(size_t count)
+    {
+        mt19937 rng(42);
+        uniform_real_distribution<double> offset(-0.33, 0.33);
+        uniform_real_distribution<double> course(-M_PI, M_PI);
+        uniform_real_distribution<double> speed(0, 15);
+
+        CPATargets targets;
+        targets.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            ais_base::Position position;
+            position.mmsi = i;
+            position.time = base::Time::fromSeconds(1000);
+            position.latitude = base::Angle::fromDeg(59 + offset(rng));
+            position.longitude = base::Angle::fromDeg(10.5 + offset(rng));
+            position.course_over_ground = base::Angle::fromRad(course(rng));
+            position.speed_over_ground = speed(rng);
+            targets.add(position);
+        }
+        return targets;
+    }
+}
+
+static void BM_CPA_compute(benchmark::State& state)
+{
+    CPATargets targets = makeTargets(state.range(0));
+    ais_base::Position own;
+    own.time = base::Time::fromSeconds(1000);
+    own.latitude = base::Angle::fromDeg(59);
+    own.longitude = base::Angle::fromDeg(10.5);
+    own.course_over_ground = base::Angle::fromDeg(0);
+    own.speed_over_ground = 5;
+
+    CPAResults results;
+    vector<uint32_t> indices;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        CPA::compute(own, targets, base::Time::fromSeconds(1001), results);
+        CPA::screen(results, 1852, base::Time::fromSeconds(1200), indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    allocations.report(state, state.iterations() * targets.size());
+    state.SetItemsProcessed(state.iterations() * targets.size());
+}
+BENCHMARK(BM_CPA_compute)->Arg(100)->Arg(1000)->Arg(10000);
@@ -0,0 +1,170 @@
+#include "Corpus.hpp"
+
+#include <iodrivers_base/TestStream.hpp>
+#include <map>
+#include <nmea0183/Driver.hpp>
+#include <random>
+
+using namespace std;
+using namespace nmea0183;
+using namespace nmea0183_benchmark;
+
+namespace {
+    struct BenchmarkDriver : public Driver {
+        using Driver::extractPacket;
+
+        BenchmarkDriver()
+        {
+            openURI("test://");
+        }
+
+        void push(string const& data)
+        {
+            auto stream = dynamic_cast<iodrivers_base::TestStream*>(getMainStream());
+            stream->pushDataToDriver(vector<uint8_t>(data.begin(), data.end()));
+        }
+    };
+
+    /** Frames a whole buffer the way iodrivers_base does, returns the sentence count */
+    int64_t frameAll(BenchmarkDriver const& driver, string const& data)
+    {
+        auto buffer = reinterpret_cast<uint8_t const*>(data.data());
+        size_t size = data.size();
+        size_t pos = 0;
+        int64_t count = 0;
+        while (pos < size) {
+            int result = driver.extractPacket(buffer + pos, size - pos);
+            if (result == 0) {
+                break;
+            }
+            else if (result > 0) {
+                ++count;
+            }
+            pos += abs(result);
+        }
+        return count;
+    }
+
+    /** Interleaves the sentences of a corpus with random bytes */
+    string addGarbage(string const& corpus)
+    {
+        mt19937 rng(42);
+        uniform_int_distribution<int> length(10, 60);
+        uniform_int_distribution<int> printable(32, 126);
+
+        string result;
+        for (auto const& sentence : splitSentences(corpus)) {
+            int garbage_length = length(rng);
+            for (int i = 0; i < garbage_length; ++i) {
+                result.push_back(static_cast<char>(printable(rng)));
+            }
+            result += sentence;
+        }
+        return result;
+    }
+}
+
+static void BM_extractPacket_clean(benchmark::State& state)
+{
+    BenchmarkDriver driver;
+    string corpus = loadCorpus("mixed.nmea");
+
+    int64_t count = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        count += frameAll(driver, corpus);
+    }
+    allocations.report(state, count);
+    state.SetBytesProcessed(state.iterations() * corpus.size());
+}
+BENCHMARK(BM_extractPacket_clean);
+
+static void BM_extractPacket_trickled(benchmark::State& state)
+{
+    // iodrivers_base calls extractPacket each time new bytes arrive, on the
+    // whole buffer. Worst case is a link that delivers one byte at a time
+    BenchmarkDriver driver;
+    auto sentences = splitSentences(loadCorpus("mixed.nmea"));
+
+    int64_t count = 0;
+    size_t bytes = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        for (auto const& sentence : sentences) {
+            auto buffer = reinterpret_cast<uint8_t const*>(sentence.data());
+            for (size_t size = 1; size <= sentence.size(); ++size) {
+                benchmark::DoNotOptimize(driver.extractPacket(buffer, size));
+            }
+            bytes += sentence.size();
+        }
+        count += sentences.size();
+    }
+    allocations.report(state, count);
+    state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_extractPacket_trickled);
+
+static void BM_extractPacket_garbage(benchmark::State& state)
+{
+    BenchmarkDriver driver;
+    string corpus = addGarbage(loadCorpus("mixed.nmea"));
+
+    int64_t count = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        count += frameAll(driver, corpus);
+    }
+    allocations.report(state, count);
+    state.SetBytesProcessed(state.iterations() * corpus.size());
+}
+BENCHMARK(BM_extractPacket_garbage);
+
+static void BM_readSentence(benchmark::State& state, vector<string> sentences)
+{
+    BenchmarkDriver driver;
+    string block;
+    for (auto const& sentence : sentences) {
+        block += sentence;
+    }
+
+    int64_t count = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        // Pushing data in the test stream is not part of what we measure
+        state.PauseTiming();
+        allocations.pause();
+        driver.push(block);
+        allocations.resume();
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < sentences.size(); ++i) {
+            benchmark::DoNotOptimize(driver.readSentence());
+        }
+        count += sentences.size();
+    }
+    allocations.report(state, count);
+}
+
+namespace {
+    /** Registers one readSentence benchmark per sentence type in the corpora */
+    struct RegisterReadSentenceBenchmarks {
+        RegisterReadSentenceBenchmarks()
+        {
+            map<string, vector<string>> by_tag;
+            for (auto const& name : {"gnss.nmea", "ais.nmea"}) {
+                for (auto const& sentence : splitSentences(loadCorpus(name))) {
+                    by_tag[sentenceTag(sentence)].push_back(sentence);
+                }
+            }
+
+            for (auto const& tag_sentences : by_tag) {
+                benchmark::RegisterBenchmark(
+                    ("BM_readSentence/" + tag_sentences.first).c_str(),
+                    BM_readSentence,
+                    tag_sentences.second);
+            }
+        }
+    };
+
+    RegisterReadSentenceBenchmarks register_read_sentence_benchmarks;
+}
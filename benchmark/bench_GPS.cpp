@@ -0,0 +1,56 @@
+#include "Corpus.hpp"
+
+#include <nmea0183/GPS.hpp>
+
+using namespace std;
+using namespace nmea0183;
+using namespace nmea0183_benchmark;
+
+namespace {
+    vector<string> selectSentences(string const& tag)
+    {
+        vector<string> result;
+        for (auto const& sentence : splitSentences(loadCorpus("gnss.nmea"))) {
+            if (sentenceTag(sentence) == tag) {
+                result.push_back(sentence);
+            }
+        }
+        return result;
+    }
+}
+
+static void BM_parseRMC_framed(benchmark::State& state)
+{
+    auto sentences = selectSentences("RMC");
+    GPS::RMC rmc;
+
+    int64_t count = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        for (auto const& sentence : sentences) {
+            auto buffer = reinterpret_cast<uint8_t const*>(sentence.data());
+            benchmark::DoNotOptimize(GPS::parseRMC(buffer, sentence.size(), rmc));
+        }
+        count += sentences.size();
+    }
+    allocations.report(state, count);
+}
+BENCHMARK(BM_parseRMC_framed);
+
+static void BM_parseGSA_framed(benchmark::State& state)
+{
+    auto sentences = selectSentences("GSA");
+    GPS::GSA gsa;
+
+    int64_t count = 0;
+    AllocationCounter allocations;
+    for (auto _ : state) {
+        for (auto const& sentence : sentences) {
+            auto buffer = reinterpret_cast<uint8_t const*>(sentence.data());
+            benchmark::DoNotOptimize(GPS::parseGSA(buffer, sentence.size(), gsa));
+        }
+        count += sentences.size();
+    }
+    allocations.report(state, count);
+}
+BENCHMARK(BM_parseGSA_framed);
@@ -0,0 +1,50 @@
+#include "Corpus.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Count every heap allocation done in the process, so that benchmarks can
+// report allocations per message
+static std::atomic<uint64_t> allocation_count(0);
+
+uint64_t nmea0183_benchmark::allocationCount()
+{
+    return allocation_count.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+BENCHMARK_MAIN();
@@ -1,8 +1,10 @@
 #include <base-logging/Logging.hpp>
+#include <cmath>
 #include <marnav/ais/ais.hpp>
 #include <marnav/nmea/vdm.hpp>
 #include <nmea0183/AIS.hpp>
 #include <nmea0183/Exceptions.hpp>
+#include <nmea0183/Tracing.hpp>
 
 using namespace std;
 using namespace marnav;
@@ -12,20 +14,48 @@ double constexpr KNOTS_TO_MS = 0.514444;
 double constexpr MS_TO_KNOTS = 1.94384;
 double constexpr MIN_SPEED_FOR_VALID_COURSE = 0.2;
 
+AIS::AIS()
+{
+}
+
 AIS::AIS(Driver& driver)
-    : m_driver(driver)
+    : m_driver(&driver)
 {
 }
 
 unique_ptr<ais::message> AIS::readMessage()
 {
+    if (!m_driver) {
+        throw std::logic_error("AIS::readMessage called on an object without driver");
+    }
+
     while (true) {
-        auto sentence = m_driver.readSentence();
-        auto msg = processSentence(*sentence);
-        if (msg) {
-            return msg;
+        int size = m_driver->readSentencePacket(m_packet, Driver::BUFFER_SIZE);
+        if (reassemble(m_packet, size, m_message)) {
+            m_tag_block = TagBlock::parse(m_packet, size);
+            return decodePayloads(m_message);
+        }
+    }
+}
+
+unique_ptr<ais::message> AIS::tryReadMessage()
+{
+    if (!m_driver) {
+        throw std::logic_error("AIS::tryReadMessage called on an object without driver");
+    }
+
+    while (int size = m_driver->tryReadSentencePacket(m_packet, Driver::BUFFER_SIZE)) {
+        if (reassemble(m_packet, size, m_message)) {
+            m_tag_block = TagBlock::parse(m_packet, size);
+            return decodePayloads(m_message);
         }
     }
+    return nullptr;
+}
+
+TagBlock const& AIS::getTagBlock() const
+{
+    return m_tag_block;
 }
 
 uint32_t AIS::getDiscardedSentenceCount() const
@@ -33,16 +63,140 @@ uint32_t AIS::getDiscardedSentenceCount() const
     return m_discarded_sentence_count;
 }
 
+bool AIS::processStaticDataReport(ais::message_24 const& message,
+    ais_base::VesselInformation& info)
+{
+    return m_static_data_cache.process(message, base::Time::now(), info);
+}
+
+AISStaticDataCache& AIS::getStaticDataCache()
+{
+    return m_static_data_cache;
+}
+
+AISStaticDataCache const& AIS::getStaticDataCache() const
+{
+    return m_static_data_cache;
+}
+
+AISGeofence& AIS::getGeofence()
+{
+    return m_geofence;
+}
+
+AISGeofence const& AIS::getGeofence() const
+{
+    return m_geofence;
+}
+
+uint32_t AIS::getGeofenceRejectedCount() const
+{
+    return m_geofence_rejected_count;
+}
+
+size_t AIS::getPendingFragmentCount() const
+{
+    return payloads.size();
+}
+
+AIS::Payloads const& AIS::getPendingFragments() const
+{
+    return payloads;
+}
+
+void AIS::setPendingFragments(Payloads const& fragments)
+{
+    payloads = fragments;
+    m_first_fragment_time = NMEA0183_TRACE_NOW();
+}
+
 unique_ptr<ais::message> AIS::processSentence(nmea::sentence const& sentence)
 {
-    if (sentence.id() != nmea::sentence_id::VDM) {
+    Payloads payloads;
+    if (!reassemble(sentence, payloads)) {
         return unique_ptr<ais::message>();
     }
+    return decodePayloads(payloads);
+}
+
+unique_ptr<ais::message> AIS::processSentence(uint8_t const* buffer, size_t size)
+{
+    Payloads payloads;
+    if (!reassemble(buffer, size, payloads)) {
+        return unique_ptr<ais::message>();
+    }
+    return decodePayloads(payloads);
+}
+
+bool AIS::reassemble(nmea::sentence const& sentence, Payloads& result)
+{
+    if (sentence.id() != nmea::sentence_id::VDM) {
+        return false;
+    }
 
     auto vdm = nmea::sentence_cast<nmea::vdm>(&sentence);
+    return reassemble(vdm->get_n_fragments(),
+        vdm->get_fragment(),
+        vdm->get_payload(),
+        vdm->get_n_fill_bits(),
+        result);
+}
 
-    size_t n_fragments = vdm->get_n_fragments();
-    size_t fragment = vdm->get_fragment();
+static size_t parseVDMNumber(string_view field)
+{
+    if (field.empty() || field.size() > 2) {
+        throw MarnavParsingError("invalid VDM field '" + string(field) + "'");
+    }
+    size_t value = 0;
+    for (char c : field) {
+        if (c < '0' || c > '9') {
+            throw MarnavParsingError("invalid VDM field '" + string(field) + "'");
+        }
+        value = value * 10 + (c - '0');
+    }
+    return value;
+}
+
+bool AIS::reassemble(uint8_t const* buffer, size_t size, Payloads& result)
+{
+    if (Driver::peekSentenceTag(buffer, size) != "VDM") {
+        return false;
+    }
+
+    // !AIVDM,n_fragments,fragment,sequence,channel,payload,fill_bits*hh
+    size_t tag_block_size = TagBlock::getSize(buffer, size);
+    string_view sentence(reinterpret_cast<char const*>(buffer) + tag_block_size,
+        size - tag_block_size);
+    sentence = sentence.substr(0, sentence.rfind('*'));
+
+    string_view fields[7];
+    size_t field_count = 0;
+    size_t start = 0;
+    while (start != string_view::npos) {
+        if (field_count == 7) {
+            throw MarnavParsingError("invalid VDM sentence, expected 6 fields");
+        }
+        size_t end = sentence.find(',', start);
+        fields[field_count++] = sentence.substr(start, end - start);
+        start = end == string_view::npos ? end : end + 1;
+    }
+    if (field_count != 7) {
+        throw MarnavParsingError("invalid VDM sentence, expected 6 fields");
+    }
+
+    return reassemble(parseVDMNumber(fields[1]),
+        parseVDMNumber(fields[2]),
+        fields[5],
+        parseVDMNumber(fields[6]),
+        result);
+}
+
+bool AIS::reassemble(size_t n_fragments,
+    size_t fragment,
+    string_view payload,
+    uint32_t n_fill_bits,
+    Payloads& result)
+{
     if (fragment != payloads.size() + 1) {
         m_discarded_sentence_count += payloads.size();
         payloads.clear();
@@ -50,18 +204,49 @@ unique_ptr<ais::message> AIS::processSentence(nmea::sentence const& sentence)
         // Go on if we're receiving the first fragment of a new message
         if (fragment != 1) {
             m_discarded_sentence_count++;
-            return unique_ptr<ais::message>();
+            return false;
         }
     }
 
-    payloads.push_back(make_pair(vdm->get_payload(), vdm->get_n_fill_bits()));
+    if (fragment == 1) {
+        m_first_fragment_time = NMEA0183_TRACE_NOW();
+    }
+    if (n_fragments == 1) {
+        // Single-fragment messages, i.e. most of the traffic, are written
+        // directly in the result to reuse its storage
+        NMEA0183_TRACE_RECORD(STAGE_REASSEMBLY, m_first_fragment_time);
+        result.resize(1);
+        result[0].first.assign(payload.data(), payload.size());
+        result[0].second = n_fill_bits;
+        return acceptGeofence(result);
+    }
+    payloads.push_back(make_pair(string(payload), n_fill_bits));
 
     if (payloads.size() != n_fragments) {
-        return unique_ptr<ais::message>();
+        return false;
     }
 
+    NMEA0183_TRACE_RECORD(STAGE_REASSEMBLY, m_first_fragment_time);
+
+    result = std::move(payloads);
+    payloads.clear();
+    return acceptGeofence(result);
+}
+
+bool AIS::acceptGeofence(Payloads const& payloads)
+{
+    // The position fields are always in the first fragment
+    if (m_geofence.accept(payloads.front().first)) {
+        return true;
+    }
+    m_geofence_rejected_count++;
+    return false;
+}
+
+unique_ptr<ais::message> AIS::decodePayloads(Payloads const& payloads)
+{
+    NMEA0183_TRACE_SCOPE(STAGE_DECODE);
     try {
-        auto payloads = std::move(this->payloads);
         return ais::make_message(payloads);
     }
     catch (std::exception const& e) {
@@ -81,6 +266,7 @@ template <typename T> base::Angle optionalAngleToRock(utils::optional<T> opt)
 
 ais_base::Position AIS::getPosition(ais::message_01 const& message)
 {
+    NMEA0183_TRACE_SCOPE(STAGE_POSITION);
     ais_base::Position position;
     position.time = base::Time::now();
     position.mmsi = message.get_mmsi();
@@ -99,35 +285,74 @@ ais_base::Position AIS::getPosition(ais::message_01 const& message)
     return position;
 }
 
-ais_base::VesselInformation AIS::getVesselInformation(ais::message_05 const& message)
+double AIS::getRateOfTurn(ais::message_01 const& message)
+{
+    auto rot = message.get_rot();
+    if (!rot.available() || rot.is_more_5deg30s_right() ||
+        rot.is_more_5deg30s_left()) {
+        return base::unknown<double>();
+    }
+    else if (rot.is_not_turning()) {
+        return 0;
+    }
+    // AIS is in degrees per minute, positive to starboard
+    return -rot.value() * M_PI / 180 / 60;
+}
+
+static string trimTrailingSpaces(string const& text)
+{
+    int first_not_space = text.find_last_not_of(" ");
+    return text.substr(0, first_not_space + 1);
+}
+
+template <typename Message>
+static void setDimensions(ais_base::VesselInformation& info, Message const& message)
 {
-    ais_base::VesselInformation info;
-    info.time = base::Time::now();
-    info.mmsi = message.get_mmsi();
-    info.imo = message.get_imo_number();
-    string name = message.get_shipname();
-    int first_not_space = name.find_last_not_of(" ");
-    info.name = name.substr(0, first_not_space + 1);
-    string call_sign = message.get_callsign();
-    first_not_space = call_sign.find_last_not_of(" ");
-    info.call_sign = call_sign.substr(0, first_not_space + 1);
     auto distance_to_stern = message.get_to_stern();
     auto distance_to_starboard = message.get_to_starboard();
     float length = message.get_to_bow() + distance_to_stern;
     float width = message.get_to_port() + distance_to_starboard;
     info.length = length;
     info.width = width;
-    info.draft = static_cast<float>(message.get_draught()) / 10;
-    info.ship_type = static_cast<ais_base::ShipType>(message.get_shiptype());
-    info.epfd_fix = static_cast<ais_base::EPFDFixType>(message.get_epfd_fix());
     info.reference_position = Eigen::Vector3d(distance_to_stern - (length / 2.0),
         distance_to_starboard - (width / 2.0),
         0);
+}
+
+ais_base::VesselInformation AIS::getVesselInformation(ais::message_05 const& message)
+{
+    ais_base::VesselInformation info;
+    info.time = base::Time::now();
+    info.mmsi = message.get_mmsi();
+    info.imo = message.get_imo_number();
+    info.name = trimTrailingSpaces(message.get_shipname());
+    info.call_sign = trimTrailingSpaces(message.get_callsign());
+    setDimensions(info, message);
+    info.draft = static_cast<float>(message.get_draught()) / 10;
+    info.ship_type = static_cast<ais_base::ShipType>(message.get_shiptype());
+    info.epfd_fix = static_cast<ais_base::EPFDFixType>(message.get_epfd_fix());
 
     info.ensureEnumsValid();
     return info;
 }
 
+void AIS::updateVesselInformation(ais_base::VesselInformation& info,
+    ais::message_24 const& message)
+{
+    info.mmsi = message.get_mmsi();
+    if (message.get_part_number() == ais::message_24::part::A) {
+        info.name = trimTrailingSpaces(message.get_shipname());
+        return;
+    }
+
+    info.call_sign = trimTrailingSpaces(message.get_callsign());
+    info.ship_type = static_cast<ais_base::ShipType>(message.get_shiptype());
+    if (!message.is_auxiliary_vessel()) {
+        setDimensions(info, message);
+    }
+    info.ensureEnumsValid();
+}
+
 ais_base::VoyageInformation AIS::getVoyageInformation(ais::message_05 const& message)
 {
     ais_base::VoyageInformation info;
@@ -199,6 +424,7 @@ ais_base::Position AIS::applyPositionCorrection(ais_base::Position const& sensor
     base::Vector3d const& sensor2vessel_pos,
     gps_base::UTMConverter const& utm_converter)
 {
+    NMEA0183_TRACE_SCOPE(STAGE_CORRECTION);
     auto vessel_pos = sensor_pos;
     if (std::isnan(sensor_pos.yaw.getRad()) &&
         std::isnan(sensor_pos.course_over_ground.getRad())) {
@@ -277,6 +503,16 @@ safe_optional_gps_position(base::Angle latitude, base::Angle longitude)
             : marnav::utils::optional<marnav::geo::longitude>{longitude.getDeg()}};
 }
 
+/**
+ * @brief Converts an angle to degrees in [0, 360), as AIS expects for course and
+ * heading. base::Angle normalizes to [-180, 180)
+ */
+static double angleToAISDegrees(base::Angle const& angle)
+{
+    double deg = angle.getDeg();
+    return deg < 0 ? deg + 360 : deg;
+}
+
 ais::message_05 AIS::getMessageFromVesselInformation(
     ais_base::VesselInformation const& info)
 {
@@ -310,8 +546,13 @@ ais::message_01 AIS::getMessageFromPosition(ais_base::Position const& position)
         safe_optional_gps_position(position.latitude, position.longitude);
     message.set_latitude(safe_latitude);
     message.set_longitude(safe_longitude);
-    message.set_cog(safe_optional(position.course_over_ground.getDeg()));
-    message.set_hdg(safe_optional<double, uint32_t>(position.yaw.getDeg()));
+    message.set_cog(safe_optional(angleToAISDegrees(position.course_over_ground)));
+    // The heading is in whole degrees, round instead of truncating
+    double heading = angleToAISDegrees(position.yaw);
+    if (!base::isUnknown(heading)) {
+        heading = fmod(round(heading), 360);
+    }
+    message.set_hdg(safe_optional<double, uint32_t>(heading));
     message.set_sog(safe_optional(position.speed_over_ground * MS_TO_KNOTS));
     message.set_maneuver_indicator(
         static_cast<marnav::ais::maneuver_indicator_id>(position.maneuver_indicator));
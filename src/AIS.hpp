@@ -9,25 +9,78 @@
 
 #include <marnav/ais/message_01.hpp>
 #include <marnav/ais/message_05.hpp>
+#include <marnav/ais/message_24.hpp>
+#include <nmea0183/AISGeofence.hpp>
+#include <nmea0183/AISStaticDataCache.hpp>
 
 #include <gps_base/UTMConverter.hpp>
 
 namespace nmea0183 {
     class AIS {
+    public:
+        /** The armored payloads and fill bits of the fragments of a message */
+        typedef std::vector<std::pair<std::string, std::uint32_t>> Payloads;
+
+    private:
         uint32_t m_discarded_sentence_count = 0;
-        Driver& m_driver;
-        std::vector<std::pair<std::string, std::uint32_t>> payloads;
+        uint32_t m_geofence_rejected_count = 0;
+        Driver* m_driver = nullptr;
+        Payloads payloads;
+        /** Time of the first fragment of the pending message, for tracing */
+        uint64_t m_first_fragment_time = 0;
+
+        /** Buffers reused across calls to readMessage */
+        uint8_t m_packet[Driver::BUFFER_SIZE];
+        Payloads m_message;
+        TagBlock m_tag_block;
+
+        AISStaticDataCache m_static_data_cache;
+        AISGeofence m_geofence;
+
+        bool reassemble(size_t n_fragments, size_t fragment,
+            std::string_view payload, uint32_t n_fill_bits, Payloads& result);
+        bool acceptGeofence(Payloads const& payloads);
 
     public:
+        /** Create an AIS decoder that is only fed through processSentence */
+        AIS();
         AIS(Driver& driver);
 
         /** Read an AIS message
          *
          * This calls the underlying NMEA driver until a full
          * AIS message is received and returns it
+         *
+         * Sentences are read framed, and the VDM fields are extracted in
+         * place, without creating marnav sentence objects. Other sentences
+         * are skipped without being parsed
+         *
+         * @throw std::logic_error if the object was created without a driver
          */
         std::unique_ptr<marnav::ais::message> readMessage();
 
+        /** Read an AIS message if one can be completed without blocking
+         *
+         * It processes the sentences available in the driver with
+         * Driver::tryReadSentence, until a message is complete or no
+         * sentence is left
+         *
+         * @return the message, or null if none could be completed
+         * @throw std::logic_error if the object was created without a driver
+         */
+        std::unique_ptr<marnav::ais::message> tryReadMessage();
+
+        /** The TAG block of the sentence that completed the last message
+         * returned by readMessage() or tryReadMessage()
+         *
+         * These methods read framed sentences, so Driver::getTagBlock() is
+         * not updated by them. The valid flag is false if the sentence had
+         * no TAG block. The fields point into an internal buffer of this
+         * object and are valid until the next call to readMessage() or
+         * tryReadMessage()
+         */
+        TagBlock const& getTagBlock() const;
+
         /**
          * Process a NMEA sentence and return an AIS message if one is
          * available
@@ -41,11 +94,107 @@ namespace nmea0183 {
         std::unique_ptr<marnav::ais::message> processSentence(
             marnav::nmea::sentence const& sentence);
 
+        /**
+         * Add a NMEA sentence to the message reconstruction, without decoding
+         * the resulting message
+         *
+         * This is the first half of processSentence. It allows to do the
+         * decoding separately, e.g. in another thread, with decodePayloads
+         *
+         * @param payloads set to the payloads of the completed message if
+         *   there is one
+         * @return true if a message has been completed, and is not rejected
+         *   by the geofence
+         */
+        bool reassemble(marnav::nmea::sentence const& sentence, Payloads& payloads);
+
+        /**
+         * Add a framed sentence to the message reconstruction
+         *
+         * This is reassemble() without going through a marnav sentence,
+         * for sentences obtained with Driver::readSentencePacket or
+         * FramedSentence. Sentences that are not VDM are ignored.
+         *
+         * The completed message is written in the given payloads, reusing
+         * their storage. Reusing the same object across calls avoids any
+         * allocation for single-fragment messages.
+         *
+         * @param buffer the sentence, possibly with a TAG block
+         * @param size the sentence size, including the trailing CR/LF
+         * @throw MarnavParsingError if the VDM fields are invalid
+         */
+        bool reassemble(uint8_t const* buffer, size_t size, Payloads& payloads);
+
+        /** processSentence for a framed sentence
+         *
+         * @see reassemble(uint8_t const*, size_t, Payloads&)
+         */
+        std::unique_ptr<marnav::ais::message> processSentence(
+            uint8_t const* buffer, size_t size);
+
+        /**
+         * Decode the payloads of a reassembled AIS message
+         *
+         * @throw MarnavParsingError if the message cannot be decoded
+         */
+        static std::unique_ptr<marnav::ais::message> decodePayloads(
+            Payloads const& payloads);
+
+        /** Join a class B static data report (type 24) with the other part
+         * received for the same vessel
+         *
+         * @param info set to the vessel information if both parts are known
+         * @return true if info has been set
+         * @see AISStaticDataCache
+         */
+        bool processStaticDataReport(marnav::ais::message_24 const& message,
+            ais_base::VesselInformation& info);
+
+        /** The cache used by processStaticDataReport */
+        AISStaticDataCache& getStaticDataCache();
+
+        /** @overload */
+        AISStaticDataCache const& getStaticDataCache() const;
+
+        /** The area outside of which position reports are dropped
+         *
+         * The filter is applied on the reassembled payloads, in reassemble,
+         * processSentence and readMessage. Messages of targets outside the
+         * area are dropped before being decoded. It is empty, i.e. accepts
+         * everything, by default.
+         */
+        AISGeofence& getGeofence();
+
+        /** @overload */
+        AISGeofence const& getGeofence() const;
+
+        /** Returns the count of messages that have been dropped because they
+         * were outside the geofence
+         */
+        uint32_t getGeofenceRejectedCount() const;
+
         /** Returns the count of sentences that have been discarded because
          * of some reordering/reassembly issues
          */
         uint32_t getDiscardedSentenceCount() const;
 
+        /** Returns the count of fragments received for the AIS message
+         * currently being reassembled
+         */
+        size_t getPendingFragmentCount() const;
+
+        /** The fragments received for the AIS message currently being
+         * reassembled
+         */
+        Payloads const& getPendingFragments() const;
+
+        /** Restore the fragments of a message being reassembled, e.g. from a
+         * snapshot
+         *
+         * The next fragment to be processed is expected to follow them
+         */
+        void setPendingFragments(Payloads const& fragments);
+
         /**
          * Applies position correction using the vessel reference position and the sensor
          * offset
@@ -84,8 +233,26 @@ namespace nmea0183 {
             double speed_over_ground);
 
         static ais_base::Position getPosition(marnav::ais::message_01 const& message);
+
+        /** The rate of turn of a position report, in rad/s
+         *
+         * It follows Rock's convention, i.e. positive when turning left. It
+         * is unknown if the message does not provide it, or only tells that
+         * the vessel turns faster than 5 deg per 30s
+         */
+        static double getRateOfTurn(marnav::ais::message_01 const& message);
         static ais_base::VesselInformation getVesselInformation(
             marnav::ais::message_05 const& message);
+        /** Set the fields of a vessel information provided by one part of
+         * a class B static data report
+         *
+         * Part A sets the name. Part B sets the ship type, call sign,
+         * dimensions and reference position. Auxiliary craft have no
+         * dimensions, since their part B gives the MMSI of their mother
+         * ship instead
+         */
+        static void updateVesselInformation(ais_base::VesselInformation& info,
+            marnav::ais::message_24 const& message);
         static ais_base::VoyageInformation getVoyageInformation(
             marnav::ais::message_05 const& message);
         static marnav::ais::message_05 getMessageFromVesselInformation(
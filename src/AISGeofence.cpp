@@ -0,0 +1,209 @@
+#include <nmea0183/AISGeofence.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <nmea0183/AISPayload.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace nmea0183;
+
+AISGeofence::AISGeofence(int grid_size)
+    : m_grid_size(grid_size)
+{
+    if (grid_size <= 0) {
+        throw invalid_argument("AISGeofence: grid size must be strictly positive");
+    }
+}
+
+void AISGeofence::addPolygon(vector<GeofencePoint> const& vertices)
+{
+    if (vertices.size() < 3) {
+        throw invalid_argument("AISGeofence: a polygon needs at least 3 vertices");
+    }
+    m_areas.push_back(vertices);
+    updateGrid();
+}
+
+void AISGeofence::addBoundingBox(double min_latitude,
+    double min_longitude,
+    double max_latitude,
+    double max_longitude)
+{
+    if (!(min_latitude < max_latitude) || !(min_longitude < max_longitude)) {
+        throw invalid_argument("AISGeofence: invalid bounding box");
+    }
+    addPolygon({{min_latitude, min_longitude},
+        {min_latitude, max_longitude},
+        {max_latitude, max_longitude},
+        {max_latitude, min_longitude}});
+}
+
+void AISGeofence::clear()
+{
+    m_areas.clear();
+    m_cells.clear();
+}
+
+bool AISGeofence::isEmpty() const
+{
+    return m_areas.empty();
+}
+
+/** Crossing number test */
+static bool polygonContains(vector<GeofencePoint> const& polygon,
+    double latitude,
+    double longitude)
+{
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        GeofencePoint const& a = polygon[i];
+        GeofencePoint const& b = polygon[j];
+        if ((a.latitude > latitude) != (b.latitude > latitude)) {
+            double crossing = a.longitude + (latitude - a.latitude) /
+                                                (b.latitude - a.latitude) *
+                                                (b.longitude - a.longitude);
+            if (longitude < crossing) {
+                inside = !inside;
+            }
+        }
+    }
+    return inside;
+}
+
+/** Liang-Barsky clipping of a segment by a box */
+static bool segmentIntersectsBox(GeofencePoint const& a,
+    GeofencePoint const& b,
+    GeofencePoint const& box_min,
+    GeofencePoint const& box_max)
+{
+    double d_latitude = b.latitude - a.latitude;
+    double d_longitude = b.longitude - a.longitude;
+    double p[4] = {-d_longitude, d_longitude, -d_latitude, d_latitude};
+    double q[4] = {a.longitude - box_min.longitude,
+        box_max.longitude - a.longitude,
+        a.latitude - box_min.latitude,
+        box_max.latitude - a.latitude};
+
+    double t0 = 0;
+    double t1 = 1;
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0) {
+            if (q[i] < 0) {
+                return false;
+            }
+            continue;
+        }
+
+        double t = q[i] / p[i];
+        if (p[i] < 0) {
+            t0 = max(t0, t);
+        }
+        else {
+            t1 = min(t1, t);
+        }
+        if (t0 > t1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AISGeofence::updateGrid()
+{
+    m_min_latitude = m_min_longitude = INFINITY;
+    m_max_latitude = m_max_longitude = -INFINITY;
+    for (auto const& area : m_areas) {
+        for (auto const& vertex : area) {
+            m_min_latitude = min(m_min_latitude, vertex.latitude);
+            m_min_longitude = min(m_min_longitude, vertex.longitude);
+            m_max_latitude = max(m_max_latitude, vertex.latitude);
+            m_max_longitude = max(m_max_longitude, vertex.longitude);
+        }
+    }
+    // Avoid null cells for degenerate (flat) polygons
+    m_cell_height = max((m_max_latitude - m_min_latitude) / m_grid_size, 1e-9);
+    m_cell_width = max((m_max_longitude - m_min_longitude) / m_grid_size, 1e-9);
+
+    m_cells.assign(m_grid_size * m_grid_size, CELL_OUTSIDE);
+    for (int row = 0; row < m_grid_size; ++row) {
+        for (int column = 0; column < m_grid_size; ++column) {
+            GeofencePoint cell_min = {m_min_latitude + row * m_cell_height,
+                m_min_longitude + column * m_cell_width};
+            GeofencePoint cell_max = {cell_min.latitude + m_cell_height,
+                cell_min.longitude + m_cell_width};
+
+            uint8_t state = CELL_OUTSIDE;
+            for (auto const& area : m_areas) {
+                bool boundary = false;
+                for (size_t i = 0, j = area.size() - 1; i < area.size(); j = i++) {
+                    if (segmentIntersectsBox(area[j], area[i], cell_min, cell_max)) {
+                        boundary = true;
+                        break;
+                    }
+                }
+
+                // Without an edge crossing the cell, the cell is either
+                // fully inside or fully outside the polygon
+                if (boundary) {
+                    state = CELL_BOUNDARY;
+                }
+                else if (polygonContains(area,
+                             cell_min.latitude + m_cell_height / 2,
+                             cell_min.longitude + m_cell_width / 2)) {
+                    state = CELL_INSIDE;
+                    break;
+                }
+            }
+            m_cells[row * m_grid_size + column] = state;
+        }
+    }
+}
+
+bool AISGeofence::containsExact(double latitude, double longitude) const
+{
+    for (auto const& area : m_areas) {
+        if (polygonContains(area, latitude, longitude)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AISGeofence::contains(double latitude, double longitude) const
+{
+    if (m_areas.empty()) {
+        return false;
+    }
+    // Written so that NaNs fail the test
+    if (!(latitude >= m_min_latitude && latitude <= m_max_latitude &&
+            longitude >= m_min_longitude && longitude <= m_max_longitude)) {
+        return false;
+    }
+
+    int row = min<int>(m_grid_size - 1, (latitude - m_min_latitude) / m_cell_height);
+    int column =
+        min<int>(m_grid_size - 1, (longitude - m_min_longitude) / m_cell_width);
+    switch (m_cells[row * m_grid_size + column]) {
+        case CELL_INSIDE:
+            return true;
+        case CELL_OUTSIDE:
+            return false;
+        default:
+            return containsExact(latitude, longitude);
+    }
+}
+
+bool AISGeofence::accept(string const& payload) const
+{
+    if (m_areas.empty()) {
+        return true;
+    }
+
+    double latitude;
+    double longitude;
+    if (!AISPayload::getPosition(payload, latitude, longitude)) {
+        return true;
+    }
+    return contains(latitude, longitude);
+}
@@ -0,0 +1,86 @@
+#ifndef NMEA0183_AIS_GEOFENCE_HPP
+#define NMEA0183_AIS_GEOFENCE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace nmea0183 {
+    struct GeofencePoint {
+        double latitude;
+        double longitude;
+    };
+
+    /**
+     * Area of operations, used to reject AIS messages of far-away targets
+     * before decoding them
+     *
+     * The area is the union of polygons and bounding boxes, in degrees.
+     * Edges are straight lines in the latitude/longitude plane, and areas
+     * must not cross the antimeridian.
+     *
+     * A grid is precomputed over the bounding box of all areas. Each cell
+     * is marked as fully inside, fully outside or on the boundary, so that
+     * only points that fall in boundary cells are tested against the
+     * polygons.
+     */
+    class AISGeofence {
+    public:
+        static const int DEFAULT_GRID_SIZE = 64;
+
+    private:
+        enum CellState : uint8_t { CELL_OUTSIDE, CELL_INSIDE, CELL_BOUNDARY };
+
+        int m_grid_size;
+        std::vector<std::vector<GeofencePoint>> m_areas;
+        std::vector<uint8_t> m_cells;
+        double m_min_latitude = 0;
+        double m_min_longitude = 0;
+        double m_max_latitude = 0;
+        double m_max_longitude = 0;
+        double m_cell_height = 0;
+        double m_cell_width = 0;
+
+        void updateGrid();
+        bool containsExact(double latitude, double longitude) const;
+
+    public:
+        /** @param grid_size the number of grid cells in both latitude and
+         *    longitude
+         * @throw std::invalid_argument if grid_size is not strictly positive
+         */
+        explicit AISGeofence(int grid_size = DEFAULT_GRID_SIZE);
+
+        /** Add a polygon to the area
+         *
+         * @throw std::invalid_argument if it has less than 3 vertices
+         */
+        void addPolygon(std::vector<GeofencePoint> const& vertices);
+
+        /** Add a bounding box to the area
+         *
+         * @throw std::invalid_argument if the minimum is not lower than the
+         *   maximum
+         */
+        void addBoundingBox(double min_latitude, double min_longitude,
+            double max_latitude, double max_longitude);
+
+        /** Remove all areas. An empty geofence accepts everything */
+        void clear();
+
+        bool isEmpty() const;
+
+        /** Whether a point is inside the area. Always false for NaN */
+        bool contains(double latitude, double longitude) const;
+
+        /** Whether an armored AIS payload should be decoded
+         *
+         * Only the position fields of position reports are decoded, with
+         * AISPayload::getPosition. Messages without a position are
+         * accepted, position reports whose position is unavailable are not.
+         */
+        bool accept(std::string const& payload) const;
+    };
+}
+
+#endif
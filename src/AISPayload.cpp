@@ -0,0 +1,124 @@
+#include <nmea0183/AISPayload.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+using namespace nmea0183;
+
+static uint8_t decodeArmoredChar(char c)
+{
+    uint8_t value = static_cast<uint8_t>(c) - 48;
+    return value > 40 ? value - 8 : value;
+}
+
+bool AISPayload::hasBits(string const& payload, size_t start, size_t count)
+{
+    return payload.size() * 6 >= start + count;
+}
+
+uint32_t AISPayload::getUnsigned(string const& payload, size_t start, size_t count)
+{
+    if (count == 0 || count > 32) {
+        throw invalid_argument("AIS field sizes must be between 1 and 32 bits");
+    }
+    else if (!hasBits(payload, start, count)) {
+        throw out_of_range("AIS payload too short for the requested field");
+    }
+
+    uint64_t value = 0;
+    size_t first_char = start / 6;
+    size_t last_char = (start + count - 1) / 6;
+    for (size_t i = first_char; i <= last_char; ++i) {
+        value = (value << 6) | decodeArmoredChar(payload[i]);
+    }
+
+    size_t trailing_bits = (last_char + 1) * 6 - (start + count);
+    value >>= trailing_bits;
+    return value & ((uint64_t(1) << count) - 1);
+}
+
+int32_t AISPayload::getSigned(string const& payload, size_t start, size_t count)
+{
+    uint32_t value = getUnsigned(payload, start, count);
+    if (count < 32 && (value & (uint32_t(1) << (count - 1)))) {
+        value |= ~((uint32_t(1) << count) - 1);
+    }
+    return static_cast<int32_t>(value);
+}
+
+uint8_t AISPayload::getMessageType(string const& payload)
+{
+    if (!hasBits(payload, 0, 6)) {
+        return 0;
+    }
+    return getUnsigned(payload, 0, 6);
+}
+
+uint32_t AISPayload::getMMSI(string const& payload)
+{
+    if (!hasBits(payload, 8, 30)) {
+        return 0;
+    }
+    return getUnsigned(payload, 8, 30);
+}
+
+/** Location and resolution of the position fields of a message type */
+struct PositionFields {
+    uint16_t longitude_start;
+    uint8_t longitude_bits;
+    uint16_t latitude_start;
+    uint8_t latitude_bits;
+    /** Field units per degree */
+    double resolution;
+};
+
+static bool getPositionFields(uint8_t type, PositionFields& fields)
+{
+    switch (type) {
+        case 1:
+        case 2:
+        case 3:
+        case 9:
+            fields = {61, 28, 89, 27, 600000};
+            return true;
+        case 4:
+        case 11:
+            fields = {79, 28, 107, 27, 600000};
+            return true;
+        case 18:
+        case 19:
+            fields = {57, 28, 85, 27, 600000};
+            return true;
+        case 21:
+            fields = {164, 28, 192, 27, 600000};
+            return true;
+        case 27:
+            fields = {44, 18, 62, 17, 600};
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool AISPayload::getPosition(string const& payload, double& latitude, double& longitude)
+{
+    PositionFields fields;
+    if (!getPositionFields(getMessageType(payload), fields) ||
+        !hasBits(payload, fields.latitude_start, fields.latitude_bits)) {
+        return false;
+    }
+
+    double raw_longitude = getSigned(payload, fields.longitude_start, fields.longitude_bits);
+    double raw_latitude = getSigned(payload, fields.latitude_start, fields.latitude_bits);
+    longitude = raw_longitude / fields.resolution;
+    latitude = raw_latitude / fields.resolution;
+    // 181 and 91 degrees mean "not available"
+    if (longitude == 181) {
+        longitude = NAN;
+    }
+    if (latitude == 91) {
+        latitude = NAN;
+    }
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef NMEA0183_AIS_PAYLOAD_HPP
+#define NMEA0183_AIS_PAYLOAD_HPP
+
+#include <cstdint>
+#include <string>
+
+namespace nmea0183 {
+    /**
+     * @brief Direct access to the fields of a 6-bit armored AIS payload
+     *
+     * This allows to look at a few fields of a message without decoding it
+     * fully with marnav
+     */
+    namespace AISPayload {
+        /**
+         * @brief Whether the payload holds at least start + count bits
+         */
+        bool hasBits(std::string const& payload, size_t start, size_t count);
+
+        /**
+         * @brief Extract an unsigned field
+         *
+         * @param payload the armored payload
+         * @param start the index of the field's first bit
+         * @param count the field size in bits, between 1 and 32
+         * @throw std::invalid_argument if count is zero or bigger than 32
+         * @throw std::out_of_range if the payload is too short
+         */
+        uint32_t getUnsigned(std::string const& payload, size_t start, size_t count);
+
+        /**
+         * @brief Extract a two's complement signed field
+         *
+         * @see getUnsigned
+         */
+        int32_t getSigned(std::string const& payload, size_t start, size_t count);
+
+        /**
+         * @brief The message type, or 0 if the payload is empty
+         */
+        uint8_t getMessageType(std::string const& payload);
+
+        /**
+         * @brief The MMSI of the message's source, or 0 if the payload is too
+         * short to contain one
+         */
+        uint32_t getMMSI(std::string const& payload);
+
+        /**
+         * @brief Extract the position of the position reports (types 1, 2,
+         * 3, 4, 9, 11, 18, 19, 21 and 27), without decoding the rest
+         *
+         * @param latitude set to the latitude in degrees, NaN if the message
+         *   says that it is not available
+         * @param longitude set to the longitude in degrees, NaN if the
+         *   message says that it is not available
+         * @return false if the message has no position, or the payload is
+         *   too short to contain it
+         */
+        bool getPosition(std::string const& payload, double& latitude,
+            double& longitude);
+    };
+}
+
+#endif
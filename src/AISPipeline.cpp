@@ -0,0 +1,265 @@
+#include <nmea0183/AISPipeline.hpp>
+
+#include <iodrivers_base/Exceptions.hpp>
+#include <marnav/ais/ais.hpp>
+#include <nmea0183/AISPayload.hpp>
+#include <nmea0183/Exceptions.hpp>
+#include <nmea0183/Tracing.hpp>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+
+AISPipeline::AISPipeline(Driver& driver, Callback callback, size_t worker_count)
+    : m_driver(driver)
+    , m_callback(callback)
+    , m_worker_count(worker_count)
+{
+    if (!m_worker_count) {
+        unsigned int cores = thread::hardware_concurrency();
+        m_worker_count = cores > 3 ? cores - 2 : 1;
+    }
+    m_max_queued_jobs = 64 * m_worker_count;
+}
+
+AISPipeline::~AISPipeline()
+{
+    try {
+        stop();
+    }
+    catch (...) {
+    }
+}
+
+void AISPipeline::start()
+{
+    if (m_io_thread.joinable()) {
+        throw logic_error("AISPipeline::start called on a running pipeline");
+    }
+
+    m_stop_reading = false;
+    m_io_done = false;
+    m_running_workers = m_worker_count;
+    m_error = exception_ptr();
+    m_pending.clear();
+
+    m_output_thread = thread(&AISPipeline::outputLoop, this);
+    for (size_t i = 0; i < m_worker_count; ++i) {
+        m_workers.emplace_back(&AISPipeline::workerLoop, this);
+    }
+    m_io_thread = thread(&AISPipeline::readLoop, this);
+}
+
+void AISPipeline::stop()
+{
+    if (!m_io_thread.joinable()) {
+        return;
+    }
+
+    // Each stage terminates once its input is closed and drained
+    m_stop_reading = true;
+    m_io_thread.join();
+    for (auto& t : m_workers) {
+        t.join();
+    }
+    m_workers.clear();
+    m_output_thread.join();
+
+    if (m_error) {
+        rethrow_exception(m_error);
+    }
+}
+
+void AISPipeline::setError(exception_ptr error)
+{
+    lock_guard<mutex> guard(m_error_lock);
+    if (!m_error) {
+        m_error = error;
+    }
+    m_stop_reading = true;
+}
+
+void AISPipeline::readLoop()
+{
+    AIS ais;
+
+    while (!m_stop_reading) {
+        unique_ptr<nmea::sentence> sentence;
+        try {
+            sentence = m_driver.readSentence();
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+            continue;
+        }
+        catch (MarnavParsingError const&) {
+            m_parse_errors++;
+            continue;
+        }
+        catch (...) {
+            setError(current_exception());
+            break;
+        }
+        m_sentences++;
+
+        Job job;
+        bool complete = ais.reassemble(*sentence, job.payloads);
+        m_discarded_fragments = ais.getDiscardedSentenceCount();
+        if (!complete) {
+            continue;
+        }
+
+        job.mmsi = AISPayload::getMMSI(job.payloads.front().first);
+        {
+            lock_guard<mutex> guard(m_result_lock);
+            job.sequence = m_pending[job.mmsi].next_assigned++;
+        }
+        job.trace_id = NMEA0183_TRACE_CURRENT_ID();
+        job.queued_at = NMEA0183_TRACE_NOW();
+
+        unique_lock<mutex> guard(m_job_lock);
+        m_job_slot_available.wait(guard, [&] {
+            return m_jobs.size() < m_max_queued_jobs || m_stop_reading;
+        });
+        m_jobs.push_back(move(job));
+        guard.unlock();
+        m_job_available.notify_one();
+    }
+
+    {
+        lock_guard<mutex> guard(m_job_lock);
+        m_io_done = true;
+    }
+    m_job_available.notify_all();
+}
+
+void AISPipeline::workerLoop()
+{
+    while (true) {
+        Job job;
+        {
+            unique_lock<mutex> guard(m_job_lock);
+            m_job_available.wait(guard, [&] { return !m_jobs.empty() || m_io_done; });
+            if (m_jobs.empty()) {
+                break;
+            }
+            job = move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+        m_job_slot_available.notify_one();
+
+        NMEA0183_TRACE_SET_ID(job.trace_id);
+        NMEA0183_TRACE_RECORD(STAGE_QUEUE, job.queued_at);
+        Result result = decode(job);
+        if (!result.valid) {
+            m_decode_errors++;
+        }
+
+        {
+            lock_guard<mutex> guard(m_result_lock);
+            m_results.emplace_back(job.mmsi, move(result));
+        }
+        m_result_available.notify_one();
+    }
+
+    {
+        lock_guard<mutex> guard(m_result_lock);
+        m_running_workers--;
+    }
+    m_result_available.notify_all();
+}
+
+void AISPipeline::outputLoop()
+{
+    bool failed = false;
+
+    while (true) {
+        deque<pair<uint32_t, Result>> results;
+        vector<PendingResults*> targets;
+        {
+            unique_lock<mutex> guard(m_result_lock);
+            m_result_available.wait(guard, [&] {
+                return !m_results.empty() || m_running_workers == 0;
+            });
+            if (m_results.empty()) {
+                break;
+            }
+            results.swap(m_results);
+            for (auto const& r : results) {
+                targets.push_back(&m_pending[r.first]);
+            }
+        }
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            auto& r = results[i];
+            auto& mmsi_pending = *targets[i];
+            uint64_t sequence = r.second.sequence;
+            mmsi_pending.results.emplace(sequence, move(r.second));
+
+            auto it = mmsi_pending.results.begin();
+            while (it != mmsi_pending.results.end() &&
+                   it->first == mmsi_pending.next_sequence) {
+                if (it->second.valid && !failed) {
+                    m_messages++;
+                    try {
+                        m_callback(it->second.output);
+                    }
+                    catch (...) {
+                        // Keep draining the pipeline so that stop() does
+                        // not deadlock, but do not deliver anything anymore
+                        failed = true;
+                        setError(current_exception());
+                    }
+                }
+                it = mmsi_pending.results.erase(it);
+                mmsi_pending.next_sequence++;
+            }
+        }
+
+        lock_guard<mutex> guard(m_result_lock);
+        for (auto const& r : results) {
+            auto it = m_pending.find(r.first);
+            if (it != m_pending.end() && it->second.results.empty() &&
+                it->second.next_sequence == it->second.next_assigned) {
+                m_pending.erase(it);
+            }
+        }
+    }
+}
+
+AISPipeline::Result AISPipeline::decode(Job const& job)
+{
+    Result result;
+    result.sequence = job.sequence;
+    result.output.mmsi = job.mmsi;
+
+    try {
+        result.output.message = AIS::decodePayloads(job.payloads);
+    }
+    catch (MarnavParsingError const&) {
+        return result;
+    }
+
+    auto const& message = *result.output.message;
+    // Types 2 and 3 derive from message_01 in marnav
+    if (auto position = dynamic_cast<ais::message_01 const*>(&message)) {
+        result.output.position = AIS::getPosition(*position);
+    }
+    else if (message.type() == ais::message_id::static_and_voyage_related_data) {
+        auto const& info = *ais::message_cast<ais::message_05>(&message);
+        result.output.vessel_information = AIS::getVesselInformation(info);
+        result.output.voyage_information = AIS::getVoyageInformation(info);
+    }
+    result.valid = true;
+    return result;
+}
+
+AISPipelineStatistics AISPipeline::getStatistics() const
+{
+    AISPipelineStatistics stats;
+    stats.sentences = m_sentences;
+    stats.messages = m_messages;
+    stats.parse_errors = m_parse_errors;
+    stats.decode_errors = m_decode_errors;
+    stats.discarded_fragments = m_discarded_fragments;
+    return stats;
+}
@@ -0,0 +1,158 @@
+#ifndef NMEA0183_AIS_PIPELINE_HPP
+#define NMEA0183_AIS_PIPELINE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nmea0183/AIS.hpp>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace nmea0183 {
+    /** One message decoded by AISPipeline */
+    struct AISPipelineOutput {
+        uint32_t mmsi = 0;
+        std::unique_ptr<marnav::ais::message> message;
+        /** Set for position reports (message types 1, 2 and 3) */
+        std::optional<ais_base::Position> position;
+        /** Set for static and voyage related data (message type 5) */
+        std::optional<ais_base::VesselInformation> vessel_information;
+        /** Set for static and voyage related data (message type 5) */
+        std::optional<ais_base::VoyageInformation> voyage_information;
+    };
+
+    struct AISPipelineStatistics {
+        uint64_t sentences = 0;
+        uint64_t messages = 0;
+        uint64_t parse_errors = 0;
+        uint64_t decode_errors = 0;
+        uint64_t discarded_fragments = 0;
+    };
+
+    /**
+     * Multi-threaded AIS decoding
+     *
+     * The decoding is split in three stages:
+     *
+     * - an I/O thread reads and parses the sentences from the driver, and
+     *   reassembles the AIS fragments. It reads the source MMSI directly from
+     *   the armored payload and gives the message a per-MMSI sequence number
+     * - a pool of worker threads decodes the payloads and converts the
+     *   messages to their ais_base representation
+     * - an output thread puts the messages of each MMSI back in reception
+     *   order and calls the callback
+     *
+     * Messages from different vessels may be delivered in a different order
+     * than they were received.
+     *
+     * The driver must not be used by anything else while the pipeline runs.
+     * Its read timeout bounds how long stop() may wait for the I/O thread.
+     */
+    class AISPipeline {
+    public:
+        typedef std::function<void(AISPipelineOutput& output)> Callback;
+
+    private:
+        struct Job {
+            uint32_t mmsi = 0;
+            uint64_t sequence = 0;
+            AIS::Payloads payloads;
+            /** Tracing ID of the message, and time it got queued */
+            uint64_t trace_id = 0;
+            uint64_t queued_at = 0;
+        };
+
+        struct Result {
+            uint64_t sequence = 0;
+            /** False if the message could not be decoded. It is not
+             * delivered, but it must still advance the per-MMSI sequence */
+            bool valid = false;
+            AISPipelineOutput output;
+        };
+
+        /** Ordering state of the messages of a MMSI
+         *
+         * next_assigned is only touched by the I/O thread, the other fields
+         * by the output thread. The entry is removed once all messages
+         * assigned a sequence have been delivered, so that the map only
+         * holds the MMSIs that have messages in flight.
+         */
+        struct PendingResults {
+            uint64_t next_assigned = 0;
+            uint64_t next_sequence = 0;
+            std::map<uint64_t, Result> results;
+        };
+
+        Driver& m_driver;
+        Callback m_callback;
+        size_t m_worker_count;
+        size_t m_max_queued_jobs;
+
+        std::thread m_io_thread;
+        std::vector<std::thread> m_workers;
+        std::thread m_output_thread;
+
+        std::atomic<bool> m_stop_reading{false};
+        std::mutex m_error_lock;
+        std::exception_ptr m_error;
+
+        std::mutex m_job_lock;
+        std::condition_variable m_job_available;
+        std::condition_variable m_job_slot_available;
+        std::deque<Job> m_jobs;
+        bool m_io_done = false;
+
+        std::mutex m_result_lock;
+        std::condition_variable m_result_available;
+        std::deque<std::pair<uint32_t, Result>> m_results;
+        /** Lookups and insertions are protected by m_result_lock */
+        std::unordered_map<uint32_t, PendingResults> m_pending;
+        size_t m_running_workers = 0;
+
+        std::atomic<uint64_t> m_sentences{0};
+        std::atomic<uint64_t> m_messages{0};
+        std::atomic<uint64_t> m_parse_errors{0};
+        std::atomic<uint64_t> m_decode_errors{0};
+        std::atomic<uint64_t> m_discarded_fragments{0};
+
+        void readLoop();
+        void workerLoop();
+        void outputLoop();
+
+        void setError(std::exception_ptr error);
+        static Result decode(Job const& job);
+
+    public:
+        /**
+         * @param driver the driver the sentences are read from
+         * @param callback called from the output thread for each decoded
+         *   message
+         * @param worker_count the number of decoding threads. Defaults to the
+         *   number of cores minus the I/O and output threads
+         */
+        AISPipeline(Driver& driver, Callback callback, size_t worker_count = 0);
+        ~AISPipeline();
+
+        /** Start the threads */
+        void start();
+
+        /** Stop reading, and wait for the messages already read to be
+         * delivered
+         *
+         * Rethrows the first error raised by the driver or by the callback.
+         * Either of these stops the pipeline.
+         */
+        void stop();
+
+        AISPipelineStatistics getStatistics() const;
+    };
+}
+
+#endif
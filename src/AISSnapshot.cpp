@@ -0,0 +1,178 @@
+#include <nmea0183/AISSnapshot.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <nmea0183/MappedFile.hpp>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+// File layout, all integers in host byte order
+//
+//   header: magic[8] version:u32 record_size:u32 time:i64 record_count:u64
+//           fragment_count:u32 reserved:u32
+//   records: AISTargetRecord[record_count]
+//   fragments: fill_bits:u32 size:u32 payload[size]
+static const char SNAPSHOT_MAGIC[8] = {'N', 'M', 'E', 'A', 'S', 'N', 'P', '1'};
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const size_t HEADER_SIZE = 40;
+static const size_t FRAGMENT_HEADER_SIZE = 8;
+
+template <typename T> static void writeValue(ostream& stream, T value)
+{
+    stream.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+/** Flush a file, or a directory entry, to the disk */
+static void sync(string const& path, int flags)
+{
+    int fd = open(path.c_str(), flags);
+    if (fd == -1) {
+        throw runtime_error("cannot open " + path + " to sync it");
+    }
+    int ret = fsync(fd);
+    close(fd);
+    if (ret != 0) {
+        throw runtime_error("failed to sync " + path);
+    }
+}
+
+static string directoryOf(string const& path)
+{
+    size_t slash = path.rfind('/');
+    if (slash == string::npos) {
+        return ".";
+    }
+    return slash == 0 ? "/" : path.substr(0, slash);
+}
+
+template <typename T> static T readValue(uint8_t const* data)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void AISSnapshot::save(string const& path,
+    AISTargetState const& state,
+    AIS const& ais,
+    base::Time const& time)
+{
+    string temp_path = path + ".tmp";
+    {
+        ofstream file(temp_path, ios::binary | ios::trunc);
+        if (!file) {
+            throw runtime_error("cannot open " + temp_path + " for writing");
+        }
+
+        auto const& records = state.getRecords();
+        auto const& fragments = ais.getPendingFragments();
+        file.write(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        writeValue<uint32_t>(file, SNAPSHOT_VERSION);
+        writeValue<uint32_t>(file, sizeof(AISTargetRecord));
+        writeValue<int64_t>(file, time.toMicroseconds());
+        writeValue<uint64_t>(file, records.size());
+        writeValue<uint32_t>(file, fragments.size());
+        writeValue<uint32_t>(file, 0);
+        file.write(reinterpret_cast<char const*>(records.data()),
+            records.size() * sizeof(AISTargetRecord));
+        for (auto const& fragment : fragments) {
+            writeValue<uint32_t>(file, fragment.second);
+            writeValue<uint32_t>(file, fragment.first.size());
+            file.write(fragment.first.data(), fragment.first.size());
+        }
+
+        file.flush();
+        if (!file) {
+            throw runtime_error("failed to write " + temp_path);
+        }
+    }
+
+    // Make the data durable before the rename, and the rename durable
+    // after it, so that a power loss does not leave an empty snapshot
+    sync(temp_path, O_WRONLY);
+    if (rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw runtime_error("cannot rename " + temp_path + " into " + path);
+    }
+    sync(directoryOf(path), O_RDONLY | O_DIRECTORY);
+}
+
+AISSnapshotStatistics AISSnapshot::load(string const& path,
+    AISTargetState& state,
+    AIS& ais,
+    base::Time const& now,
+    AISSnapshotAging const& aging)
+{
+    MappedFile file(path);
+    uint8_t const* data = file.data();
+    size_t size = file.size();
+    if (size < HEADER_SIZE || memcmp(data, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC))) {
+        throw invalid_argument(path + " is not an AIS snapshot");
+    }
+    if (readValue<uint32_t>(data + 8) != SNAPSHOT_VERSION ||
+        readValue<uint32_t>(data + 12) != sizeof(AISTargetRecord)) {
+        throw invalid_argument(path + " was saved by an incompatible version");
+    }
+
+    AISSnapshotStatistics stats;
+    stats.time = base::Time::fromMicroseconds(readValue<int64_t>(data + 16));
+    uint64_t record_count = readValue<uint64_t>(data + 24);
+    uint32_t fragment_count = readValue<uint32_t>(data + 32);
+    if (record_count > (size - HEADER_SIZE) / sizeof(AISTargetRecord)) {
+        throw invalid_argument(path + " is truncated");
+    }
+
+    // Validate the whole file before changing the state
+    AIS::Payloads fragments;
+    size_t offset = HEADER_SIZE + record_count * sizeof(AISTargetRecord);
+    for (uint32_t i = 0; i < fragment_count; ++i) {
+        if (size - offset < FRAGMENT_HEADER_SIZE) {
+            throw invalid_argument(path + " is truncated");
+        }
+        uint32_t fill_bits = readValue<uint32_t>(data + offset);
+        uint32_t payload_size = readValue<uint32_t>(data + offset + 4);
+        offset += FRAGMENT_HEADER_SIZE;
+        if (size - offset < payload_size) {
+            throw invalid_argument(path + " is truncated");
+        }
+        fragments.emplace_back(
+            string(reinterpret_cast<char const*>(data + offset), payload_size),
+            fill_bits);
+        offset += payload_size;
+    }
+
+    int64_t min_position_time = (now - aging.max_position_age).toMicroseconds();
+    int64_t min_vessel_information_time =
+        (now - aging.max_vessel_information_age).toMicroseconds();
+    uint8_t const* records = data + HEADER_SIZE;
+    for (uint64_t i = 0; i < record_count; ++i) {
+        AISTargetRecord record;
+        memcpy(&record, records + i * sizeof(AISTargetRecord), sizeof(record));
+        if (record.position_time < min_position_time) {
+            record.flags &= ~AISTargetRecord::HAS_POSITION;
+        }
+        if (record.vessel_information_time < min_vessel_information_time) {
+            record.flags &= ~AISTargetRecord::HAS_VESSEL_INFORMATION;
+        }
+
+        if (record.flags & (AISTargetRecord::HAS_POSITION |
+                               AISTargetRecord::HAS_VESSEL_INFORMATION)) {
+            state.set(record);
+            stats.restored_targets++;
+        }
+        else {
+            stats.expired_targets++;
+        }
+    }
+
+    if (now - stats.time > aging.max_fragment_age) {
+        return stats;
+    }
+    ais.setPendingFragments(fragments);
+    stats.restored_fragments = fragments.size();
+    return stats;
+}
@@ -0,0 +1,82 @@
+#ifndef NMEA0183_AIS_SNAPSHOT_HPP
+#define NMEA0183_AIS_SNAPSHOT_HPP
+
+#include <base/Time.hpp>
+#include <nmea0183/AIS.hpp>
+#include <nmea0183/AISTargetState.hpp>
+#include <string>
+
+namespace nmea0183 {
+    /** How old snapshot entries may be to be restored */
+    struct AISSnapshotAging {
+        base::Time max_position_age = base::Time::fromSeconds(600);
+        base::Time max_vessel_information_age = base::Time::fromSeconds(3600);
+        /** Pending fragments are restored only if the snapshot is more
+         * recent than this
+         */
+        base::Time max_fragment_age = base::Time::fromSeconds(5);
+    };
+
+    struct AISSnapshotStatistics {
+        /** Time at which the snapshot was saved */
+        base::Time time;
+        uint64_t restored_targets = 0;
+        /** Targets that were dropped because all their data is too old */
+        uint64_t expired_targets = 0;
+        uint64_t restored_fragments = 0;
+    };
+
+    /**
+     * Warm-start snapshots of the AIS decoding state
+     *
+     * A snapshot holds the records of an AISTargetState and the fragments
+     * of the message being reassembled by an AIS object. Records are stored
+     * as-is, so that loading a snapshot is a memory mapping and a copy.
+     *
+     * The parts of class B static data reports waiting in the AIS object's
+     * AISStaticDataCache are not saved. The static data already joined is
+     * in the AISTargetState records, but a part received just before the
+     * shutdown is only joined again once both parts are received after the
+     * restart, i.e. after up to one reporting period (6 minutes).
+     *
+     * ~~~ cpp
+     * // At shutdown, or periodically
+     * AISSnapshot::save("ais.snapshot", state, ais);
+     * // At startup
+     * AISSnapshot::load("ais.snapshot", state, ais);
+     * ~~~
+     */
+    namespace AISSnapshot {
+        /** Save a snapshot
+         *
+         * The snapshot is written to a temporary file first, synced to
+         * the disk and renamed, so that neither a crash nor a power loss
+         * while saving leaves a partial snapshot
+         *
+         * @throw std::runtime_error if the file cannot be written
+         */
+        void save(std::string const& path,
+            AISTargetState const& state,
+            AIS const& ais,
+            base::Time const& time = base::Time::now());
+
+        /** Load a snapshot
+         *
+         * The position and static data of each target are dropped if they
+         * are older than the limits in aging, and the target if both are.
+         * The restored targets replace the ones with the same MMSI in state.
+         *
+         * @param now the current time, to which the entries' age is computed
+         * @throw std::system_error if the file cannot be opened
+         * @throw std::invalid_argument if the file is not a snapshot or was
+         *   saved by an incompatible version
+         */
+        AISSnapshotStatistics load(std::string const& path,
+            AISTargetState& state,
+            AIS& ais,
+            base::Time const& now = base::Time::now(),
+            AISSnapshotAging const& aging = AISSnapshotAging());
+    }
+}
+
+#endif
@@ -0,0 +1,118 @@
+#include <nmea0183/AISStaticDataCache.hpp>
+
+#include <algorithm>
+#include <nmea0183/AIS.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+
+AISStaticDataCache::AISStaticDataCache(size_t max_size, base::Time const& max_age)
+    : m_max_age(max_age)
+{
+    setMaxSize(max_size);
+}
+
+void AISStaticDataCache::setMaxSize(size_t max_size)
+{
+    if (max_size == 0) {
+        throw invalid_argument("AISStaticDataCache: max size must be strictly positive");
+    }
+    m_max_size = max_size;
+    shrinkTo(max_size);
+}
+
+void AISStaticDataCache::setMaxAge(base::Time const& max_age)
+{
+    m_max_age = max_age;
+}
+
+void AISStaticDataCache::removeLast()
+{
+    m_index.erase(m_entries.back().mmsi);
+    m_entries.pop_back();
+}
+
+void AISStaticDataCache::shrinkTo(size_t size)
+{
+    while (m_entries.size() > size) {
+        removeLast();
+        m_evicted_count++;
+    }
+}
+
+bool AISStaticDataCache::process(ais::message_24 const& message,
+    base::Time const& time,
+    ais_base::VesselInformation& info)
+{
+    base::Time min_time = time - m_max_age;
+    removeOlderThan(min_time);
+
+    int mmsi = message.get_mmsi();
+    auto it = m_index.find(mmsi);
+    if (it == m_index.end()) {
+        shrinkTo(m_max_size - 1);
+        m_entries.push_front(Entry{mmsi, base::Time(), base::Time(), {}});
+        m_entries.front().info.mmsi = mmsi;
+        it = m_index.emplace(mmsi, m_entries.begin()).first;
+    }
+    else {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+    }
+
+    Entry& entry = *it->second;
+    AIS::updateVesselInformation(entry.info, message);
+    base::Time other_time;
+    if (message.get_part_number() == ais::message_24::part::A) {
+        entry.part_a_time = time;
+        other_time = entry.part_b_time;
+    }
+    else {
+        entry.part_b_time = time;
+        other_time = entry.part_a_time;
+    }
+
+    if (other_time.isNull() || other_time < min_time) {
+        return false;
+    }
+    info = entry.info;
+    info.time = time;
+    return true;
+}
+
+size_t AISStaticDataCache::removeOlderThan(base::Time const& time)
+{
+    size_t count = 0;
+    while (!m_entries.empty()) {
+        Entry const& entry = m_entries.back();
+        if (max(entry.part_a_time, entry.part_b_time) >= time) {
+            break;
+        }
+        removeLast();
+        count++;
+    }
+    m_expired_count += count;
+    return count;
+}
+
+void AISStaticDataCache::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+}
+
+size_t AISStaticDataCache::size() const
+{
+    return m_entries.size();
+}
+
+uint64_t AISStaticDataCache::getEvictedCount() const
+{
+    return m_evicted_count;
+}
+
+uint64_t AISStaticDataCache::getExpiredCount() const
+{
+    return m_expired_count;
+}
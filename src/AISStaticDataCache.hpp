@@ -0,0 +1,96 @@
+#ifndef NMEA0183_AIS_STATIC_DATA_CACHE_HPP
+#define NMEA0183_AIS_STATIC_DATA_CACHE_HPP
+
+#include <ais_base/VesselInformation.hpp>
+#include <base/Time.hpp>
+#include <list>
+#include <marnav/ais/message_24.hpp>
+#include <unordered_map>
+
+namespace nmea0183 {
+    /**
+     * Join of the two parts of class B static data reports (AIS type 24)
+     *
+     * Class B transponders send their static data in two separate
+     * messages: part A with the name, and part B with the ship type, call
+     * sign and dimensions. The cache keeps the last part of each kind
+     * received for each MMSI, and produces a complete VesselInformation
+     * every time a part arrives while the other one is known.
+     *
+     * A part is only joined with one that is not older than the maximum
+     * age. Entries that have not been updated for longer are removed.
+     * When the cache is full, the least recently updated entry is evicted.
+     */
+    class AISStaticDataCache {
+    public:
+        static const size_t DEFAULT_MAX_SIZE = 4096;
+
+    private:
+        struct Entry {
+            int mmsi;
+            base::Time part_a_time;
+            base::Time part_b_time;
+            ais_base::VesselInformation info;
+        };
+
+        /** The entries, most recently updated first */
+        std::list<Entry> m_entries;
+        std::unordered_map<int, std::list<Entry>::iterator> m_index;
+
+        size_t m_max_size;
+        base::Time m_max_age;
+        uint64_t m_evicted_count = 0;
+        uint64_t m_expired_count = 0;
+
+        void removeLast();
+        void shrinkTo(size_t size);
+
+    public:
+        /** @param max_age the default is two class B static data reporting
+         *    periods (6 minutes each), so that the loss of one part does not
+         *    break the join
+         */
+        explicit AISStaticDataCache(size_t max_size = DEFAULT_MAX_SIZE,
+            base::Time const& max_age = base::Time::fromSeconds(720));
+
+        /** Change the maximum number of entries, evicting the oldest ones if
+         * needed
+         *
+         * @throw std::invalid_argument if max_size is zero
+         */
+        void setMaxSize(size_t max_size);
+
+        /** Change the maximum age of a part for it to be joined */
+        void setMaxAge(base::Time const& max_age);
+
+        /** Add a part of a static data report
+         *
+         * @param time the reception time of the message. It is expected to
+         *   increase monotonically
+         * @param info set to the merged vessel information if the other
+         *   part of the report is known
+         * @return true if info has been set
+         */
+        bool process(marnav::ais::message_24 const& message,
+            base::Time const& time,
+            ais_base::VesselInformation& info);
+
+        /** Remove the entries that have not been updated since the given time
+         *
+         * @return the number of removed entries
+         */
+        size_t removeOlderThan(base::Time const& time);
+
+        void clear();
+
+        size_t size() const;
+
+        /** Count of entries removed because the cache was full */
+        uint64_t getEvictedCount() const;
+
+        /** Count of entries removed because they were too old */
+        uint64_t getExpiredCount() const;
+    };
+}
+
+#endif
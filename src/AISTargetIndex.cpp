@@ -0,0 +1,238 @@
+#include <nmea0183/AISTargetIndex.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+using namespace nmea0183;
+
+static const double EARTH_RADIUS = 6371000;
+
+AISTargetIndex::AISTargetIndex(base::Angle const& cell_size)
+    : m_cell_size(cell_size.getRad())
+{
+    if (!(m_cell_size > 0)) {
+        throw invalid_argument("AISTargetIndex: cell size must be strictly positive");
+    }
+    m_rows = ceil(M_PI / m_cell_size);
+    m_columns = ceil(2 * M_PI / m_cell_size);
+}
+
+int64_t AISTargetIndex::getRow(double latitude) const
+{
+    int64_t row = floor((latitude + M_PI / 2) / m_cell_size);
+    return min(max<int64_t>(row, 0), m_rows - 1);
+}
+
+int64_t AISTargetIndex::getColumn(double longitude) const
+{
+    int64_t column = floor((longitude + M_PI) / m_cell_size);
+    column %= m_columns;
+    return column < 0 ? column + m_columns : column;
+}
+
+void AISTargetIndex::addToCell(uint32_t target_index)
+{
+    Target& target = m_targets[target_index];
+    target.cell = getRow(target.position.latitude.getRad()) * m_columns +
+                  getColumn(target.position.longitude.getRad());
+    auto& cell = m_cells[target.cell];
+    target.cell_slot = cell.size();
+    cell.push_back(target_index);
+}
+
+void AISTargetIndex::removeFromCell(uint32_t target_index)
+{
+    Target const& target = m_targets[target_index];
+    auto& cell = m_cells[target.cell];
+    uint32_t moved = cell.back();
+    cell[target.cell_slot] = moved;
+    m_targets[moved].cell_slot = target.cell_slot;
+    cell.pop_back();
+}
+
+void AISTargetIndex::removeTarget(uint32_t target_index)
+{
+    removeFromCell(target_index);
+
+    // The last target is moved in the freed slot, update its cell
+    if (m_targets.removeAt(target_index)) {
+        Target const& moved = m_targets[target_index];
+        m_cells[moved.cell][moved.cell_slot] = target_index;
+    }
+}
+
+bool AISTargetIndex::update(ais_base::Position const& position)
+{
+    if (std::isnan(position.latitude.getRad()) ||
+        std::isnan(position.longitude.getRad())) {
+        return false;
+    }
+
+    uint32_t index = m_targets.find(position.mmsi);
+    if (index == MMSIMap<Target>::NOT_FOUND) {
+        addToCell(m_targets.insert(position.mmsi, Target{position, 0, 0}));
+        return true;
+    }
+
+    Target& target = m_targets[index];
+    int64_t cell = getRow(position.latitude.getRad()) * m_columns +
+                   getColumn(position.longitude.getRad());
+    if (cell == target.cell) {
+        target.position = position;
+        return true;
+    }
+
+    removeFromCell(index);
+    target.position = position;
+    addToCell(index);
+    return true;
+}
+
+bool AISTargetIndex::remove(int mmsi)
+{
+    uint32_t index = m_targets.find(mmsi);
+    if (index == MMSIMap<Target>::NOT_FOUND) {
+        return false;
+    }
+    removeTarget(index);
+    return true;
+}
+
+size_t AISTargetIndex::removeOlderThan(base::Time const& time)
+{
+    return m_targets.removeIf(
+        [&time](Target const& target) { return target.position.time < time; },
+        [this](uint32_t index) { removeTarget(index); });
+}
+
+ais_base::Position const* AISTargetIndex::get(int mmsi) const
+{
+    Target const* target = m_targets.get(mmsi);
+    return target ? &target->position : nullptr;
+}
+
+size_t AISTargetIndex::size() const
+{
+    return m_targets.size();
+}
+
+template <typename Filter>
+void AISTargetIndex::queryCells(double min_latitude,
+    double max_latitude,
+    double min_longitude,
+    double max_longitude,
+    Filter filter,
+    vector<ais_base::Position>& result) const
+{
+    int64_t first_row = getRow(min_latitude);
+    int64_t last_row = getRow(max_latitude);
+
+    // Number of columns to visit, starting at the first one and wrapping
+    // around the antimeridian
+    int64_t first_column = getColumn(min_longitude);
+    int64_t column_count = m_columns;
+    if (max_longitude - min_longitude < 2 * M_PI) {
+        column_count = getColumn(max_longitude) - first_column;
+        if (column_count < 0) {
+            column_count += m_columns;
+        }
+        column_count++;
+    }
+    else {
+        first_column = 0;
+    }
+
+    for (int64_t row = first_row; row <= last_row; ++row) {
+        for (int64_t i = 0; i < column_count; ++i) {
+            int64_t column = (first_column + i) % m_columns;
+            auto it = m_cells.find(row * m_columns + column);
+            if (it == m_cells.end()) {
+                continue;
+            }
+            for (uint32_t target_index : it->second) {
+                auto const& position = m_targets[target_index].position;
+                if (filter(position)) {
+                    result.push_back(position);
+                }
+            }
+        }
+    }
+}
+
+size_t AISTargetIndex::queryRadius(base::Angle const& latitude,
+    base::Angle const& longitude,
+    double radius,
+    vector<ais_base::Position>& result) const
+{
+    size_t initial_size = result.size();
+    double lat = latitude.getRad();
+    double lon = longitude.getRad();
+    double angular_radius = radius / EARTH_RADIUS;
+
+    // Bounding box of the spherical cap. It spans all longitudes if the
+    // cap contains a pole
+    double min_latitude = lat - angular_radius;
+    double max_latitude = lat + angular_radius;
+    double min_longitude = -M_PI;
+    double max_longitude = M_PI;
+    if (min_latitude > -M_PI / 2 && max_latitude < M_PI / 2) {
+        double half_width = asin(min(1.0, sin(angular_radius) / cos(lat)));
+        min_longitude = lon - half_width;
+        max_longitude = lon + half_width;
+    }
+
+    queryCells(min_latitude,
+        max_latitude,
+        min_longitude,
+        max_longitude,
+        [&](ais_base::Position const& position) {
+            return distance(latitude, longitude, position.latitude, position.longitude) <=
+                   radius;
+        },
+        result);
+    return result.size() - initial_size;
+}
+
+size_t AISTargetIndex::queryBox(base::Angle const& min_latitude,
+    base::Angle const& min_longitude,
+    base::Angle const& max_latitude,
+    base::Angle const& max_longitude,
+    vector<ais_base::Position>& result) const
+{
+    size_t initial_size = result.size();
+    double min_lat = min_latitude.getRad();
+    double max_lat = max_latitude.getRad();
+    double min_lon = min_longitude.getRad();
+    double max_lon = max_longitude.getRad();
+    bool wraps = min_lon > max_lon;
+
+    queryCells(min_lat,
+        max_lat,
+        min_lon,
+        wraps ? max_lon + 2 * M_PI : max_lon,
+        [&](ais_base::Position const& position) {
+            double lat = position.latitude.getRad();
+            double lon = position.longitude.getRad();
+            if (lat < min_lat || lat > max_lat) {
+                return false;
+            }
+            return wraps ? (lon >= min_lon || lon <= max_lon)
+                         : (lon >= min_lon && lon <= max_lon);
+        },
+        result);
+    return result.size() - initial_size;
+}
+
+double AISTargetIndex::distance(base::Angle const& latitude0,
+    base::Angle const& longitude0,
+    base::Angle const& latitude1,
+    base::Angle const& longitude1)
+{
+    double lat0 = latitude0.getRad();
+    double lat1 = latitude1.getRad();
+    double sin_dlat = sin((lat1 - lat0) / 2);
+    double sin_dlon = sin((longitude1.getRad() - longitude0.getRad()) / 2);
+    double a = sin_dlat * sin_dlat + cos(lat0) * cos(lat1) * sin_dlon * sin_dlon;
+    return 2 * EARTH_RADIUS * asin(min(1.0, sqrt(a)));
+}
@@ -0,0 +1,126 @@
+#ifndef NMEA0183_AIS_TARGET_INDEX_HPP
+#define NMEA0183_AIS_TARGET_INDEX_HPP
+
+#include <ais_base/Position.hpp>
+#include <base/Angle.hpp>
+#include <cstdint>
+#include <nmea0183/MMSIMap.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace nmea0183 {
+    /**
+     * Spatial index of the last known position of AIS targets
+     *
+     * Targets are stored in a uniform latitude/longitude grid. Cells should
+     * be about the size of the typical query radius: a query then only
+     * looks at a handful of cells, and its cost is proportional to the
+     * number of targets it returns rather than to the fleet size.
+     *
+     * It is fed with the positions from AIS::getPosition:
+     *
+     * ~~~ cpp
+     * AISTargetIndex index;
+     * index.update(AIS::getPosition(message));
+     * std::vector<ais_base::Position> nearby;
+     * index.queryRadius(own_latitude, own_longitude, 5 * 1852, nearby);
+     * ~~~
+     */
+    class AISTargetIndex {
+        struct Target {
+            ais_base::Position position;
+            int64_t cell;
+            /** Index of this target in its cell */
+            uint32_t cell_slot;
+        };
+
+        double m_cell_size;
+        int64_t m_rows;
+        int64_t m_columns;
+
+        MMSIMap<Target> m_targets;
+        std::unordered_map<int64_t, std::vector<uint32_t>> m_cells;
+
+        int64_t getRow(double latitude) const;
+        int64_t getColumn(double longitude) const;
+        void addToCell(uint32_t target_index);
+        void removeFromCell(uint32_t target_index);
+        void removeTarget(uint32_t target_index);
+
+        template <typename Filter>
+        void queryCells(double min_latitude, double max_latitude,
+            double min_longitude, double max_longitude,
+            Filter filter, std::vector<ais_base::Position>& result) const;
+
+    public:
+        /** @param cell_size the grid's cell size, in both latitude and
+         *    longitude
+         * @throw std::invalid_argument if the cell size is not strictly
+         *   positive
+         */
+        explicit AISTargetIndex(base::Angle const& cell_size = base::Angle::fromDeg(0.1));
+
+        /** Add a target, or update its position
+         *
+         * @return false if the position has no latitude or longitude, in
+         *   which case the index is not changed
+         */
+        bool update(ais_base::Position const& position);
+
+        /** Remove a target
+         *
+         * @return false if the target is not in the index
+         */
+        bool remove(int mmsi);
+
+        /** Remove the targets whose last position is older than the given
+         * time
+         *
+         * This walks all targets
+         *
+         * @return the number of targets removed
+         */
+        size_t removeOlderThan(base::Time const& time);
+
+        /** The last position of the given target, or null if it is not in
+         * the index
+         *
+         * The pointer is invalidated by any change to the index
+         */
+        ais_base::Position const* get(int mmsi) const;
+
+        /** Number of targets in the index */
+        size_t size() const;
+
+        /** Append the targets within a given distance of a point
+         *
+         * @param radius the distance, in meters, along a great circle
+         * @return the number of targets appended
+         */
+        size_t queryRadius(base::Angle const& latitude,
+            base::Angle const& longitude,
+            double radius,
+            std::vector<ais_base::Position>& result) const;
+
+        /** Append the targets within a latitude/longitude box
+         *
+         * The box crosses the antimeridian if min_longitude is greater than
+         * max_longitude
+         *
+         * @return the number of targets appended
+         */
+        size_t queryBox(base::Angle const& min_latitude,
+            base::Angle const& min_longitude,
+            base::Angle const& max_latitude,
+            base::Angle const& max_longitude,
+            std::vector<ais_base::Position>& result) const;
+
+        /** Great-circle distance between two points, in meters */
+        static double distance(base::Angle const& latitude0,
+            base::Angle const& longitude0,
+            base::Angle const& latitude1,
+            base::Angle const& longitude1);
+    };
+}
+
+#endif
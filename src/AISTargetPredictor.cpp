@@ -0,0 +1,155 @@
+#include <nmea0183/AISTargetPredictor.hpp>
+
+#include <cmath>
+#include <nmea0183/AIS.hpp>
+
+using namespace std;
+using namespace nmea0183;
+
+static const double EARTH_RADIUS = 6371000;
+
+/** Below this rate of turn (rad/s), the straight-line model is used */
+static const double MIN_RATE_OF_TURN = 1e-6;
+
+static double normalizeAngle(double angle)
+{
+    return angle - 2 * M_PI * floor((angle + M_PI) / (2 * M_PI));
+}
+
+AISTargetPredictor::AISTargetPredictor(base::Time const& max_turn_duration)
+    : m_max_turn_duration(max_turn_duration)
+{
+}
+
+bool AISTargetPredictor::update(ais_base::Position const& position, double rate_of_turn)
+{
+    double latitude = position.latitude.getRad();
+    if (std::isnan(latitude) || std::isnan(position.longitude.getRad())) {
+        return false;
+    }
+
+    Target target;
+    target.position = position;
+    double course = position.course_over_ground.getRad();
+    target.speed = position.speed_over_ground;
+    if (std::isnan(target.speed) || std::isnan(course)) {
+        target.speed = 0;
+        course = 0;
+    }
+    target.cos_course = cos(course);
+    target.sin_course = sin(course);
+    target.rate_of_turn = std::isnan(rate_of_turn) ? 0 : rate_of_turn;
+    target.latitude_scale = 1 / EARTH_RADIUS;
+    target.longitude_scale = -1 / (EARTH_RADIUS * cos(latitude));
+
+    if (Target* existing = m_targets.get(position.mmsi)) {
+        *existing = target;
+    }
+    else {
+        m_targets.insert(position.mmsi, target);
+    }
+    return true;
+}
+
+bool AISTargetPredictor::update(marnav::ais::message_01 const& message)
+{
+    return update(AIS::getPosition(message), AIS::getRateOfTurn(message));
+}
+
+bool AISTargetPredictor::remove(int mmsi)
+{
+    uint32_t index = m_targets.find(mmsi);
+    if (index == MMSIMap<Target>::NOT_FOUND) {
+        return false;
+    }
+    m_targets.removeAt(index);
+    return true;
+}
+
+size_t AISTargetPredictor::removeOlderThan(base::Time const& time)
+{
+    return m_targets.removeIf(
+        [&time](Target const& target) { return target.position.time < time; });
+}
+
+size_t AISTargetPredictor::size() const
+{
+    return m_targets.size();
+}
+
+void AISTargetPredictor::predict(Target const& target,
+    base::Time const& time,
+    ais_base::Position& result) const
+{
+    result = target.position;
+    result.time = time;
+    double dt = (time - target.position.time).toSeconds();
+    if (target.speed == 0) {
+        return;
+    }
+
+    double north = 0;
+    double west = 0;
+    double turn_duration = dt;
+    if (target.rate_of_turn != 0) {
+        double max_turn_duration = m_max_turn_duration.toSeconds();
+        turn_duration = max(-max_turn_duration, min(dt, max_turn_duration));
+    }
+
+    double turn = target.rate_of_turn * turn_duration;
+    double cos_course = target.cos_course;
+    double sin_course = target.sin_course;
+    if (fabs(target.rate_of_turn) > MIN_RATE_OF_TURN) {
+        // Arc of circle at constant speed and rate of turn
+        double radius = target.speed / target.rate_of_turn;
+        double cos_end = cos(turn) * cos_course - sin(turn) * sin_course;
+        double sin_end = sin(turn) * cos_course + cos(turn) * sin_course;
+        north = radius * (sin_end - sin_course);
+        west = radius * (cos_course - cos_end);
+        cos_course = cos_end;
+        sin_course = sin_end;
+    }
+    else {
+        turn_duration = 0;
+        turn = 0;
+    }
+
+    // Straight line for the rest of the time
+    double straight = target.speed * (dt - turn_duration);
+    north += straight * cos_course;
+    west += straight * sin_course;
+
+    result.latitude = base::Angle::fromRad(
+        target.position.latitude.getRad() + north * target.latitude_scale);
+    result.longitude = base::Angle::fromRad(normalizeAngle(
+        target.position.longitude.getRad() + west * target.longitude_scale));
+    if (turn != 0) {
+        result.course_over_ground = base::Angle::fromRad(
+            normalizeAngle(target.position.course_over_ground.getRad() + turn));
+        if (!std::isnan(target.position.yaw.getRad())) {
+            result.yaw = base::Angle::fromRad(
+                normalizeAngle(target.position.yaw.getRad() + turn));
+        }
+    }
+}
+
+void AISTargetPredictor::predict(base::Time const& time,
+    vector<ais_base::Position>& positions) const
+{
+    positions.resize(m_targets.size());
+    for (size_t i = 0; i < m_targets.size(); ++i) {
+        predict(m_targets[i], time, positions[i]);
+    }
+}
+
+bool AISTargetPredictor::predict(int mmsi,
+    base::Time const& time,
+    ais_base::Position& position) const
+{
+    Target const* target = m_targets.get(mmsi);
+    if (!target) {
+        return false;
+    }
+    predict(*target, time, position);
+    return true;
+}
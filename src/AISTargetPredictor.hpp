@@ -0,0 +1,104 @@
+#ifndef NMEA0183_AIS_TARGET_PREDICTOR_HPP
+#define NMEA0183_AIS_TARGET_PREDICTOR_HPP
+
+#include <ais_base/Position.hpp>
+#include <base/Time.hpp>
+#include <marnav/ais/message_01.hpp>
+#include <nmea0183/MMSIMap.hpp>
+#include <vector>
+
+namespace nmea0183 {
+    /**
+     * Dead-reckoning of AIS targets between their position reports
+     *
+     * The motion state of each target (speed, course, rate of turn) is
+     * computed once per report. Predictions then follow a constant speed and
+     * turn rate model, with the turn limited to a maximum duration after
+     * which the target is assumed to go straight.
+     *
+     * ~~~ cpp
+     * AISTargetPredictor predictor;
+     * predictor.update(AIS::getPosition(message), AIS::getRateOfTurn(message));
+     * ...
+     * std::vector<ais_base::Position> predicted;
+     * predictor.predict(base::Time::now(), predicted);
+     * ~~~
+     */
+    class AISTargetPredictor {
+        struct Target {
+            ais_base::Position position;
+            double speed;
+            double cos_course;
+            double sin_course;
+            /** Rate of turn in rad/s, zero if unknown */
+            double rate_of_turn;
+            /** Conversion from meters north/west to latitude/longitude */
+            double latitude_scale;
+            double longitude_scale;
+        };
+
+        base::Time m_max_turn_duration;
+        MMSIMap<Target> m_targets;
+
+        void predict(Target const& target, base::Time const& time,
+            ais_base::Position& result) const;
+
+    public:
+        /** @param max_turn_duration how long after a report the target is
+         *   expected to keep turning at the reported rate
+         */
+        explicit AISTargetPredictor(
+            base::Time const& max_turn_duration = base::Time::fromSeconds(60));
+
+        /** Add a target, or replace its motion state with a new report
+         *
+         * Targets with an unknown speed or course over ground are assumed
+         * to be stationary
+         *
+         * @param rate_of_turn as returned by AIS::getRateOfTurn. Unknown is
+         *   treated as no turn
+         * @return false if the position has no latitude or longitude, in
+         *   which case the predictor is not changed
+         */
+        bool update(ais_base::Position const& position,
+            double rate_of_turn = base::unknown<double>());
+
+        /** Update a target from a class A position report */
+        bool update(marnav::ais::message_01 const& message);
+
+        /** Remove a target
+         *
+         * @return false if the target is not known
+         */
+        bool remove(int mmsi);
+
+        /** Remove the targets whose last report is older than the given
+         * time
+         *
+         * @return the number of targets removed
+         */
+        size_t removeOlderThan(base::Time const& time);
+
+        /** Number of targets */
+        size_t size() const;
+
+        /** Predict the position of all targets at the given time
+         *
+         * The predicted positions have their time, latitude, longitude,
+         * course over ground and yaw updated. The other fields are those of
+         * the last report
+         *
+         * @param positions resized to the number of targets
+         */
+        void predict(base::Time const& time,
+            std::vector<ais_base::Position>& positions) const;
+
+        /** Predict the position of one target at the given time
+         *
+         * @return false if the target is not known
+         */
+        bool predict(int mmsi, base::Time const& time, ais_base::Position& position) const;
+    };
+}
+
+#endif
@@ -0,0 +1,202 @@
+#include <nmea0183/AISTargetState.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+using namespace nmea0183;
+
+template <size_t N> static void copyString(char (&target)[N], string const& source)
+{
+    size_t size = min(source.size(), N - 1);
+    memcpy(target, source.data(), size);
+    memset(target + size, 0, N - size);
+}
+
+template <size_t N> static string toString(char const (&source)[N])
+{
+    return string(source, strnlen(source, N));
+}
+
+AISTargetRecord AISTargetState::makeRecord(int mmsi)
+{
+    AISTargetRecord record = {};
+    record.mmsi = mmsi;
+    record.latitude = base::unknown<double>();
+    record.longitude = base::unknown<double>();
+    record.course_over_ground = base::unknown<float>();
+    record.yaw = base::unknown<float>();
+    record.speed_over_ground = base::unknown<float>();
+    return record;
+}
+
+AISTargetRecord& AISTargetState::getOrCreate(int mmsi)
+{
+    if (AISTargetRecord* record = m_records.get(mmsi)) {
+        return *record;
+    }
+    return m_records[m_records.insert(mmsi, makeRecord(mmsi))];
+}
+
+void AISTargetState::update(ais_base::Position const& position)
+{
+    updateRecord(getOrCreate(position.mmsi), position);
+}
+
+void AISTargetState::update(ais_base::VesselInformation const& info)
+{
+    updateRecord(getOrCreate(info.mmsi), info);
+}
+
+void AISTargetState::updateRecord(AISTargetRecord& record,
+    ais_base::Position const& position)
+{
+    record.flags |= AISTargetRecord::HAS_POSITION;
+    record.flags &= ~(AISTargetRecord::HIGH_ACCURACY_POSITION | AISTargetRecord::RAIM);
+    if (position.high_accuracy_position) {
+        record.flags |= AISTargetRecord::HIGH_ACCURACY_POSITION;
+    }
+    if (position.raim) {
+        record.flags |= AISTargetRecord::RAIM;
+    }
+    record.position_time = position.time.toMicroseconds();
+    record.latitude = position.latitude.getRad();
+    record.longitude = position.longitude.getRad();
+    record.course_over_ground = position.course_over_ground.getRad();
+    record.yaw = position.yaw.getRad();
+    record.speed_over_ground = position.speed_over_ground;
+    record.radio_status = position.radio_status;
+    record.status = position.status;
+    record.maneuver_indicator = position.maneuver_indicator;
+    record.correction_status = position.correction_status;
+    if (position.imo) {
+        record.imo = position.imo;
+    }
+}
+
+void AISTargetState::updateRecord(AISTargetRecord& record,
+    ais_base::VesselInformation const& info)
+{
+    record.flags |= AISTargetRecord::HAS_VESSEL_INFORMATION;
+    record.vessel_information_time = info.time.toMicroseconds();
+    record.imo = info.imo;
+    record.length = info.length;
+    record.width = info.width;
+    record.draft = info.draft;
+    record.ship_type = info.ship_type;
+    record.epfd_fix = info.epfd_fix;
+    for (int i = 0; i < 3; ++i) {
+        record.reference_position[i] = info.reference_position[i];
+    }
+    copyString(record.name, info.name);
+    copyString(record.call_sign, info.call_sign);
+}
+
+void AISTargetState::set(AISTargetRecord const& record)
+{
+    getOrCreate(record.mmsi) = record;
+}
+
+bool AISTargetState::remove(int mmsi)
+{
+    uint32_t index = m_records.find(mmsi);
+    if (index == MMSIMap<AISTargetRecord>::NOT_FOUND) {
+        return false;
+    }
+    m_records.removeAt(index);
+    return true;
+}
+
+size_t AISTargetState::removeOlderThan(base::Time const& time)
+{
+    int64_t threshold = time.toMicroseconds();
+    return m_records.removeIf([threshold](AISTargetRecord const& record) {
+        return max(record.position_time, record.vessel_information_time) < threshold;
+    });
+}
+
+void AISTargetState::clear()
+{
+    m_records.clear();
+}
+
+size_t AISTargetState::size() const
+{
+    return m_records.size();
+}
+
+AISTargetRecord const* AISTargetState::get(int mmsi) const
+{
+    return m_records.get(mmsi);
+}
+
+vector<AISTargetRecord> const& AISTargetState::getRecords() const
+{
+    return m_records.values();
+}
+
+bool AISTargetState::getPosition(int mmsi, ais_base::Position& position) const
+{
+    auto record = get(mmsi);
+    if (!record || !(record->flags & AISTargetRecord::HAS_POSITION)) {
+        return false;
+    }
+    position = toPosition(*record);
+    return true;
+}
+
+bool AISTargetState::getVesselInformation(int mmsi,
+    ais_base::VesselInformation& info) const
+{
+    auto record = get(mmsi);
+    if (!record || !(record->flags & AISTargetRecord::HAS_VESSEL_INFORMATION)) {
+        return false;
+    }
+    info = toVesselInformation(*record);
+    return true;
+}
+
+ais_base::Position AISTargetState::toPosition(AISTargetRecord const& record)
+{
+    ais_base::Position position;
+    position.time = base::Time::fromMicroseconds(record.position_time);
+    position.mmsi = record.mmsi;
+    position.imo = record.imo;
+    position.latitude = base::Angle::fromRad(record.latitude);
+    position.longitude = base::Angle::fromRad(record.longitude);
+    position.course_over_ground = base::Angle::fromRad(record.course_over_ground);
+    position.yaw = base::Angle::fromRad(record.yaw);
+    position.speed_over_ground = record.speed_over_ground;
+    position.radio_status = record.radio_status;
+    position.high_accuracy_position =
+        record.flags & AISTargetRecord::HIGH_ACCURACY_POSITION;
+    position.raim = record.flags & AISTargetRecord::RAIM;
+    position.status = static_cast<ais_base::NavigationalStatus>(record.status);
+    position.maneuver_indicator =
+        static_cast<ais_base::ManeuverIndicator>(record.maneuver_indicator);
+    position.correction_status =
+        static_cast<ais_base::PositionCorrectionStatus>(record.correction_status);
+    position.ensureEnumsValid();
+    return position;
+}
+
+ais_base::VesselInformation AISTargetState::toVesselInformation(
+    AISTargetRecord const& record)
+{
+    ais_base::VesselInformation info;
+    info.time = base::Time::fromMicroseconds(record.vessel_information_time);
+    info.mmsi = record.mmsi;
+    info.imo = record.imo;
+    info.name = toString(record.name);
+    info.call_sign = toString(record.call_sign);
+    info.length = record.length;
+    info.width = record.width;
+    info.draft = record.draft;
+    info.ship_type = static_cast<ais_base::ShipType>(record.ship_type);
+    info.epfd_fix = static_cast<ais_base::EPFDFixType>(record.epfd_fix);
+    info.reference_position = base::Vector3d(record.reference_position[0],
+        record.reference_position[1],
+        record.reference_position[2]);
+    info.ensureEnumsValid();
+    return info;
+}
@@ -0,0 +1,135 @@
+#ifndef NMEA0183_AIS_TARGET_STATE_HPP
+#define NMEA0183_AIS_TARGET_STATE_HPP
+
+#include <ais_base/Position.hpp>
+#include <ais_base/VesselInformation.hpp>
+#include <cstdint>
+#include <nmea0183/MMSIMap.hpp>
+#include <type_traits>
+#include <vector>
+
+namespace nmea0183 {
+    /**
+     * Last known state of an AIS target, as a fixed-layout plain record
+     *
+     * The layout does not depend on the compiler or on the ais_base types,
+     * so that records can be written to files and shared memory as-is.
+     * Angles and speeds follow Rock's conventions (radians, m/s), and are
+     * NaN when unknown.
+     */
+    struct AISTargetRecord {
+        enum Flags : uint32_t {
+            HAS_POSITION = 1,
+            HAS_VESSEL_INFORMATION = 2,
+            HIGH_ACCURACY_POSITION = 4,
+            RAIM = 8
+        };
+
+        int32_t mmsi;
+        uint32_t flags;
+        /** Times of the last position and vessel information, in
+         * microseconds since the epoch
+         */
+        int64_t position_time;
+        int64_t vessel_information_time;
+
+        double latitude;
+        double longitude;
+        float course_over_ground;
+        float yaw;
+        float speed_over_ground;
+        uint32_t radio_status;
+        uint8_t status;
+        uint8_t maneuver_indicator;
+        uint8_t correction_status;
+        uint8_t ship_type;
+        uint8_t epfd_fix;
+        uint8_t reserved0[3];
+
+        int32_t imo;
+        float length;
+        float width;
+        float draft;
+        float reference_position[3];
+        /** Zero-terminated. AIS names are 20 characters at most */
+        char name[21];
+        /** Zero-terminated. AIS call signs are 7 characters at most */
+        char call_sign[8];
+        uint8_t reserved1[7];
+    };
+    static_assert(sizeof(AISTargetRecord) == 128, "AISTargetRecord layout changed");
+    static_assert(std::is_trivially_copyable<AISTargetRecord>::value,
+        "AISTargetRecord must be trivially copyable");
+
+    /**
+     * Last known position and static data of all AIS targets
+     *
+     * Static data (from AIS::getVesselInformation) only comes every few
+     * minutes. Keeping it along with the positions allows to e.g. correct
+     * positions with the vessel's reference position as soon as it is
+     * known, and to save everything in a snapshot (see AISSnapshot).
+     */
+    class AISTargetState {
+        MMSIMap<AISTargetRecord> m_records;
+
+        AISTargetRecord& getOrCreate(int mmsi);
+
+    public:
+        /** Set the last position of a target, creating it if needed */
+        void update(ais_base::Position const& position);
+
+        /** Set the static data of a target, creating it if needed */
+        void update(ais_base::VesselInformation const& info);
+
+        /** Add a target from its record, replacing the existing one if there
+         * is one
+         */
+        void set(AISTargetRecord const& record);
+
+        /** Remove a target
+         *
+         * @return false if there is no such target
+         */
+        bool remove(int mmsi);
+
+        /** Remove the targets whose last update is older than the given time
+         *
+         * @return the number of removed targets
+         */
+        size_t removeOlderThan(base::Time const& time);
+
+        void clear();
+
+        size_t size() const;
+
+        /** The record of a target, or null if there is none */
+        AISTargetRecord const* get(int mmsi) const;
+
+        /** All the records, in no particular order */
+        std::vector<AISTargetRecord> const& getRecords() const;
+
+        /** Get the last position of a target
+         *
+         * @return false if the target has no known position
+         */
+        bool getPosition(int mmsi, ais_base::Position& position) const;
+
+        /** Get the static data of a target
+         *
+         * @return false if the target has no known static data
+         */
+        bool getVesselInformation(int mmsi, ais_base::VesselInformation& info) const;
+
+        /** An empty record, i.e. with neither position nor static data */
+        static AISTargetRecord makeRecord(int mmsi);
+        static void updateRecord(AISTargetRecord& record,
+            ais_base::Position const& position);
+        static void updateRecord(AISTargetRecord& record,
+            ais_base::VesselInformation const& info);
+        static ais_base::Position toPosition(AISTargetRecord const& record);
+        static ais_base::VesselInformation toVesselInformation(
+            AISTargetRecord const& record);
+    };
+}
+
+#endif
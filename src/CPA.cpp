@@ -0,0 +1,149 @@
+#include <nmea0183/CPA.hpp>
+
+#include <Eigen/Core>
+#include <cmath>
+
+using namespace std;
+using namespace nmea0183;
+
+static const double EARTH_RADIUS = 6371000;
+
+typedef Eigen::Map<Eigen::ArrayXd const> ConstArrayMap;
+typedef Eigen::Map<Eigen::ArrayXd> ArrayMap;
+
+void CPATargets::clear()
+{
+    mmsi.clear();
+    latitude.clear();
+    longitude.clear();
+    velocity_north.clear();
+    velocity_west.clear();
+    time.clear();
+}
+
+void CPATargets::reserve(size_t size)
+{
+    mmsi.reserve(size);
+    latitude.reserve(size);
+    longitude.reserve(size);
+    velocity_north.reserve(size);
+    velocity_west.reserve(size);
+    time.reserve(size);
+}
+
+size_t CPATargets::size() const
+{
+    return mmsi.size();
+}
+
+static void getVelocity(ais_base::Position const& position, double& north, double& west)
+{
+    double speed = position.speed_over_ground;
+    double course = position.course_over_ground.getRad();
+    if (std::isnan(speed) || std::isnan(course)) {
+        north = 0;
+        west = 0;
+        return;
+    }
+    // Rock angles are counter-clockwise from north
+    north = speed * cos(course);
+    west = speed * sin(course);
+}
+
+bool CPATargets::add(ais_base::Position const& position)
+{
+    if (std::isnan(position.latitude.getRad()) ||
+        std::isnan(position.longitude.getRad())) {
+        return false;
+    }
+
+    double north, west;
+    getVelocity(position, north, west);
+    mmsi.push_back(position.mmsi);
+    latitude.push_back(position.latitude.getRad());
+    longitude.push_back(position.longitude.getRad());
+    velocity_north.push_back(north);
+    velocity_west.push_back(west);
+    time.push_back(position.time.toSeconds());
+    return true;
+}
+
+void CPA::compute(ais_base::Position const& own,
+    CPATargets const& targets,
+    base::Time const& time,
+    CPAResults& results)
+{
+    size_t size = targets.size();
+    results.distance.resize(size);
+    results.time.resize(size);
+    if (size == 0) {
+        return;
+    }
+
+    double own_north_velocity, own_west_velocity;
+    getVelocity(own, own_north_velocity, own_west_velocity);
+    double t = time.toSeconds();
+    double own_dt = t - own.time.toSeconds();
+    double own_latitude = own.latitude.getRad();
+    double own_longitude = own.longitude.getRad();
+    double own_north = own_north_velocity * own_dt;
+    double own_west = own_west_velocity * own_dt;
+    double north_scale = EARTH_RADIUS;
+    double west_scale = -EARTH_RADIUS * cos(own_latitude);
+
+    ConstArrayMap latitude(targets.latitude.data(), size);
+    ConstArrayMap longitude(targets.longitude.data(), size);
+    ConstArrayMap velocity_north(targets.velocity_north.data(), size);
+    ConstArrayMap velocity_west(targets.velocity_west.data(), size);
+    ConstArrayMap target_time(targets.time.data(), size);
+
+    Eigen::ArrayXd delta_longitude = longitude - own_longitude;
+    delta_longitude = (delta_longitude > M_PI)
+                          .select(delta_longitude - 2 * M_PI,
+                              (delta_longitude < -M_PI)
+                                  .select(delta_longitude + 2 * M_PI, delta_longitude));
+
+    // Relative position at the requested time, and relative velocity
+    Eigen::ArrayXd dt = t - target_time;
+    Eigen::ArrayXd north =
+        (latitude - own_latitude) * north_scale + velocity_north * dt - own_north;
+    Eigen::ArrayXd west = delta_longitude * west_scale + velocity_west * dt - own_west;
+    Eigen::ArrayXd relative_north = velocity_north - own_north_velocity;
+    Eigen::ArrayXd relative_west = velocity_west - own_west_velocity;
+
+    Eigen::ArrayXd speed2 = relative_north.square() + relative_west.square();
+    ArrayMap tcpa(results.time.data(), size);
+    tcpa = (speed2 > 1e-12)
+               .select(-(north * relative_north + west * relative_west) /
+                           speed2.max(1e-12),
+                   0.0)
+               .max(0.0);
+
+    ArrayMap cpa(results.distance.data(), size);
+    cpa = ((north + relative_north * tcpa).square() +
+           (west + relative_west * tcpa).square())
+              .sqrt();
+}
+
+size_t CPA::screen(CPAResults const& results,
+    double max_distance,
+    base::Time const& max_time,
+    vector<uint32_t>& indices)
+{
+    indices.clear();
+    size_t size = results.distance.size();
+    if (size == 0) {
+        return 0;
+    }
+
+    ConstArrayMap distance(results.distance.data(), size);
+    ConstArrayMap time(results.time.data(), size);
+    Eigen::Array<bool, Eigen::Dynamic, 1> selected =
+        (distance <= max_distance) && (time <= max_time.toSeconds());
+    for (size_t i = 0; i < size; ++i) {
+        if (selected[i]) {
+            indices.push_back(i);
+        }
+    }
+    return indices.size();
+}
@@ -0,0 +1,90 @@
+#ifndef NMEA0183_CPA_HPP
+#define NMEA0183_CPA_HPP
+
+#include <ais_base/Position.hpp>
+#include <base/Time.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace nmea0183 {
+    /**
+     * Structure-of-arrays view of the targets, for the CPA computations
+     *
+     * Angles are in radians, velocities in m/s in a North-West frame
+     */
+    struct CPATargets {
+        std::vector<int> mmsi;
+        std::vector<double> latitude;
+        std::vector<double> longitude;
+        std::vector<double> velocity_north;
+        std::vector<double> velocity_west;
+        /** Time of the position, in seconds */
+        std::vector<double> time;
+
+        void clear();
+        void reserve(size_t size);
+        size_t size() const;
+
+        /** Add a target
+         *
+         * Targets with an unknown speed or course over ground are assumed
+         * to be stationary
+         *
+         * @return false if the position has no latitude or longitude, in
+         *   which case it is not added
+         */
+        bool add(ais_base::Position const& position);
+    };
+
+    /** Result of CPA::compute, one entry per target */
+    struct CPAResults {
+        /** Distance at the closest point of approach, in meters */
+        std::vector<double> distance;
+        /** Time to the closest point of approach, in seconds. Zero if the
+         * target is moving away, in which case the distance is the current
+         * one
+         */
+        std::vector<double> time;
+    };
+
+    /**
+     * @brief Batch closest point of approach computations
+     *
+     * Positions are projected on a plane tangent to the Earth at own ship's
+     * position, and the targets are assumed to keep their course and speed.
+     * This is valid for the ranges at which collision avoidance matters.
+     *
+     * The computations are done on Eigen arrays, and are vectorized with
+     * the SIMD instructions the build enables.
+     */
+    namespace CPA {
+        /**
+         * @brief Compute the CPA and TCPA of all targets
+         *
+         * @param own own ship's position, course and speed
+         * @param targets the targets
+         * @param time the time at which the CPA is computed. Own ship and
+         *   targets are extrapolated from the time of their positions to it
+         * @param results resized to the number of targets
+         */
+        void compute(ais_base::Position const& own,
+            CPATargets const& targets,
+            base::Time const& time,
+            CPAResults& results);
+
+        /**
+         * @brief Select the targets whose CPA is within the given thresholds
+         *
+         * @param indices set to the indices, in the target arrays, of the
+         *   targets whose CPA is closer than max_distance and happens within
+         *   max_time
+         * @return the number of selected targets
+         */
+        size_t screen(CPAResults const& results,
+            double max_distance,
+            base::Time const& max_time,
+            std::vector<uint32_t>& indices);
+    }
+}
+
+#endif
@@ -0,0 +1,282 @@
+#include <nmea0183/Capture.hpp>
+
+#include <base/Time.hpp>
+#include <chrono>
+#include <cstring>
+#include <iodrivers_base/Exceptions.hpp>
+#include <stdexcept>
+#include <system_error>
+
+using namespace std;
+using namespace nmea0183;
+
+// File layout, all integers in host byte order
+//
+// Capture file:
+//   header: magic[8] version:u32 flags:u32 start_wall_time:i64 start_monotonic_time:u64
+//   records: time:u64 source:u16 type:u8 reserved:u8 size:u32 data[size]
+//
+// Index file:
+//   header: magic[8]
+//   entries: time:u64 offset:u64
+static const char CAPTURE_MAGIC[8] = {'N', 'M', 'E', 'A', 'C', 'A', 'P', '1'};
+static const char INDEX_MAGIC[8] = {'N', 'M', 'E', 'A', 'I', 'D', 'X', '1'};
+static const uint32_t CAPTURE_VERSION = 1;
+static const size_t HEADER_SIZE = 32;
+static const size_t RECORD_HEADER_SIZE = 16;
+static const size_t INDEX_HEADER_SIZE = 8;
+static const size_t INDEX_ENTRY_SIZE = 16;
+
+template <typename T> static void writeValue(ostream& stream, T value)
+{
+    stream.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template <typename T> static T readValue(uint8_t const* data)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+CaptureWriter::CaptureWriter(string const& path, uint64_t index_interval)
+    : m_file(path, ios::binary | ios::trunc)
+    , m_index(path + ".idx", ios::binary | ios::trunc)
+    , m_index_interval(index_interval)
+{
+    if (!m_file || !m_index) {
+        throw runtime_error("cannot open " + path + " for writing");
+    }
+
+    m_file.write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    writeValue<uint32_t>(m_file, CAPTURE_VERSION);
+    writeValue<uint32_t>(m_file, 0);
+    writeValue<int64_t>(m_file, base::Time::now().toMicroseconds());
+    writeValue<uint64_t>(m_file, now());
+    m_offset = HEADER_SIZE;
+
+    m_index.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+}
+
+void CaptureWriter::write(uint64_t time,
+    uint16_t source,
+    CaptureRecordType type,
+    uint8_t const* data,
+    size_t size)
+{
+    if (time < m_last_time) {
+        throw invalid_argument("capture record times must be monotonic");
+    }
+    m_last_time = time;
+
+    if (time >= m_next_index_time) {
+        writeValue<uint64_t>(m_index, time);
+        writeValue<uint64_t>(m_index, m_offset);
+        m_next_index_time = time + m_index_interval;
+    }
+
+    writeValue<uint64_t>(m_file, time);
+    writeValue<uint16_t>(m_file, source);
+    writeValue<uint8_t>(m_file, type);
+    writeValue<uint8_t>(m_file, 0);
+    writeValue<uint32_t>(m_file, size);
+    m_file.write(reinterpret_cast<char const*>(data), size);
+    m_offset += RECORD_HEADER_SIZE + size;
+    if (!m_file) {
+        throw runtime_error("failed to write capture record");
+    }
+}
+
+void CaptureWriter::write(uint16_t source,
+    CaptureRecordType type,
+    uint8_t const* data,
+    size_t size)
+{
+    write(now(), source, type, data, size);
+}
+
+void CaptureWriter::flush()
+{
+    m_file.flush();
+    m_index.flush();
+}
+
+uint64_t CaptureWriter::now()
+{
+    return chrono::duration_cast<chrono::nanoseconds>(
+        chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+CaptureListener::CaptureListener(CaptureWriter& writer, uint16_t source)
+    : m_writer(writer)
+    , m_source(source)
+{
+}
+
+void CaptureListener::writeData(uint8_t const*, size_t)
+{
+}
+
+void CaptureListener::readData(uint8_t const* data, size_t size)
+{
+    m_writer.write(m_source, CAPTURE_RAW_READ, data, size);
+}
+
+CaptureReader::CaptureReader(string const& path)
+    : m_file(path)
+    , m_data(m_file.data())
+    , m_size(m_file.size())
+{
+    if (m_size < HEADER_SIZE || memcmp(m_data, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC))) {
+        throw invalid_argument(path + " is not a NMEA capture file");
+    }
+    m_start_wall_time = readValue<int64_t>(m_data + 16);
+    m_start_monotonic_time = readValue<uint64_t>(m_data + 24);
+
+    // The index is optional, seek() falls back to a linear search without it
+    try {
+        m_index.reset(new MappedFile(path + ".idx"));
+        if (m_index->size() < INDEX_HEADER_SIZE ||
+            memcmp(m_index->data(), INDEX_MAGIC, sizeof(INDEX_MAGIC))) {
+            m_index.reset();
+        }
+    }
+    catch (system_error const&) {
+    }
+    rewind();
+}
+
+size_t CaptureReader::getIndexEntryCount() const
+{
+    if (!m_index) {
+        return 0;
+    }
+    return (m_index->size() - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE;
+}
+
+CaptureReader::IndexEntry CaptureReader::getIndexEntry(size_t i) const
+{
+    uint8_t const* entry = m_index->data() + INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE;
+    return IndexEntry{readValue<uint64_t>(entry), readValue<uint64_t>(entry + 8)};
+}
+
+bool CaptureReader::next(CaptureRecord& record)
+{
+    if (m_offset + RECORD_HEADER_SIZE > m_size) {
+        return false;
+    }
+
+    uint8_t const* header = m_data + m_offset;
+    uint32_t size = readValue<uint32_t>(header + 12);
+    if (m_offset + RECORD_HEADER_SIZE + size > m_size) {
+        // Truncated record, e.g. if the writer got interrupted
+        return false;
+    }
+
+    record.time = readValue<uint64_t>(header);
+    record.source = readValue<uint16_t>(header + 8);
+    record.type = static_cast<CaptureRecordType>(header[10]);
+    record.size = size;
+    record.data = header + RECORD_HEADER_SIZE;
+    m_offset += RECORD_HEADER_SIZE + size;
+    return true;
+}
+
+void CaptureReader::seek(uint64_t time)
+{
+    // Find the last index entry that is strictly before the requested time,
+    // and scan linearly from there
+    size_t low = 0;
+    size_t high = getIndexEntryCount();
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (getIndexEntry(middle).time < time) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+
+    m_offset = low ? getIndexEntry(low - 1).offset : HEADER_SIZE;
+    while (m_offset + RECORD_HEADER_SIZE <= m_size) {
+        if (readValue<uint64_t>(m_data + m_offset) >= time) {
+            return;
+        }
+        m_offset += RECORD_HEADER_SIZE + readValue<uint32_t>(m_data + m_offset + 12);
+    }
+}
+
+void CaptureReader::rewind()
+{
+    m_offset = HEADER_SIZE;
+}
+
+int64_t CaptureReader::getStartWallTime() const
+{
+    return m_start_wall_time;
+}
+
+uint64_t CaptureReader::getStartMonotonicTime() const
+{
+    return m_start_monotonic_time;
+}
+
+CaptureStream::CaptureStream(CaptureReader& reader, int source)
+    : m_reader(reader)
+    , m_source(source)
+{
+}
+
+bool CaptureStream::ensureData()
+{
+    while (m_record_offset >= m_record.size) {
+        if (!m_reader.next(m_record)) {
+            return false;
+        }
+        m_record_offset = 0;
+        if (m_source >= 0 && m_record.source != m_source) {
+            m_record.size = 0;
+        }
+    }
+    return true;
+}
+
+void CaptureStream::waitRead(base::Time const&)
+{
+    if (!ensureData()) {
+        throw iodrivers_base::TimeoutError(iodrivers_base::TimeoutError::NONE,
+            "reached the end of the capture");
+    }
+}
+
+void CaptureStream::waitWrite(base::Time const&)
+{
+}
+
+size_t CaptureStream::read(uint8_t* buffer, size_t buffer_size)
+{
+    if (!ensureData()) {
+        return 0;
+    }
+
+    size_t size = min<size_t>(buffer_size, m_record.size - m_record_offset);
+    memcpy(buffer, m_record.data + m_record_offset, size);
+    m_record_offset += size;
+    return size;
+}
+
+size_t CaptureStream::write(uint8_t const*, size_t)
+{
+    throw logic_error("cannot write to a capture");
+}
+
+void CaptureStream::clear()
+{
+}
+
+uint64_t CaptureStream::getCurrentTime() const
+{
+    return m_record.time;
+}
@@ -0,0 +1,195 @@
+#ifndef NMEA0183_CAPTURE_HPP
+#define NMEA0183_CAPTURE_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <iodrivers_base/IOListener.hpp>
+#include <iodrivers_base/IOStream.hpp>
+#include <memory>
+#include <nmea0183/MappedFile.hpp>
+#include <string>
+#include <vector>
+
+namespace nmea0183 {
+    /** What a capture record contains */
+    enum CaptureRecordType : uint8_t {
+        /** The bytes returned by one read on the device */
+        CAPTURE_RAW_READ = 0,
+        /** One full sentence, as extracted by Driver */
+        CAPTURE_SENTENCE = 1
+    };
+
+    /** One record in a capture file
+     *
+     * When read from a CaptureReader, data points directly into the mapped
+     * file and is valid as long as the reader exists
+     */
+    struct CaptureRecord {
+        /** Arrival time, from the monotonic clock, in nanoseconds */
+        uint64_t time = 0;
+        uint16_t source = 0;
+        CaptureRecordType type = CAPTURE_RAW_READ;
+        uint8_t const* data = nullptr;
+        uint32_t size = 0;
+    };
+
+    /**
+     * Append-only binary capture of NMEA data with arrival timestamps
+     *
+     * The capture is made of two files. The main file holds a header followed
+     * by the records. The index file (same path with a .idx suffix) holds one
+     * (time, offset) entry per index interval, which allows CaptureReader to
+     * seek in O(log n)
+     *
+     * Record times must be monotonic. They are usually taken from now(), i.e.
+     * CLOCK_MONOTONIC. The header stores the wall-clock time at which the
+     * capture started, along with the corresponding monotonic time.
+     */
+    class CaptureWriter {
+        std::ofstream m_file;
+        std::ofstream m_index;
+        uint64_t m_offset = 0;
+        uint64_t m_index_interval;
+        uint64_t m_last_time = 0;
+        uint64_t m_next_index_time = 0;
+
+    public:
+        /**
+         * @param path the path of the capture file. It is overwritten if it
+         *   already exists
+         * @param index_interval the minimum time between two index entries,
+         *   in nanoseconds
+         */
+        explicit CaptureWriter(std::string const& path,
+            uint64_t index_interval = 1000000000ULL);
+
+        /** Append a record
+         *
+         * @throw std::invalid_argument if time is before the time of the last
+         *   record
+         */
+        void write(uint64_t time,
+            uint16_t source,
+            CaptureRecordType type,
+            uint8_t const* data,
+            size_t size);
+
+        /** Append a record, timestamped with now() */
+        void write(uint16_t source,
+            CaptureRecordType type,
+            uint8_t const* data,
+            size_t size);
+
+        void flush();
+
+        /** The current monotonic time in nanoseconds */
+        static uint64_t now();
+    };
+
+    /**
+     * Listener that records the raw reads of an iodrivers_base driver
+     *
+     * Register it with Driver::addListener. The driver does not take
+     * ownership
+     */
+    class CaptureListener : public iodrivers_base::IOListener {
+        CaptureWriter& m_writer;
+        uint16_t m_source;
+
+    public:
+        CaptureListener(CaptureWriter& writer, uint16_t source);
+
+        void writeData(uint8_t const* data, size_t size) override;
+        void readData(uint8_t const* data, size_t size) override;
+    };
+
+    /**
+     * Memory-mapped reader for files written by CaptureWriter
+     */
+    class CaptureReader {
+        struct IndexEntry {
+            uint64_t time;
+            uint64_t offset;
+        };
+
+        MappedFile m_file;
+        std::unique_ptr<MappedFile> m_index;
+        uint8_t const* m_data = nullptr;
+        size_t m_size = 0;
+        uint64_t m_offset = 0;
+        int64_t m_start_wall_time = 0;
+        uint64_t m_start_monotonic_time = 0;
+
+        size_t getIndexEntryCount() const;
+        IndexEntry getIndexEntry(size_t i) const;
+
+    public:
+        explicit CaptureReader(std::string const& path);
+
+        /** Read the next record
+         *
+         * @return false if the end of the file is reached
+         */
+        bool next(CaptureRecord& record);
+
+        /** Position the reader on the first record whose time is not earlier
+         * than the given time
+         */
+        void seek(uint64_t time);
+
+        /** Go back to the first record */
+        void rewind();
+
+        /** Wall-clock time at which the capture started, in microseconds since
+         * the epoch
+         */
+        int64_t getStartWallTime() const;
+
+        /** Monotonic time at which the capture started, in nanoseconds */
+        uint64_t getStartMonotonicTime() const;
+    };
+
+    /**
+     * iodrivers_base stream that feeds the contents of a capture to a driver
+     *
+     * This allows to read captures back through Driver and AIS:
+     *
+     * ~~~ cpp
+     * CaptureReader reader("capture.nmea0183");
+     * Driver driver;
+     * driver.setMainStream(new CaptureStream(reader));
+     * auto sentence = driver.readSentence();
+     * ~~~
+     *
+     * Reads throw iodrivers_base::TimeoutError when the end of the capture
+     * is reached.
+     */
+    class CaptureStream : public iodrivers_base::IOStream {
+        CaptureReader& m_reader;
+        int m_source = -1;
+        CaptureRecord m_record;
+        uint32_t m_record_offset = 0;
+
+        bool ensureData();
+
+    public:
+        /**
+         * @param reader the capture reader. It must stay valid as long as
+         *   the stream exists
+         * @param source if non-negative, only replay the records from this
+         *   source
+         */
+        explicit CaptureStream(CaptureReader& reader, int source = -1);
+
+        void waitRead(base::Time const& timeout) override;
+        void waitWrite(base::Time const& timeout) override;
+        size_t read(uint8_t* buffer, size_t buffer_size) override;
+        size_t write(uint8_t const* buffer, size_t buffer_size) override;
+        void clear() override;
+
+        /** The arrival time of the record the last read data came from */
+        uint64_t getCurrentTime() const;
+    };
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include <nmea0183/Decimator.hpp>
+
+#include <nmea0183/Driver.hpp>
+#include <nmea0183/SentenceDispatcher.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace nmea0183;
+
+Decimator::Decimator()
+    : m_table(26 * 26 * 26, NO_RULE)
+{
+}
+
+Decimator::Rule& Decimator::setRule(string_view tag)
+{
+    int index = SentenceDispatcher::tagIndex(tag);
+    if (index < 0) {
+        throw invalid_argument("invalid sentence tag '" + string(tag) + "'");
+    }
+
+    uint16_t& entry = m_table[index];
+    if (entry == NO_RULE) {
+        m_rules.push_back(Rule());
+        entry = m_rules.size();
+    }
+    Rule& rule = m_rules[entry - 1];
+    rule = Rule();
+    rule.tag = tag;
+    return rule;
+}
+
+void Decimator::keepEveryNth(string_view tag, uint32_t n)
+{
+    if (n == 0) {
+        throw invalid_argument("decimation factor must be strictly positive");
+    }
+    setRule(tag).every_nth = n;
+}
+
+void Decimator::setMaxRate(string_view tag, double rate)
+{
+    if (!(rate > 0)) {
+        throw invalid_argument("decimation rate must be strictly positive");
+    }
+    setRule(tag).period = base::Time::fromSeconds(1 / rate);
+}
+
+void Decimator::remove(string_view tag)
+{
+    int index = SentenceDispatcher::tagIndex(tag);
+    if (index < 0 || m_table[index] == NO_RULE) {
+        return;
+    }
+
+    // Keep the slot to not invalidate the other entries, but make it a
+    // pass-through
+    m_rules[m_table[index] - 1] = Rule();
+    m_table[index] = NO_RULE;
+}
+
+Decimator::Rule* Decimator::findRule(uint8_t const* buffer, size_t size)
+{
+    if (m_rules.empty()) {
+        return nullptr;
+    }
+    int index = SentenceDispatcher::tagIndex(Driver::peekSentenceTag(buffer, size));
+    uint16_t entry = index < 0 ? NO_RULE : m_table[index];
+    return entry == NO_RULE ? nullptr : &m_rules[entry - 1];
+}
+
+bool Decimator::accept(uint8_t const* buffer, size_t size)
+{
+    Rule* rule = findRule(buffer, size);
+    return !rule || accept(*rule, base::Time::now());
+}
+
+bool Decimator::accept(uint8_t const* buffer, size_t size, base::Time const& time)
+{
+    Rule* rule = findRule(buffer, size);
+    return !rule || accept(*rule, time);
+}
+
+bool Decimator::accept(Rule& rule, base::Time const& time)
+{
+    bool keep = true;
+    if (rule.every_nth > 1) {
+        keep = (rule.count == 0);
+        rule.count = (rule.count + 1) % rule.every_nth;
+    }
+    else if (!rule.period.isNull()) {
+        keep = rule.next.isNull() || time >= rule.next;
+        if (keep) {
+            // Stay on the grid unless we lagged behind by more than a
+            // period, e.g. after the sensor stopped sending for a while
+            bool lagging = rule.next.isNull() || time - rule.next >= rule.period;
+            rule.next = (lagging ? time : rule.next) + rule.period;
+        }
+    }
+
+    if (keep) {
+        rule.stats.kept++;
+    }
+    else {
+        rule.stats.dropped++;
+        m_dropped_count++;
+    }
+    return keep;
+}
+
+DecimationStatistics Decimator::getStatistics(string_view tag) const
+{
+    int index = SentenceDispatcher::tagIndex(tag);
+    if (index < 0 || m_table[index] == NO_RULE) {
+        return DecimationStatistics();
+    }
+    return m_rules[m_table[index] - 1].stats;
+}
+
+uint64_t Decimator::getDroppedCount() const
+{
+    return m_dropped_count;
+}
@@ -0,0 +1,98 @@
+#ifndef NMEA0183_DECIMATOR_HPP
+#define NMEA0183_DECIMATOR_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace nmea0183 {
+    struct DecimationStatistics {
+        uint64_t kept = 0;
+        uint64_t dropped = 0;
+    };
+
+    /**
+     * Per-tag decimation of framed sentences
+     *
+     * Sensors often send sentences (HDT, ROT, XDR, ...) faster than their
+     * consumers need. The decimator decides, from the tag of a framed
+     * sentence and before it gets parsed, whether it should be kept.
+     *
+     * Sentences are never held back: a kept sentence is always the latest
+     * one received. Tags without a policy, and proprietary sentences, are
+     * always kept.
+     *
+     * Decimating VDM/VDO would break multi-fragment AIS messages. The
+     * decimator is meant for sensor sentences.
+     */
+    class Decimator {
+        struct Rule {
+            std::string tag;
+            uint32_t every_nth = 1;
+            base::Time period;
+
+            uint32_t count = 0;
+            base::Time next;
+            DecimationStatistics stats;
+        };
+
+        static constexpr uint16_t NO_RULE = 0;
+
+        /** Index in m_rules, plus one, of the rule for each tag */
+        std::vector<uint16_t> m_table;
+        std::vector<Rule> m_rules;
+        uint64_t m_dropped_count = 0;
+
+        Rule& setRule(std::string_view tag);
+        Rule* findRule(uint8_t const* buffer, size_t size);
+        bool accept(Rule& rule, base::Time const& time);
+
+    public:
+        Decimator();
+
+        /** Keep one sentence out of n for the given tag
+         *
+         * It replaces any policy previously set for this tag
+         *
+         * @throw std::invalid_argument if n is zero or the tag is not made of
+         *   three uppercase letters
+         */
+        void keepEveryNth(std::string_view tag, uint32_t n);
+
+        /** Keep at most the given number of sentences per second for the
+         * given tag
+         *
+         * Kept sentences follow a fixed grid of 1/rate periods, so that
+         * jitter on the input does not lower the output rate. It replaces
+         * any policy previously set for this tag
+         *
+         * @throw std::invalid_argument if the rate is not strictly positive
+         *   or the tag is not made of three uppercase letters
+         */
+        void setMaxRate(std::string_view tag, double rate);
+
+        /** Remove the policy of the given tag, if there is one */
+        void remove(std::string_view tag);
+
+        /** Whether a framed sentence should be kept
+         *
+         * Rate limits use the current time
+         */
+        bool accept(uint8_t const* buffer, size_t size);
+
+        /** Whether a framed sentence should be kept, given its reception
+         * time
+         */
+        bool accept(uint8_t const* buffer, size_t size, base::Time const& time);
+
+        /** Statistics for the given tag. Zero if it has no policy */
+        DecimationStatistics getStatistics(std::string_view tag) const;
+
+        /** Count of sentences dropped, all tags included */
+        uint64_t getDroppedCount() const;
+    };
+}
+
+#endif
@@ -1,6 +1,12 @@
 #include <nmea0183/Driver.hpp>
+#include <nmea0183/Tracing.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <iodrivers_base/Exceptions.hpp>
 #include <marnav/nmea/checksum.hpp>
+#include <stdexcept>
+#include <sys/ioctl.h>
 
 using namespace std;
 using namespace nmea0183;
@@ -9,20 +15,58 @@ Driver::Driver()
     : iodrivers_base::Driver(BUFFER_SIZE) {
 }
 
-static uint8_t char2hex(char c) {
-    if (c <= '9') {
+static int char2hex(char c) {
+    if (c >= '0' && c <= '9') {
         return c - '0';
     }
-    else if (c <= 'F') {
+    else if (c >= 'A' && c <= 'F') {
         return 10 + c - 'A';
     }
-    else if (c <= 'f') {
+    else if (c >= 'a' && c <= 'f') {
         return 10 + c - 'a';
     }
-    throw std::invalid_argument("invalid hex character");
+    return -1;
 }
 
+static const char HEX_DIGITS[] = "0123456789ABCDEF";
+
 int Driver::extractPacket(uint8_t const* buffer, size_t buffer_size) const {
+    NMEA0183_TRACE_SCOPE(STAGE_EXTRACT);
+    return extractSentence(buffer, buffer_size, &m_checksum_error_count);
+}
+
+int Driver::extractSentence(uint8_t const* buffer, size_t buffer_size,
+                            uint32_t* checksum_error_count) {
+    if (buffer[0] != '\\') {
+        return extractSentenceBody(buffer, buffer_size, checksum_error_count);
+    }
+
+    int tag_block_size = TagBlock::extract(buffer, buffer_size, checksum_error_count);
+    if (tag_block_size <= 0) {
+        return tag_block_size;
+    }
+    else if (static_cast<size_t>(tag_block_size) == buffer_size) {
+        return 0;
+    }
+
+    // Checksum errors of the sentence are not counted here, but when the
+    // sentence gets framed again on its own
+    int sentence_size = extractSentenceBody(
+        buffer + tag_block_size, buffer_size - tag_block_size, nullptr
+    );
+    if (sentence_size < 0) {
+        // Only drop the backslash. If the sentence is valid on its own, it
+        // will be accepted without the block
+        return -1;
+    }
+    else if (sentence_size == 0) {
+        return 0;
+    }
+    return tag_block_size + sentence_size;
+}
+
+int Driver::extractSentenceBody(uint8_t const* buffer, size_t buffer_size,
+                                uint32_t* checksum_error_count) {
     if (buffer[0] != '$' && buffer[0] != '!') {
         return -1;
     }
@@ -32,9 +76,17 @@ int Driver::extractPacket(uint8_t const* buffer, size_t buffer_size) const {
 
     for (size_t i = 1; i < buffer_size; ++i) {
         if (buffer[i - 1] == '\r' && buffer[i] == '\n') {
-            uint8_t msg_checksum =
-                (char2hex(buffer[i - 3]) << 4) +
-                (char2hex(buffer[i - 2]) << 0);
+            // Shortest valid sentence is $*hh\r\n
+            if (i < 5 || buffer[i - 4] != '*') {
+                return -1;
+            }
+
+            int high = char2hex(buffer[i - 3]);
+            int low = char2hex(buffer[i - 2]);
+            if (high < 0 || low < 0) {
+                return -1;
+            }
+            uint8_t msg_checksum = (high << 4) + low;
 
             uint8_t checksum = 0;
             for (size_t j = 1; j < i - 4; ++j) {
@@ -42,6 +94,9 @@ int Driver::extractPacket(uint8_t const* buffer, size_t buffer_size) const {
             }
 
             if (checksum != msg_checksum) {
+                if (checksum_error_count) {
+                    (*checksum_error_count)++;
+                }
                 return -1;
             }
 
@@ -57,16 +112,335 @@ int Driver::extractPacket(uint8_t const* buffer, size_t buffer_size) const {
     return 0;
 }
 
+int Driver::readSentencePacket(uint8_t* buffer, int buffer_size) {
+    while (true) {
+        int size = readLeftoverInput(buffer, buffer_size);
+        if (size == 0) {
+            NMEA0183_TRACE_NEW_ID();
+            uint64_t start = NMEA0183_TRACE_NOW();
+            size = readPacket(buffer, buffer_size);
+            NMEA0183_TRACE_RECORD(STAGE_READ, start);
+        }
+        if (acceptSentencePacket(buffer, size)) {
+            return size;
+        }
+    }
+}
+
+int Driver::readLeftoverInput(uint8_t* buffer, int buffer_size) {
+    // Data read by tryReadSentencePacket comes first. Once it starts being
+    // consumed, it must be completed from the stream directly, as
+    // readPacket would not see it
+    while (m_input_size > 0) {
+        int size = frameInput(buffer, buffer_size);
+        if (size > 0) {
+            return size;
+        }
+        else if (m_input_size > 0 && !readInput()) {
+            getMainStream()->waitRead(getReadTimeout());
+        }
+    }
+    return 0;
+}
+
+bool Driver::acceptSentencePacket(uint8_t const* buffer, int size) {
+    if (!m_decimator.accept(buffer, size)) {
+        return false;
+    }
+    return !m_load_shedder.isEnabled() ||
+           m_load_shedder.accept(buffer, size, getBacklog());
+}
+
+int Driver::frameInput(uint8_t* buffer, int buffer_size) {
+    size_t pos = 0;
+    int size = 0;
+    while (pos < m_input_size) {
+        NMEA0183_TRACE_NEW_ID();
+        size_t window = min<size_t>(m_input_size - pos, MAX_PACKET_LENGTH);
+        size = extractPacket(m_input + pos, window);
+        if (size == 0 && window < m_input_size - pos) {
+            // No complete sentence fits in the window
+            size = -1;
+        }
+        if (size >= 0) {
+            break;
+        }
+        pos += -size;
+        size = 0;
+    }
+
+    if (size > buffer_size) {
+        throw length_error("tryReadSentencePacket: buffer too small");
+    }
+    else if (size > 0) {
+        memcpy(buffer, m_input + pos, size);
+        pos += size;
+    }
+    memmove(m_input, m_input + pos, m_input_size - pos);
+    m_input_size -= pos;
+    return size;
+}
+
+bool Driver::readInput() {
+    auto stream = getMainStream();
+    if (!stream || m_input_size == BUFFER_SIZE) {
+        return false;
+    }
+    size_t count = stream->read(m_input + m_input_size, BUFFER_SIZE - m_input_size);
+    m_input_size += count;
+    return count > 0;
+}
+
+int Driver::readQueuedPacket(uint8_t* buffer, int buffer_size) {
+    try {
+        NMEA0183_TRACE_NEW_ID();
+        return readPacket(buffer, buffer_size, base::Time());
+    }
+    catch (iodrivers_base::TimeoutError const&) {
+        // The data left by the blocking methods ends with a partial
+        // sentence. This only lasts until that sentence is complete
+        return 0;
+    }
+}
+
+int Driver::tryReadSentencePacket(uint8_t* buffer, int buffer_size) {
+    while (true) {
+        int size;
+        if (getStatus().queued_bytes > 0) {
+            size = readQueuedPacket(buffer, buffer_size);
+        }
+        else {
+            // Frame what is buffered first, and only read from the stream
+            // when it holds no complete sentence
+            size = frameInput(buffer, buffer_size);
+            while (size == 0 && readInput()) {
+                size = frameInput(buffer, buffer_size);
+            }
+        }
+
+        if (size == 0) {
+            return 0;
+        }
+        else if (acceptSentencePacket(buffer, size)) {
+            return size;
+        }
+    }
+}
+
+std::unique_ptr<marnav::nmea::sentence> Driver::tryReadSentence() {
+    int packet_size = tryReadSentencePacket(m_packet, BUFFER_SIZE);
+    if (packet_size == 0) {
+        return nullptr;
+    }
+    m_tag_block = TagBlock::parse(m_packet, packet_size);
+    return parseSentence(m_packet, packet_size);
+}
+
+bool Driver::tryReadSentence(FramedSentence& sentence) {
+    int packet_size = tryReadSentencePacket(sentence.data, BUFFER_SIZE);
+    if (packet_size == 0) {
+        return false;
+    }
+    sentence.size = packet_size;
+    sentence.time = base::Time::now();
+    return true;
+}
+
+Decimator& Driver::getDecimator() {
+    return m_decimator;
+}
+
+Decimator const& Driver::getDecimator() const {
+    return m_decimator;
+}
+
+LoadShedder& Driver::getLoadShedder() {
+    return m_load_shedder;
+}
+
+LoadShedder const& Driver::getLoadShedder() const {
+    return m_load_shedder;
+}
+
+size_t Driver::getBacklog() const {
+    size_t backlog = getStatus().queued_bytes + m_input_size;
+    int fd = getFileDescriptor();
+    int pending = 0;
+    if (fd != INVALID_FD && ioctl(fd, FIONREAD, &pending) == 0) {
+        backlog += pending;
+    }
+    return backlog;
+}
+
 std::unique_ptr<marnav::nmea::sentence> Driver::readSentence() {
-    uint8_t buffer[BUFFER_SIZE];
-    int sentence_size = readPacket(buffer, BUFFER_SIZE);
+    int packet_size = readSentencePacket(m_packet, BUFFER_SIZE);
+    m_tag_block = TagBlock::parse(m_packet, packet_size);
+    return parseSentence(m_packet, packet_size);
+}
+
+TagBlock const& Driver::getTagBlock() const {
+    return m_tag_block;
+}
+
+void Driver::readSentence(FramedSentence& sentence) {
+    sentence.size = readSentencePacket(sentence.data, BUFFER_SIZE);
+    sentence.time = base::Time::now();
+}
+
+std::unique_ptr<marnav::nmea::sentence> FramedSentence::parse() const {
+    return Driver::parseSentence(data, size);
+}
+
+TagBlock FramedSentence::getTagBlock() const {
+    return TagBlock::parse(data, size);
+}
+
+std::unique_ptr<marnav::nmea::sentence> Driver::parseSentence(
+    uint8_t const* buffer, size_t size
+) {
+    size_t tag_block_size = TagBlock::getSize(buffer, size);
+    buffer += tag_block_size;
+    size -= tag_block_size;
+
+    NMEA0183_TRACE_SCOPE(STAGE_PARSE);
     try {
         return marnav::nmea::make_sentence(
-            std::string(reinterpret_cast<char*>(buffer),
-                        reinterpret_cast<char*>(buffer + sentence_size - 2))
+            std::string(reinterpret_cast<char const*>(buffer),
+                        reinterpret_cast<char const*>(buffer + size - 2))
         );
     }
     catch (std::exception const& e) {
         throw MarnavParsingError(e.what());
     }
+}
+
+std::string_view Driver::peekSentenceTag(uint8_t const* buffer, size_t size) {
+    size_t tag_block_size = TagBlock::getSize(buffer, size);
+    buffer += tag_block_size;
+    size -= tag_block_size;
+
+    // $ + two-character talker + three-character formatter
+    if (size < 6 || buffer[1] == 'P') {
+        return std::string_view();
+    }
+    return std::string_view(reinterpret_cast<char const*>(buffer) + 3, 3);
+}
+
+void Driver::setFlushPolicy(base::Time const& max_latency, size_t max_bytes) {
+    if (max_bytes == 0 || max_bytes > OUTPUT_BUFFER_SIZE) {
+        throw std::invalid_argument(
+            "flush threshold must be between 1 and " +
+            std::to_string(OUTPUT_BUFFER_SIZE) + " bytes"
+        );
+    }
+    m_flush_max_latency = max_latency;
+    m_flush_max_bytes = max_bytes;
+}
+
+void Driver::writeSentence(std::string_view sentence) {
+    queueSentence(sentence);
+    applyFlushPolicy();
+}
+
+void Driver::writeSentence(marnav::nmea::sentence const& sentence) {
+    std::string formatted = marnav::nmea::to_string(sentence);
+    // Strip marnav's checksum, queueSentence computes it
+    writeSentence(std::string_view(formatted).substr(0, formatted.size() - 3));
+}
+
+void Driver::writeSentences(std::vector<std::string_view> const& sentences) {
+    for (auto sentence : sentences) {
+        queueSentence(sentence);
+    }
+    applyFlushPolicy();
+}
+
+void Driver::writeSentences(
+    std::vector<std::unique_ptr<marnav::nmea::sentence>> const& sentences
+) {
+    for (auto const& sentence : sentences) {
+        std::string formatted = marnav::nmea::to_string(*sentence);
+        queueSentence(std::string_view(formatted).substr(0, formatted.size() - 3));
+    }
+    applyFlushPolicy();
+}
+
+void Driver::queueSentence(std::string_view sentence) {
+    // sentence + *hh\r\n
+    size_t size = sentence.size() + 5;
+    if (sentence.empty() || (sentence[0] != '$' && sentence[0] != '!')) {
+        throw std::invalid_argument(
+            "NMEA sentences must start with '$' or '!', got '" +
+            std::string(sentence) + "'"
+        );
+    }
+    else if (size > MAX_SENTENCE_LENGTH) {
+        throw std::invalid_argument(
+            "sentence '" + std::string(sentence) + "' is longer than " +
+            std::to_string(MAX_SENTENCE_LENGTH) + " bytes"
+        );
+    }
+
+    if (m_output_size + size > m_flush_max_bytes) {
+        flush();
+    }
+    if (m_output_size == 0 && !m_flush_max_latency.isNull()) {
+        m_output_time = base::Time::now();
+    }
+
+    uint8_t* out = m_output + m_output_size;
+    out[0] = sentence[0];
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < sentence.size(); ++i) {
+        out[i] = sentence[i];
+        checksum ^= sentence[i];
+    }
+    out += sentence.size();
+    out[0] = '*';
+    out[1] = HEX_DIGITS[checksum >> 4];
+    out[2] = HEX_DIGITS[checksum & 0xF];
+    out[3] = '\r';
+    out[4] = '\n';
+    m_output_size += size;
+}
+
+void Driver::applyFlushPolicy() {
+    if (m_output_size >= m_flush_max_bytes || m_flush_max_latency.isNull()) {
+        flush();
+    }
+    else {
+        flushIfDue();
+    }
+}
+
+void Driver::flush() {
+    if (m_output_size == 0) {
+        return;
+    }
+    size_t size = m_output_size;
+    m_output_size = 0;
+    writePacket(m_output, size);
+}
+
+bool Driver::flushIfDue() {
+    if (m_output_size == 0 || base::Time::now() < getFlushDeadline()) {
+        return false;
+    }
+    flush();
+    return true;
+}
+
+base::Time Driver::getFlushDeadline() const {
+    if (m_output_size == 0) {
+        return base::Time();
+    }
+    return m_output_time + m_flush_max_latency;
+}
+
+size_t Driver::getPendingOutputSize() const {
+    return m_output_size;
+}
+
+uint32_t Driver::getChecksumErrorCount() const {
+    return m_checksum_error_count;
 }
\ No newline at end of file
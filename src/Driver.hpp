@@ -1,18 +1,65 @@
 #ifndef NMEA0183_DRIVER_HPP
 #define NMEA0183_DRIVER_HPP
 
+#include <base/Time.hpp>
 #include <iodrivers_base/Driver.hpp>
 #include <marnav/nmea/nmea.hpp>
 #include <marnav/nmea/sentence.hpp>
+#include <nmea0183/Decimator.hpp>
 #include <nmea0183/Exceptions.hpp>
+#include <nmea0183/LoadShedder.hpp>
+#include <nmea0183/TagBlock.hpp>
+#include <string_view>
+#include <vector>
 
 namespace nmea0183 {
+    struct FramedSentence;
+
     /**
      * Driver that extracts NMEA0183 sentences
      */
     class Driver : public iodrivers_base::Driver {
+    public:
         static const int MAX_SENTENCE_LENGTH = marnav::nmea::sentence::max_length;
-        static const int BUFFER_SIZE = MAX_SENTENCE_LENGTH * 2;
+        /** Maximum size of a packet, i.e. a sentence with its TAG block */
+        static const int MAX_PACKET_LENGTH = TagBlock::MAX_LENGTH + MAX_SENTENCE_LENGTH;
+        /** Size of the buffers given to readPacket */
+        static const int BUFFER_SIZE = MAX_PACKET_LENGTH * 2;
+        /** Size of the buffer in which writeSentence queues sentences */
+        static const int OUTPUT_BUFFER_SIZE = MAX_SENTENCE_LENGTH * 16;
+
+    private:
+        mutable uint32_t m_checksum_error_count = 0;
+        uint8_t m_packet[BUFFER_SIZE];
+        TagBlock m_tag_block;
+        Decimator m_decimator;
+        LoadShedder m_load_shedder;
+
+        uint8_t m_output[OUTPUT_BUFFER_SIZE];
+        size_t m_output_size = 0;
+        base::Time m_output_time;
+        base::Time m_flush_max_latency;
+        size_t m_flush_max_bytes = OUTPUT_BUFFER_SIZE;
+
+        void queueSentence(std::string_view sentence);
+        void applyFlushPolicy();
+        bool acceptSentencePacket(uint8_t const* buffer, int size);
+
+        /** Input read by tryReadSentencePacket that has not been framed yet
+         *
+         * It bypasses iodrivers_base's buffer, whose data can only be framed
+         * through readPacket, which throws when no sentence is complete
+         */
+        uint8_t m_input[BUFFER_SIZE];
+        size_t m_input_size = 0;
+
+        int frameInput(uint8_t* buffer, int buffer_size);
+        bool readInput();
+        int readQueuedPacket(uint8_t* buffer, int buffer_size);
+        int readLeftoverInput(uint8_t* buffer, int buffer_size);
+
+        static int extractSentenceBody(uint8_t const* buffer, size_t buffer_size,
+                                       uint32_t* checksum_error_count);
 
     protected:
         int extractPacket(uint8_t const* buffer, size_t buffer_size) const;
@@ -21,6 +68,205 @@ namespace nmea0183 {
         Driver();
 
         std::unique_ptr<marnav::nmea::sentence> readSentence();
+
+        /** The TAG block of the last sentence returned by readSentence()
+         *
+         * Its valid flag is false if the sentence had none. The fields point
+         * into the driver's internal buffer and are valid until the next
+         * call to readSentence()
+         */
+        TagBlock const& getTagBlock() const;
+
+        /** readPacket, skipping the sentences dropped by the decimator and
+         * the load shedder
+         *
+         * The read timeout applies to each sentence read, dropped or not
+         */
+        int readSentencePacket(uint8_t* buffer, int buffer_size);
+
+        /** readSentencePacket, without blocking
+         *
+         * The stream is read directly, without going through readPacket, so
+         * that no exception is involved when a sentence is incomplete. As a
+         * consequence, the data it reads is not reported to the listeners
+         * registered with addListener, nor counted in getStatus()
+         *
+         * @return the packet size, or zero if no full sentence is available
+         */
+        int tryReadSentencePacket(uint8_t* buffer, int buffer_size);
+
+        /** The decimation policy applied by the readSentence methods
+         *
+         * Dropped sentences are discarded right after framing, without
+         * being parsed
+         */
+        Decimator& getDecimator();
+
+        /** @overload */
+        Decimator const& getDecimator() const;
+
+        /** The priority-based load shedding applied by the readSentence
+         * methods, after decimation
+         */
+        LoadShedder& getLoadShedder();
+
+        /** @overload */
+        LoadShedder const& getLoadShedder() const;
+
+        /** Number of bytes received but not yet returned as sentences
+         *
+         * This is the data in the driver's internal buffer, plus what is
+         * waiting in the file descriptor if there is one (FIONREAD)
+         */
+        size_t getBacklog() const;
+
+        /** Read the next sentence without parsing it
+         *
+         * This does not allocate. It is meant to fill the slots of a
+         * SPSCQueue in place, and leave the parsing to the consumer
+         */
+        void readSentence(FramedSentence& sentence);
+
+        /** Read a sentence if one is available, without blocking
+         *
+         * Unlike readSentence(), it does not throw iodrivers_base::TimeoutError
+         * when there is no data. It is meant for event loops: wait for
+         * getFileDescriptor() to be readable, and call tryReadSentence()
+         * until it returns null. Sentences that are already buffered are
+         * returned without any system call.
+         *
+         * @return the sentence, or null if no full sentence is available
+         * @throw MarnavParsingError if the sentence cannot be parsed
+         */
+        std::unique_ptr<marnav::nmea::sentence> tryReadSentence();
+
+        /** Read a sentence without parsing it, if one is available
+         *
+         * @return false if no full sentence is available
+         * @see tryReadSentence()
+         */
+        bool tryReadSentence(FramedSentence& sentence);
+
+        /** Set when queued sentences get written
+         *
+         * Sentences are written once the oldest one has been queued for
+         * max_latency, or once max_bytes are queued. The latency is only
+         * checked when writing sentences or calling flushIfDue().
+         *
+         * The default (null latency) writes on every call to writeSentence
+         * or writeSentences.
+         *
+         * @throw std::invalid_argument if max_bytes is zero or bigger than
+         *   OUTPUT_BUFFER_SIZE
+         */
+        void setFlushPolicy(base::Time const& max_latency,
+                            size_t max_bytes = OUTPUT_BUFFER_SIZE);
+
+        /** Queue a sentence for writing, and apply the flush policy
+         *
+         * The checksum and the trailing CR/LF are computed while copying the
+         * sentence into the output buffer. This does not allocate.
+         *
+         * @param sentence the sentence without its checksum nor CR/LF, e.g.
+         *   "$HEHDT,274.07,T"
+         * @throw std::invalid_argument if the sentence does not start with
+         *   '$' or '!', or is longer than MAX_SENTENCE_LENGTH once completed
+         */
+        void writeSentence(std::string_view sentence);
+
+        /** Queue a sentence built with marnav, and apply the flush policy */
+        void writeSentence(marnav::nmea::sentence const& sentence);
+
+        /** Queue several sentences, and apply the flush policy once
+         *
+         * With the default policy, they get written with a single write
+         */
+        void writeSentences(std::vector<std::string_view> const& sentences);
+
+        /** Queue several sentences built with marnav, e.g. the VDM
+         * fragments of an AIS message
+         */
+        void writeSentences(
+            std::vector<std::unique_ptr<marnav::nmea::sentence>> const& sentences);
+
+        /** Write all queued sentences
+         *
+         * The queue is emptied even if the write fails
+         */
+        void flush();
+
+        /** Write the queued sentences if the flush policy's latency is
+         * exceeded
+         *
+         * @return true if sentences have been written
+         */
+        bool flushIfDue();
+
+        /** Time at which the queued sentences must be written, null if
+         * there are none
+         */
+        base::Time getFlushDeadline() const;
+
+        /** Size of the sentences queued but not written yet */
+        size_t getPendingOutputSize() const;
+
+        /** Sentence framing, as used by the driver
+         *
+         * It follows the extractPacket protocol: it returns the size of the
+         * sentence starting at buffer[0] if there is a complete and valid
+         * one, 0 if more data is needed and -1 if the first byte should be
+         * discarded.
+         *
+         * A sentence may be prefixed by a NMEA 4.x TAG block. Both are then
+         * returned as a single packet.
+         *
+         * @param checksum_error_count if non-null, incremented when a
+         *   sentence is rejected because of its checksum
+         */
+        static int extractSentence(uint8_t const* buffer, size_t buffer_size,
+                                   uint32_t* checksum_error_count = nullptr);
+
+        /** Parse a sentence extracted by readPacket
+         *
+         * readSentence() is readPacket() followed by parseSentence(). Use the
+         * two separately if you need to do something between framing and
+         * parsing
+         *
+         * @param buffer the sentence, including the trailing CR/LF. A TAG
+         *   block in front of it is skipped
+         * @param size the sentence size, including the trailing CR/LF
+         */
+        static std::unique_ptr<marnav::nmea::sentence> parseSentence(
+            uint8_t const* buffer, size_t size);
+
+        /** The three-letter sentence formatter of a framed sentence, without
+         * parsing it
+         *
+         * This is e.g. "RMC" for "$GPRMC,...". It returns an empty view
+         * for proprietary sentences and for buffers too short to contain a
+         * tag. The view points into the buffer.
+         */
+        static std::string_view peekSentenceTag(uint8_t const* buffer, size_t size);
+
+        /** Returns the count of sentences that have been rejected because
+         * their checksum did not match
+         */
+        uint32_t getChecksumErrorCount() const;
+    };
+
+    /** A sentence as extracted by Driver, not parsed yet */
+    struct FramedSentence {
+        /** Time at which the sentence was read */
+        base::Time time;
+        /** Sentence size, including the trailing CR/LF */
+        uint16_t size = 0;
+        uint8_t data[Driver::BUFFER_SIZE];
+
+        /** @see Driver::parseSentence */
+        std::unique_ptr<marnav::nmea::sentence> parse() const;
+
+        /** The sentence's TAG block. Its fields point into data */
+        TagBlock getTagBlock() const;
     };
 }
 
@@ -1,4 +1,8 @@
 #include "GPS.hpp"
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <nmea0183/Exceptions.hpp>
 #include <nmea0183/GPS.hpp>
 
 using namespace nmea0183;
@@ -30,24 +34,24 @@ GPS_SOLUTION_TYPES GPS::getPositionType(nmea::mode_indicator mode)
     }
 }
 
-Solution GPS::getSolution(nmea::rmc const& rmc, nmea::gsa const& gsa)
+static Solution makeSolution(optional<nmea::mode_indicator> mode_indicator,
+    double latitude,
+    double longitude,
+    int satellite_count)
 {
     Solution solution;
     solution.time = base::Time::now();
     GPS_SOLUTION_TYPES position_type;
-    if (rmc.get_mode_ind().has_value()) {
-        auto mode_indicator = rmc.get_mode_ind().value();
-        position_type = getPositionType(mode_indicator);
+    if (mode_indicator.has_value()) {
+        position_type = GPS::getPositionType(mode_indicator.value());
     }
     else {
         position_type = GPS_SOLUTION_TYPES::INVALID;
     }
-    auto optional_latitude = rmc.get_latitude();
-    auto optional_longitude = rmc.get_longitude();
-    if (position_type != GPS_SOLUTION_TYPES::INVALID && optional_latitude.has_value() &&
-        optional_longitude.has_value()) {
-        solution.latitude = optional_latitude.value();
-        solution.longitude = optional_longitude.value();
+    if (position_type != GPS_SOLUTION_TYPES::INVALID && !base::isUnknown(latitude) &&
+        !base::isUnknown(longitude)) {
+        solution.latitude = latitude;
+        solution.longitude = longitude;
         solution.positionType = position_type;
     }
     else {
@@ -55,13 +59,39 @@ Solution GPS::getSolution(nmea::rmc const& rmc, nmea::gsa const& gsa)
         solution.latitude = base::unknown<double>();
         solution.longitude = base::unknown<double>();
     }
-    solution.noOfSatellites = 0;
+    solution.noOfSatellites = satellite_count;
+    return solution;
+}
+
+Solution GPS::getSolution(nmea::rmc const& rmc, nmea::gsa const& gsa)
+{
+    optional<nmea::mode_indicator> mode_indicator;
+    if (rmc.get_mode_ind().has_value()) {
+        mode_indicator = rmc.get_mode_ind().value();
+    }
+    double latitude = base::unknown<double>();
+    double longitude = base::unknown<double>();
+    auto optional_latitude = rmc.get_latitude();
+    auto optional_longitude = rmc.get_longitude();
+    if (optional_latitude.has_value() && optional_longitude.has_value()) {
+        latitude = optional_latitude.value();
+        longitude = optional_longitude.value();
+    }
+    int satellite_count = 0;
     for (int i = 0; i < gsa.max_satellite_ids; i++) {
         if (gsa.get_satellite_id(i).has_value()) {
-            solution.noOfSatellites += 1;
+            satellite_count += 1;
         }
     }
-    return solution;
+    return makeSolution(mode_indicator, latitude, longitude, satellite_count);
+}
+
+Solution GPS::getSolution(RMC const& rmc, GSA const& gsa)
+{
+    return makeSolution(rmc.mode_indicator,
+        rmc.latitude,
+        rmc.longitude,
+        gsa.satellite_count);
 }
 
 SolutionQuality GPS::getSolutionQuality(nmea::gsa const& gsa)
@@ -97,3 +127,181 @@ SolutionQuality GPS::getSolutionQuality(nmea::gsa const& gsa)
     }
     return solution_quality;
 }
+
+SolutionQuality GPS::getSolutionQuality(GSA const& gsa)
+{
+    SolutionQuality solution_quality;
+    solution_quality.time = base::Time::now();
+    solution_quality.pdop = gsa.pdop;
+    solution_quality.hdop = gsa.hdop;
+    solution_quality.vdop = gsa.vdop;
+    solution_quality.usedSatellites.assign(
+        gsa.satellite_ids, gsa.satellite_ids + gsa.satellite_count);
+    return solution_quality;
+}
+
+/** Splits the next field out of the fields of a sentence */
+static string_view nextField(string_view& fields)
+{
+    size_t comma = fields.find(',');
+    string_view field = fields.substr(0, comma);
+    fields = comma == string_view::npos ? string_view() : fields.substr(comma + 1);
+    return field;
+}
+
+/** The fields of a framed sentence if it has the given type, regardless of
+ * its talker. Returns false otherwise
+ */
+static bool getFields(uint8_t const* buffer,
+    size_t size,
+    string_view type,
+    string_view& fields)
+{
+    size_t tag_block_size = TagBlock::getSize(buffer, size);
+    string_view sentence(reinterpret_cast<char const*>(buffer) + tag_block_size,
+        size - tag_block_size);
+    size_t checksum = sentence.rfind('*');
+    // $ttXXX,
+    if (checksum == string_view::npos || checksum < 7 || sentence[0] != '$' ||
+        sentence.substr(3, 3) != type || sentence[6] != ',') {
+        return false;
+    }
+    fields = sentence.substr(7, checksum - 7);
+    return true;
+}
+
+static MarnavParsingError invalidField(string_view type, string_view field)
+{
+    return MarnavParsingError(
+        "invalid " + string(type) + " field '" + string(field) + "'");
+}
+
+/** Parse a decimal field, NaN if it is empty */
+static double parseDecimal(string_view type, string_view field)
+{
+    if (field.empty()) {
+        return base::unknown<double>();
+    }
+    // Fields are followed by ',' or '*' in the buffer, which ends strtod
+    char* end;
+    double value = strtod(field.data(), &end);
+    if (end != field.data() + field.size()) {
+        throw invalidField(type, field);
+    }
+    return value;
+}
+
+/** Parse a ddmm.mm or dddmm.mm field and its hemisphere into degrees */
+static double parseCoordinate(string_view type,
+    string_view field,
+    string_view hemisphere,
+    char positive,
+    char negative)
+{
+    double value = parseDecimal(type, field);
+    if (base::isUnknown(value)) {
+        return value;
+    }
+
+    double degrees = floor(value / 100);
+    degrees += (value - degrees * 100) / 60;
+    if (hemisphere.size() == 1 && hemisphere[0] == positive) {
+        return degrees;
+    }
+    else if (hemisphere.size() == 1 && hemisphere[0] == negative) {
+        return -degrees;
+    }
+    throw invalidField(type, hemisphere);
+}
+
+static nmea::mode_indicator parseModeIndicator(string_view field)
+{
+    if (field.size() != 1) {
+        throw invalidField("RMC", field);
+    }
+    switch (field[0]) {
+        case 'V':
+            return nmea::mode_indicator::invalid;
+        case 'A':
+            return nmea::mode_indicator::autonomous;
+        case 'D':
+            return nmea::mode_indicator::differential;
+        case 'E':
+            return nmea::mode_indicator::estimated;
+        case 'M':
+            return nmea::mode_indicator::manual_input;
+        case 'S':
+            return nmea::mode_indicator::simulated;
+        case 'N':
+            return nmea::mode_indicator::data_not_valid;
+        case 'P':
+            return nmea::mode_indicator::precise;
+        default:
+            throw invalidField("RMC", field);
+    }
+}
+
+bool GPS::parseRMC(uint8_t const* buffer, size_t size, RMC& rmc)
+{
+    string_view fields;
+    if (!getFields(buffer, size, "RMC", fields)) {
+        return false;
+    }
+
+    RMC result;
+    nextField(fields); // UTC time
+    string_view status = nextField(fields);
+    if (status != "A" && status != "V") {
+        throw invalidField("RMC", status);
+    }
+    result.valid = status == "A";
+    string_view latitude = nextField(fields);
+    result.latitude = parseCoordinate("RMC", latitude, nextField(fields), 'N', 'S');
+    string_view longitude = nextField(fields);
+    result.longitude = parseCoordinate("RMC", longitude, nextField(fields), 'E', 'W');
+    result.speed_over_ground = parseDecimal("RMC", nextField(fields));
+    result.course_over_ground = parseDecimal("RMC", nextField(fields));
+    nextField(fields); // date
+    nextField(fields); // magnetic variation
+    nextField(fields); // magnetic variation direction
+    if (!fields.empty()) {
+        result.mode_indicator = parseModeIndicator(nextField(fields));
+    }
+    rmc = result;
+    return true;
+}
+
+bool GPS::parseGSA(uint8_t const* buffer, size_t size, GSA& gsa)
+{
+    string_view fields;
+    if (!getFields(buffer, size, "GSA", fields)) {
+        return false;
+    }
+
+    GSA result;
+    nextField(fields); // selection mode
+    string_view fix_mode = nextField(fields);
+    if (!fix_mode.empty()) {
+        if (fix_mode.size() != 1 || fix_mode[0] < '1' || fix_mode[0] > '3') {
+            throw invalidField("GSA", fix_mode);
+        }
+        result.fix_mode = fix_mode[0] - '0';
+    }
+    for (int i = 0; i < GSA::MAX_SATELLITE_IDS; ++i) {
+        string_view field = nextField(fields);
+        if (field.empty()) {
+            continue;
+        }
+        uint32_t id;
+        auto parsed = from_chars(field.data(), field.data() + field.size(), id);
+        if (parsed.ec != errc() || parsed.ptr != field.data() + field.size()) {
+            throw invalidField("GSA", field);
+        }
+        result.satellite_ids[result.satellite_count++] = id;
+    }
+    result.pdop = parseDecimal("GSA", nextField(fields));
+    result.hdop = parseDecimal("GSA", nextField(fields));
+    result.vdop = parseDecimal("GSA", nextField(fields));
+    gsa = result;
+    return true;
+}
@@ -5,6 +5,7 @@
 #include <marnav/nmea/gsa.hpp>
 #include <marnav/nmea/rmc.hpp>
 #include <nmea0183/Driver.hpp>
+#include <optional>
 
 namespace nmea0183 {
     /**
@@ -12,6 +13,66 @@ namespace nmea0183 {
      *
      */
     namespace GPS {
+        /**
+         * The fields of a RMC sentence used to build a solution
+         *
+         * Unlike marnav::nmea::rmc, it is filled in place by parseRMC, so that
+         * the same object can be reused for every sentence without allocating
+         */
+        struct RMC {
+            /** Whether the status field is A (data valid) */
+            bool valid = false;
+            /** In degrees, positive north. NaN if absent */
+            double latitude = base::unknown<double>();
+            /** In degrees, positive east. NaN if absent */
+            double longitude = base::unknown<double>();
+            /** In knots. NaN if absent */
+            double speed_over_ground = base::unknown<double>();
+            /** In degrees, clockwise from true north. NaN if absent */
+            double course_over_ground = base::unknown<double>();
+            /** Absent before NMEA 2.3 */
+            std::optional<marnav::nmea::mode_indicator> mode_indicator;
+        };
+
+        /**
+         * The fields of a GSA sentence, filled in place by parseGSA
+         *
+         * @see RMC
+         */
+        struct GSA {
+            static const int MAX_SATELLITE_IDS = 12;
+
+            /** 1 for no fix, 2 for 2D and 3 for 3D. Zero if absent */
+            int fix_mode = 0;
+            /** The IDs of the satellites used in the solution */
+            uint32_t satellite_ids[MAX_SATELLITE_IDS] = {};
+            int satellite_count = 0;
+            double pdop = base::unknown<double>();
+            double hdop = base::unknown<double>();
+            double vdop = base::unknown<double>();
+        };
+
+        /**
+         * @brief Parse a framed RMC sentence without allocating
+         *
+         * The sentence is expected to come from Driver::readSentencePacket or
+         * FramedSentence, i.e. to have a valid checksum. It may have a TAG
+         * block.
+         *
+         * @param rmc overwritten with the sentence fields. It is left
+         *   unchanged if the sentence is not a RMC or is invalid
+         * @return false if the sentence is not a RMC
+         * @throw MarnavParsingError if one of the fields is invalid
+         */
+        bool parseRMC(uint8_t const* buffer, size_t size, RMC& rmc);
+
+        /**
+         * @brief Parse a framed GSA sentence without allocating
+         *
+         * @see parseRMC
+         */
+        bool parseGSA(uint8_t const* buffer, size_t size, GSA& gsa);
+
         /**
          * @brief Get the Solution object from the nmea 0183 rmc and gsa messages
          *
@@ -28,6 +89,10 @@ namespace nmea0183 {
          * @return gps_base::SolutionQuality
          */
         gps_base::SolutionQuality getSolutionQuality(marnav::nmea::gsa const& gsa);
+        /** @overload */
+        gps_base::Solution getSolution(RMC const& rmc, GSA const& gsa);
+        /** @overload */
+        gps_base::SolutionQuality getSolutionQuality(GSA const& gsa);
         /**
          * @brief Get the Position Type object from the nmea 0183 mode indicator
          *
@@ -0,0 +1,347 @@
+#include <nmea0183/Generator.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <marnav/ais/ais.hpp>
+#include <marnav/nmea/ais_helper.hpp>
+#include <marnav/nmea/nmea.hpp>
+#include <nmea0183/AIS.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+
+static const double EARTH_RADIUS = 6371000;
+static const double MS_TO_KNOTS = 1.94384;
+/** Radius of the circle the own ship follows */
+static const double OWN_SHIP_RADIUS = 1000;
+static const double OWN_SHIP_SPEED = 5;
+static const int FIRST_MMSI = 710000000;
+
+Generator::Generator(GeneratorConfig const& config)
+    : m_config(config)
+    , m_rng(config.seed)
+{
+    static const vector<string> supported = {"RMC", "GGA", "GSA", "VTG", "ZDA", "HDT"};
+    for (auto const& tag : m_config.gnss_sentences) {
+        if (find(supported.begin(), supported.end(), tag) == supported.end()) {
+            throw invalid_argument("unsupported GNSS sentence " + tag);
+        }
+    }
+
+    for (size_t i = 0; i < m_config.vessel_count; ++i) {
+        Vessel vessel;
+        vessel.mmsi = FIRST_MMSI + i;
+        double r = m_config.area_radius * sqrt(random(0, 1));
+        double theta = random(0, 2 * M_PI);
+        vessel.north = r * cos(theta);
+        vessel.east = r * sin(theta);
+        vessel.course = random(0, 2 * M_PI);
+        vessel.speed = random(0, 10);
+        m_vessels.push_back(vessel);
+
+        // Spread the reports over the first period
+        double position_period = m_config.position_period.toSeconds();
+        double static_period = m_config.static_period.toSeconds();
+        m_events.push(Event{base::Time::fromSeconds(random(0, position_period)),
+            EVENT_POSITION,
+            i});
+        m_events.push(
+            Event{base::Time::fromSeconds(random(0, static_period)), EVENT_STATIC, i});
+    }
+
+    if (!m_config.gnss_period.isNull()) {
+        m_events.push(Event{base::Time(), EVENT_GNSS, 0});
+    }
+}
+
+double Generator::random(double min, double max)
+{
+    return uniform_real_distribution<double>(min, max)(m_rng);
+}
+
+bool Generator::draw(double probability)
+{
+    return probability > 0 && random(0, 1) < probability;
+}
+
+GeneratorStatistics const& Generator::getStatistics() const
+{
+    return m_stats;
+}
+
+string Generator::finalizeSentence(string const& sentence)
+{
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < sentence.size(); ++i) {
+        checksum ^= sentence[i];
+    }
+    char suffix[6];
+    snprintf(suffix, sizeof(suffix), "*%02X\r\n", checksum);
+    return sentence + suffix;
+}
+
+base::Time Generator::next(string& output)
+{
+    if (m_events.empty()) {
+        throw logic_error("Generator::next called on a generator that has nothing "
+                          "to generate");
+    }
+
+    Event event = m_events.top();
+    m_events.pop();
+
+    // Fragments held by the previous event get interleaved with this one's
+    // sentences
+    vector<string> held;
+    held.swap(m_held_fragments);
+
+    vector<string> sentences;
+    switch (event.type) {
+        case EVENT_GNSS:
+            generateGNSS(event.time, sentences);
+            m_events.push(Event{event.time + m_config.gnss_period, EVENT_GNSS, 0});
+            break;
+        case EVENT_POSITION: {
+            Vessel& vessel = m_vessels[event.vessel];
+            updateVessel(vessel, event.time);
+            generatePosition(vessel, sentences);
+            m_events.push(Event{event.time + m_config.position_period,
+                EVENT_POSITION,
+                event.vessel});
+            break;
+        }
+        case EVENT_STATIC:
+            generateStatic(m_vessels[event.vessel], sentences);
+            m_events.push(
+                Event{event.time + m_config.static_period, EVENT_STATIC, event.vessel});
+            break;
+    }
+
+    size_t held_index = 0;
+    for (auto& sentence : sentences) {
+        if (held_index < held.size()) {
+            emit(move(held[held_index++]), output);
+        }
+        emit(move(sentence), output);
+    }
+    for (; held_index < held.size(); ++held_index) {
+        emit(move(held[held_index]), output);
+    }
+    return event.time;
+}
+
+void Generator::emit(string sentence, string& output)
+{
+    if (draw(m_config.garbage_rate)) {
+        size_t count = 1 + m_rng() % 16;
+        for (size_t i = 0; i < count; ++i) {
+            char c;
+            do {
+                c = static_cast<char>(m_rng() % 256);
+            } while (c == '$' || c == '!');
+            output.push_back(c);
+        }
+        m_stats.garbage_bytes += count;
+        m_stats.bytes += count;
+    }
+
+    if (draw(m_config.checksum_error_rate)) {
+        size_t star = sentence.rfind('*');
+        if (star != string::npos && star + 2 < sentence.size()) {
+            // Swap the two digits, or change the last one if they are equal
+            if (sentence[star + 1] != sentence[star + 2]) {
+                swap(sentence[star + 1], sentence[star + 2]);
+            }
+            else {
+                sentence[star + 2] = sentence[star + 2] == '0' ? '1' : '0';
+            }
+            m_stats.checksum_errors++;
+        }
+    }
+
+    m_stats.sentences++;
+    m_stats.bytes += sentence.size();
+    output += sentence;
+}
+
+void Generator::updateVessel(Vessel& vessel, base::Time const& time)
+{
+    double dt = (time - vessel.last_update).toSeconds();
+    vessel.last_update = time;
+    vessel.north += vessel.speed * cos(vessel.course) * dt;
+    vessel.east += vessel.speed * sin(vessel.course) * dt;
+
+    // Head back roughly towards the center when leaving the area
+    if (hypot(vessel.north, vessel.east) > m_config.area_radius) {
+        vessel.course = atan2(-vessel.east, -vessel.north) + random(-0.5, 0.5);
+    }
+    vessel.course = fmod(vessel.course + 2 * M_PI, 2 * M_PI);
+}
+
+void Generator::generatePosition(Vessel& vessel, vector<string>& sentences)
+{
+    double latitude = m_config.latitude.getRad();
+    ais_base::Position position;
+    position.mmsi = vessel.mmsi;
+    position.status = ais_base::NavigationalStatus::STATUS_UNDER_WAY_USING_ENGINE;
+    position.high_accuracy_position = true;
+    position.latitude = base::Angle::fromRad(latitude + vessel.north / EARTH_RADIUS);
+    position.longitude = base::Angle::fromRad(
+        m_config.longitude.getRad() + vessel.east / (EARTH_RADIUS * cos(latitude)));
+    position.course_over_ground = base::Angle::fromRad(vessel.course);
+    position.yaw = base::Angle::fromRad(vessel.course);
+    position.speed_over_ground = vessel.speed;
+    position.maneuver_indicator = ais_base::ManeuverIndicator::MANEUVER_NOT_AVAILABLE;
+
+    auto message = AIS::getMessageFromPosition(position);
+    encodeVDMs(ais::encode_message(message), sentences);
+    m_stats.ais_messages++;
+}
+
+void Generator::generateStatic(Vessel const& vessel, vector<string>& sentences)
+{
+    size_t index = vessel.mmsi - FIRST_MMSI;
+    ais_base::VesselInformation info;
+    info.mmsi = vessel.mmsi;
+    info.imo = 9000000 + index;
+    info.name = "SIM VESSEL " + to_string(index);
+    info.call_sign = "SIM" + to_string(index % 10000);
+    info.length = 20 + index % 280;
+    info.width = info.length / 6;
+    info.draft = 2 + index % 12;
+    info.reference_position = base::Vector3d::Zero();
+
+    auto message = AIS::getMessageFromVesselInformation(info);
+    vector<string> fragments;
+    encodeVDMs(ais::encode_message(message), fragments);
+    m_stats.ais_messages++;
+
+    if (fragments.size() > 1 && draw(m_config.reorder_rate)) {
+        reverse(fragments.begin(), fragments.end());
+        m_stats.reordered_messages++;
+    }
+    if (fragments.size() > 1 && draw(m_config.interleave_rate)) {
+        m_held_fragments = move(fragments);
+        m_stats.interleaved_messages++;
+        return;
+    }
+    sentences.insert(sentences.end(), fragments.begin(), fragments.end());
+}
+
+void Generator::encodeVDMs(vector<pair<string, uint32_t>> const& payloads,
+    vector<string>& sentences)
+{
+    // The sequential message ID is only needed for multi-fragment messages,
+    // and left empty otherwise as real transponders do
+    utils::optional<uint32_t> sequence_id;
+    if (payloads.size() > 1) {
+        sequence_id = m_sequence_id;
+        m_sequence_id = (m_sequence_id + 1) % 10;
+    }
+    auto vdms = nmea::make_vdms(payloads, sequence_id, nmea::ais_channel::A);
+    for (auto const& vdm : vdms) {
+        sentences.push_back(nmea::to_string(*vdm) + "\r\n");
+    }
+}
+
+static string formatAngle(double deg, int degree_digits, char positive, char negative)
+{
+    double abs_deg = fabs(deg);
+    int whole = static_cast<int>(abs_deg);
+    double minutes = (abs_deg - whole) * 60;
+    char buffer[32];
+    snprintf(buffer,
+        sizeof(buffer),
+        "%0*d%07.4f,%c",
+        degree_digits,
+        whole,
+        minutes,
+        deg < 0 ? negative : positive);
+    return buffer;
+}
+
+void Generator::generateGNSS(base::Time const& time, vector<string>& sentences)
+{
+    // The own ship goes in circles around the area's center
+    double angle = time.toSeconds() * OWN_SHIP_SPEED / OWN_SHIP_RADIUS;
+    double north = OWN_SHIP_RADIUS * cos(angle);
+    double east = OWN_SHIP_RADIUS * sin(angle);
+    double course = fmod(angle * 180 / M_PI + 90, 360);
+    double latitude = m_config.latitude.getDeg() + north / EARTH_RADIUS * 180 / M_PI;
+    double longitude =
+        m_config.longitude.getDeg() +
+        east / (EARTH_RADIUS * cos(m_config.latitude.getRad())) * 180 / M_PI;
+    string lat = formatAngle(latitude, 2, 'N', 'S');
+    string lon = formatAngle(longitude, 3, 'E', 'W');
+    double sog = OWN_SHIP_SPEED * MS_TO_KNOTS;
+
+    base::Time utc = m_config.start_time + time;
+    time_t seconds = utc.toSeconds();
+    int centiseconds = (utc.toMilliseconds() % 1000) / 10;
+    tm fields;
+    gmtime_r(&seconds, &fields);
+    char hms[16];
+    snprintf(hms,
+        sizeof(hms),
+        "%02d%02d%02d.%02d",
+        fields.tm_hour,
+        fields.tm_min,
+        fields.tm_sec,
+        centiseconds);
+
+    char buffer[128];
+    for (auto const& tag : m_config.gnss_sentences) {
+        if (tag == "RMC") {
+            snprintf(buffer,
+                sizeof(buffer),
+                "$GPRMC,%s,A,%s,%s,%.1f,%.1f,%02d%02d%02d,,,A",
+                hms,
+                lat.c_str(),
+                lon.c_str(),
+                sog,
+                course,
+                fields.tm_mday,
+                fields.tm_mon + 1,
+                fields.tm_year % 100);
+        }
+        else if (tag == "GGA") {
+            snprintf(buffer,
+                sizeof(buffer),
+                "$GPGGA,%s,%s,%s,1,08,0.9,10.0,M,0.0,M,,",
+                hms,
+                lat.c_str(),
+                lon.c_str());
+        }
+        else if (tag == "GSA") {
+            snprintf(buffer,
+                sizeof(buffer),
+                "$GPGSA,A,3,01,02,03,04,05,06,07,08,,,,,1.5,0.9,1.2");
+        }
+        else if (tag == "VTG") {
+            snprintf(buffer,
+                sizeof(buffer),
+                "$GPVTG,%.1f,T,,M,%.1f,N,%.1f,K,A",
+                course,
+                sog,
+                OWN_SHIP_SPEED * 3.6);
+        }
+        else if (tag == "ZDA") {
+            snprintf(buffer,
+                sizeof(buffer),
+                "$GPZDA,%s,%02d,%02d,%04d,00,00",
+                hms,
+                fields.tm_mday,
+                fields.tm_mon + 1,
+                fields.tm_year + 1900);
+        }
+        else if (tag == "HDT") {
+            snprintf(buffer, sizeof(buffer), "$HEHDT,%.1f,T", course);
+        }
+        sentences.push_back(finalizeSentence(buffer));
+    }
+    m_stats.gnss_epochs++;
+}
@@ -0,0 +1,147 @@
+#ifndef NMEA0183_GENERATOR_HPP
+#define NMEA0183_GENERATOR_HPP
+
+#include <base/Angle.hpp>
+#include <base/Time.hpp>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace nmea0183 {
+    struct GeneratorConfig {
+        /** Time of the first generated sample. Used for the GNSS time fields */
+        base::Time start_time = base::Time::fromSeconds(1704067200);
+        /** Center of the area the vessels move in */
+        base::Angle latitude = base::Angle::fromDeg(-22.9);
+        base::Angle longitude = base::Angle::fromDeg(-43.15);
+        /** Radius of the area the vessels move in, in meters */
+        double area_radius = 20000;
+
+        /** Number of simulated AIS vessels */
+        size_t vessel_count = 100;
+        /** Time between two position reports (type 1) of a vessel */
+        base::Time position_period = base::Time::fromSeconds(10);
+        /** Time between two static data reports (type 5, two fragments) of a
+         * vessel
+         */
+        base::Time static_period = base::Time::fromSeconds(360);
+
+        /** Time between two GNSS epochs. Zero to disable GNSS output */
+        base::Time gnss_period = base::Time::fromSeconds(1);
+        /** The sentences generated at each GNSS epoch. Supported are RMC,
+         * GGA, GSA, VTG, ZDA and HDT
+         */
+        std::vector<std::string> gnss_sentences = {"RMC", "GGA", "GSA", "VTG", "ZDA", "HDT"};
+
+        /** Probability that a sentence's checksum is corrupted */
+        double checksum_error_rate = 0;
+        /** Probability that garbage bytes are inserted before a sentence */
+        double garbage_rate = 0;
+        /** Probability that the fragments of a multi-fragment AIS message are
+         * sent in reverse order
+         */
+        double reorder_rate = 0;
+        /** Probability that the fragments of a multi-fragment AIS message are
+         * interleaved with the sentences that follow
+         */
+        double interleave_rate = 0;
+
+        uint32_t seed = 0;
+    };
+
+    struct GeneratorStatistics {
+        uint64_t sentences = 0;
+        uint64_t bytes = 0;
+        uint64_t gnss_epochs = 0;
+        uint64_t ais_messages = 0;
+        uint64_t checksum_errors = 0;
+        uint64_t garbage_bytes = 0;
+        uint64_t reordered_messages = 0;
+        uint64_t interleaved_messages = 0;
+    };
+
+    /**
+     * Generation of synthetic NMEA traffic, to stress-test Driver and AIS
+     *
+     * It simulates a set of vessels moving in a circular area and reporting
+     * over AIS, and an own-ship GNSS receiver. The AIS messages are encoded
+     * with AIS::getMessageFromPosition and AIS::getMessageFromVesselInformation.
+     *
+     * The generator does not deal with time itself. next() returns the
+     * simulation time of the generated data, and it is up to the caller to
+     * pace the output. The generation is deterministic for a given seed.
+     */
+    class Generator {
+        struct Vessel {
+            int mmsi;
+            /** Position relative to the area center, in meters */
+            double north;
+            double east;
+            /** Course in radians, clockwise from north */
+            double course;
+            /** Speed in m/s */
+            double speed;
+            base::Time last_update;
+        };
+
+        enum EventType { EVENT_GNSS, EVENT_POSITION, EVENT_STATIC };
+
+        struct Event {
+            base::Time time;
+            EventType type;
+            size_t vessel;
+
+            bool operator<(Event const& other) const
+            {
+                // std::priority_queue is a max-heap
+                return time > other.time;
+            }
+        };
+
+        GeneratorConfig m_config;
+        std::mt19937 m_rng;
+        std::vector<Vessel> m_vessels;
+        std::priority_queue<Event> m_events;
+        std::vector<std::string> m_held_fragments;
+        uint32_t m_sequence_id = 0;
+        GeneratorStatistics m_stats;
+
+        double random(double min, double max);
+        bool draw(double probability);
+
+        void updateVessel(Vessel& vessel, base::Time const& time);
+        void generateGNSS(base::Time const& time, std::vector<std::string>& sentences);
+        void generatePosition(Vessel& vessel, std::vector<std::string>& sentences);
+        void generateStatic(Vessel const& vessel, std::vector<std::string>& sentences);
+        void encodeVDMs(std::vector<std::pair<std::string, uint32_t>> const& payloads,
+            std::vector<std::string>& sentences);
+        void emit(std::string sentence, std::string& output);
+
+    public:
+        /**
+         * @throw std::invalid_argument if the configuration contains an
+         *   unsupported GNSS sentence
+         */
+        explicit Generator(GeneratorConfig const& config);
+
+        /** Generate the data of the next event
+         *
+         * @param output the generated bytes are appended to it
+         * @return the time of the event, relative to the start of the
+         *   simulation
+         */
+        base::Time next(std::string& output);
+
+        GeneratorStatistics const& getStatistics() const;
+
+        /** Append the NMEA checksum and CR/LF to a sentence
+         *
+         * @param sentence the sentence, from the leading $ or ! up to and
+         *   excluding the '*'
+         */
+        static std::string finalizeSentence(std::string const& sentence);
+    };
+}
+
+#endif
@@ -0,0 +1,206 @@
+#include <chrono>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iodrivers_base/Exceptions.hpp>
+#include <iostream>
+#include <map>
+#include <nmea0183/Driver.hpp>
+#include <nmea0183/Generator.hpp>
+#include <sstream>
+#include <termios.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+void usage(ostream& out) {
+    out << "nmea0183_generator OUTPUT [OPTIONS]\n"
+        << "generates synthetic NMEA traffic (own-ship GNSS and AIS vessels)\n"
+        << "\n"
+        << "OUTPUT is either:\n"
+        << "  pty: creates a pseudo-terminal and prints the path of its slave side\n"
+        << "  an iodrivers_base URI, e.g. tcp://localhost:4000 or udp://localhost:4000\n"
+        << "  a file path\n"
+        << "\n"
+        << "OPTIONS are:\n"
+        << "  --vessels N            number of AIS vessels (100)\n"
+        << "  --position-period S    seconds between two position reports of a\n"
+        << "                         vessel (10)\n"
+        << "  --static-period S      seconds between two static reports of a\n"
+        << "                         vessel (360)\n"
+        << "  --gnss-period S        seconds between two GNSS epochs, 0 to disable (1)\n"
+        << "  --gnss LIST            comma-separated GNSS sentences\n"
+        << "                         (RMC,GGA,GSA,VTG,ZDA,HDT)\n"
+        << "  --checksum-errors P    probability of a corrupted checksum (0)\n"
+        << "  --garbage P            probability of garbage before a sentence (0)\n"
+        << "  --reorder P            probability of reversed AIS fragments (0)\n"
+        << "  --interleave P         probability of interleaved AIS fragments (0)\n"
+        << "  --speedup X            rate relative to real time, 0 to generate as\n"
+        << "                         fast as possible (1)\n"
+        << "  --duration S           simulated seconds to generate, 0 for no limit (0)\n"
+        << "  --seed N               random seed (0)\n"
+        << std::flush;
+}
+
+static vector<string> split(string const& list) {
+    vector<string> result;
+    stringstream stream(list);
+    string item;
+    while (getline(stream, item, ',')) {
+        result.push_back(item);
+    }
+    return result;
+}
+
+static void openPTY(Driver& driver) {
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0) {
+        throw runtime_error("failed to create a pseudo-terminal");
+    }
+
+    // Pass the bytes through unchanged
+    termios tio;
+    tcgetattr(fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(fd, TCSANOW, &tio);
+
+    cout << "writing to " << ptsname(fd) << endl;
+    driver.setFileDescriptor(fd, true, false);
+}
+
+static void openOutput(Driver& driver, string const& output) {
+    if (output == "pty") {
+        openPTY(driver);
+    }
+    else if (output.find("://") != string::npos) {
+        driver.openURI(output);
+    }
+    else {
+        int fd = open(output.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            throw runtime_error("cannot open " + output + " for writing");
+        }
+        driver.setFileDescriptor(fd, true, false);
+    }
+}
+
+static void printStatistics(GeneratorStatistics const& stats, uint64_t write_timeouts) {
+    cout << "sentences: " << stats.sentences << "\n"
+         << "bytes: " << stats.bytes << "\n"
+         << "GNSS epochs: " << stats.gnss_epochs << "\n"
+         << "AIS messages: " << stats.ais_messages << "\n"
+         << "checksum errors: " << stats.checksum_errors << "\n"
+         << "garbage bytes: " << stats.garbage_bytes << "\n"
+         << "reordered AIS messages: " << stats.reordered_messages << "\n"
+         << "interleaved AIS messages: " << stats.interleaved_messages << "\n"
+         << "write timeouts: " << write_timeouts << endl;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage(cerr);
+        return 1;
+    }
+
+    string output(argv[1]);
+    map<string, string> options;
+    for (int i = 2; i < argc; i += 2) {
+        string name(argv[i]);
+        if (name.substr(0, 2) != "--" || i + 1 >= argc) {
+            usage(cerr);
+            return 1;
+        }
+        options[name.substr(2)] = argv[i + 1];
+    }
+
+    GeneratorConfig config;
+    double speedup = 1;
+    double duration = 0;
+    try {
+        for (auto const& option : options) {
+            string const& name = option.first;
+            string const& value = option.second;
+            if (name == "vessels") {
+                config.vessel_count = stoul(value);
+            }
+            else if (name == "position-period") {
+                config.position_period = base::Time::fromSeconds(stod(value));
+            }
+            else if (name == "static-period") {
+                config.static_period = base::Time::fromSeconds(stod(value));
+            }
+            else if (name == "gnss-period") {
+                config.gnss_period = base::Time::fromSeconds(stod(value));
+            }
+            else if (name == "gnss") {
+                config.gnss_sentences = split(value);
+            }
+            else if (name == "checksum-errors") {
+                config.checksum_error_rate = stod(value);
+            }
+            else if (name == "garbage") {
+                config.garbage_rate = stod(value);
+            }
+            else if (name == "reorder") {
+                config.reorder_rate = stod(value);
+            }
+            else if (name == "interleave") {
+                config.interleave_rate = stod(value);
+            }
+            else if (name == "speedup") {
+                speedup = stod(value);
+            }
+            else if (name == "duration") {
+                duration = stod(value);
+            }
+            else if (name == "seed") {
+                config.seed = stoul(value);
+            }
+            else {
+                cerr << "unknown option --" << name << "\n\n";
+                usage(cerr);
+                return 1;
+            }
+        }
+    }
+    catch (std::logic_error const& e) {
+        cerr << "invalid option value: " << e.what() << "\n\n";
+        usage(cerr);
+        return 1;
+    }
+
+    config.start_time = base::Time::now();
+    Generator generator(config);
+    Driver driver;
+    openOutput(driver, output);
+    driver.setWriteTimeout(base::Time::fromSeconds(1));
+
+    auto start = chrono::steady_clock::now();
+    uint64_t write_timeouts = 0;
+    string data;
+    while (true) {
+        data.clear();
+        base::Time time = generator.next(data);
+        if (duration > 0 && time.toSeconds() > duration) {
+            break;
+        }
+
+        if (speedup > 0) {
+            auto deadline = start + chrono::microseconds(
+                static_cast<int64_t>(time.toMicroseconds() / speedup));
+            this_thread::sleep_until(deadline);
+        }
+
+        try {
+            driver.writePacket(reinterpret_cast<uint8_t const*>(data.data()), data.size());
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+            // Nobody reads on the other side. Keep going, this is a load test
+            write_timeouts++;
+        }
+    }
+
+    printStatistics(generator.getStatistics(), write_timeouts);
+    return 0;
+}
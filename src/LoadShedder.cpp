@@ -0,0 +1,222 @@
+#include <nmea0183/LoadShedder.hpp>
+
+#include <cstring>
+#include <nmea0183/AISPayload.hpp>
+#include <nmea0183/Driver.hpp>
+#include <nmea0183/SentenceDispatcher.hpp>
+#include <nmea0183/TagBlock.hpp>
+#include <stdexcept>
+
+using namespace std;
+using namespace nmea0183;
+
+/** Entry of the AIS priority table for types that follow the tag priority */
+static const uint8_t TAG_PRIORITY = 0xFF;
+
+static const char* HIGH_PRIORITY_TAGS[] = {
+    "RMC", "GGA", "GNS", "GLL", "GSA", "VTG", "ZDA", "HDT", "HDG", "THS", "ROT"};
+static const uint8_t LOW_PRIORITY_AIS_TYPES[] = {18, 19, 24};
+
+static const base::Time RATE_WINDOW = base::Time::fromSeconds(1);
+
+LoadShedder::LoadShedder()
+    : m_tag_priorities(26 * 26 * 26, PRIORITY_NORMAL)
+{
+    memset(m_ais_priorities, TAG_PRIORITY, sizeof(m_ais_priorities));
+    for (auto tag : HIGH_PRIORITY_TAGS) {
+        setPriority(tag, PRIORITY_HIGH);
+    }
+    for (auto type : LOW_PRIORITY_AIS_TYPES) {
+        setAISPriority(type, PRIORITY_LOW);
+    }
+    disable();
+}
+
+void LoadShedder::setPriority(string_view tag, SentencePriority priority)
+{
+    int index = SentenceDispatcher::tagIndex(tag);
+    if (index < 0) {
+        throw invalid_argument("invalid sentence tag '" + string(tag) + "'");
+    }
+    m_tag_priorities[index] = priority;
+}
+
+void LoadShedder::setAISPriority(uint8_t message_type, SentencePriority priority)
+{
+    if (message_type == 0 || message_type >= 64) {
+        throw invalid_argument("invalid AIS message type " + to_string(message_type));
+    }
+    m_ais_priorities[message_type] = priority;
+}
+
+void LoadShedder::setMaxBacklog(SentencePriority priority, size_t bytes)
+{
+    m_max_backlog[priority] = bytes;
+    updateEnabled();
+}
+
+void LoadShedder::setMaxLatency(SentencePriority priority, base::Time const& latency)
+{
+    m_max_latency[priority] = latency;
+    updateEnabled();
+}
+
+void LoadShedder::disable()
+{
+    for (int i = 0; i < PRIORITY_COUNT; ++i) {
+        m_max_backlog[i] = SIZE_MAX;
+        m_max_latency[i] = base::Time();
+    }
+    m_enabled = false;
+}
+
+void LoadShedder::updateEnabled()
+{
+    m_enabled = false;
+    for (int i = 0; i < PRIORITY_COUNT; ++i) {
+        m_enabled = m_enabled || m_max_backlog[i] != SIZE_MAX ||
+                    !m_max_latency[i].isNull();
+    }
+}
+
+bool LoadShedder::isEnabled() const
+{
+    return m_enabled;
+}
+
+/** A comma-separated field of a sentence. The sentence address is field 0 */
+static string_view getField(string_view sentence, int field)
+{
+    size_t start = 0;
+    for (int i = 0; i < field; ++i) {
+        start = sentence.find(',', start);
+        if (start == string_view::npos) {
+            return string_view();
+        }
+        start++;
+    }
+    size_t end = sentence.find_first_of(",*\r", start);
+    return sentence.substr(start, end == string_view::npos ? end : end - start);
+}
+
+SentencePriority LoadShedder::classify(uint8_t const* buffer,
+    size_t size,
+    bool& first_ais_fragment) const
+{
+    first_ais_fragment = false;
+    string_view tag = Driver::peekSentenceTag(buffer, size);
+    int index = SentenceDispatcher::tagIndex(tag);
+    if (index < 0) {
+        return PRIORITY_NORMAL;
+    }
+
+    auto priority = static_cast<SentencePriority>(m_tag_priorities[index]);
+    if (tag != "VDM" && tag != "VDO") {
+        return priority;
+    }
+
+    size_t tag_block_size = TagBlock::getSize(buffer, size);
+    string_view sentence(reinterpret_cast<char const*>(buffer) + tag_block_size,
+        size - tag_block_size);
+    if (getField(sentence, 2) != "1") {
+        return priority;
+    }
+
+    first_ais_fragment = true;
+    string_view payload = getField(sentence, 5);
+    if (payload.empty()) {
+        return priority;
+    }
+    uint8_t type = AISPayload::getMessageType(string(1, payload[0]));
+    if (type >= 64 || m_ais_priorities[type] == TAG_PRIORITY) {
+        return priority;
+    }
+    return static_cast<SentencePriority>(m_ais_priorities[type]);
+}
+
+SentencePriority LoadShedder::classify(uint8_t const* buffer, size_t size) const
+{
+    bool first_ais_fragment;
+    return classify(buffer, size, first_ais_fragment);
+}
+
+void LoadShedder::updateConsumptionRate(size_t size, base::Time const& time)
+{
+    if (m_window_start.isNull()) {
+        m_window_start = time;
+    }
+    m_window_bytes += size;
+
+    base::Time elapsed = time - m_window_start;
+    if (elapsed >= RATE_WINDOW) {
+        m_consumption_rate = m_window_bytes / elapsed.toSeconds();
+        m_window_start = time;
+        m_window_bytes = 0;
+    }
+}
+
+bool LoadShedder::isOverloaded(SentencePriority priority, size_t backlog) const
+{
+    if (backlog > m_max_backlog[priority]) {
+        return true;
+    }
+    base::Time const& max_latency = m_max_latency[priority];
+    return !max_latency.isNull() && m_consumption_rate > 0 &&
+           backlog > m_consumption_rate * max_latency.toSeconds();
+}
+
+bool LoadShedder::accept(uint8_t const* buffer, size_t size, size_t backlog)
+{
+    return accept(buffer, size, backlog, base::Time::now());
+}
+
+bool LoadShedder::accept(uint8_t const* buffer,
+    size_t size,
+    size_t backlog,
+    base::Time const& time)
+{
+    updateConsumptionRate(size, time);
+
+    bool first_ais_fragment;
+    SentencePriority priority = classify(buffer, size, first_ais_fragment);
+    bool shed;
+    string_view tag = Driver::peekSentenceTag(buffer, size);
+    if (!first_ais_fragment && (tag == "VDM" || tag == "VDO")) {
+        priority = m_ais_message_priority;
+        shed = m_ais_message_shed;
+    }
+    else {
+        shed = isOverloaded(priority, backlog);
+        if (first_ais_fragment) {
+            m_ais_message_priority = priority;
+            m_ais_message_shed = shed;
+        }
+    }
+
+    if (shed) {
+        m_stats[priority].shed++;
+    }
+    else {
+        m_stats[priority].kept++;
+    }
+    return !shed;
+}
+
+double LoadShedder::getConsumptionRate() const
+{
+    return m_consumption_rate;
+}
+
+LoadSheddingStatistics LoadShedder::getStatistics(SentencePriority priority) const
+{
+    return m_stats[priority];
+}
+
+uint64_t LoadShedder::getShedCount() const
+{
+    uint64_t count = 0;
+    for (auto const& stats : m_stats) {
+        count += stats.shed;
+    }
+    return count;
+}
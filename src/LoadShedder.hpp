@@ -0,0 +1,129 @@
+#ifndef NMEA0183_LOAD_SHEDDER_HPP
+#define NMEA0183_LOAD_SHEDDER_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace nmea0183 {
+    enum SentencePriority : uint8_t {
+        PRIORITY_HIGH,
+        PRIORITY_NORMAL,
+        PRIORITY_LOW,
+        PRIORITY_COUNT
+    };
+
+    struct LoadSheddingStatistics {
+        uint64_t kept = 0;
+        uint64_t shed = 0;
+    };
+
+    /**
+     * Priority-based shedding of framed sentences under overload
+     *
+     * Sentences are classified by tag and, for AIS, by message type right
+     * after framing. When the input backlog goes over the threshold of a
+     * priority, the sentences of that priority are dropped before being
+     * parsed, so that the backlog of the higher priorities gets consumed
+     * faster.
+     *
+     * The backlog is given in bytes. The latency thresholds are converted
+     * to bytes with the rate at which sentences have been consumed over
+     * the last second.
+     *
+     * By default, own-ship navigation sentences (RMC, GGA, GNS, GLL, GSA,
+     * VTG, ZDA, HDT, HDG, THS, ROT) are high priority, AIS class B
+     * messages (18, 19, 24) low priority and everything else normal. No
+     * sentence is shed until a threshold is set.
+     *
+     * The fragments of a multi-sentence AIS message share the fate of its
+     * first fragment.
+     */
+    class LoadShedder {
+        std::vector<uint8_t> m_tag_priorities;
+        uint8_t m_ais_priorities[64];
+        size_t m_max_backlog[PRIORITY_COUNT];
+        base::Time m_max_latency[PRIORITY_COUNT];
+        LoadSheddingStatistics m_stats[PRIORITY_COUNT];
+        bool m_enabled = false;
+
+        SentencePriority m_ais_message_priority = PRIORITY_NORMAL;
+        bool m_ais_message_shed = false;
+
+        /** Consumption rate estimation */
+        base::Time m_window_start;
+        uint64_t m_window_bytes = 0;
+        double m_consumption_rate = 0;
+
+        void updateEnabled();
+        void updateConsumptionRate(size_t size, base::Time const& time);
+        bool isOverloaded(SentencePriority priority, size_t backlog) const;
+        SentencePriority classify(uint8_t const* buffer, size_t size,
+            bool& first_ais_fragment) const;
+
+    public:
+        LoadShedder();
+
+        /** Set the priority of a sentence tag
+         *
+         * @throw std::invalid_argument if the tag is not made of three
+         *   uppercase letters
+         */
+        void setPriority(std::string_view tag, SentencePriority priority);
+
+        /** Set the priority of an AIS message type
+         *
+         * It overrides the priority of the VDM/VDO tags
+         *
+         * @throw std::invalid_argument if the type is not a valid AIS
+         *   message type (1 to 63)
+         */
+        void setAISPriority(uint8_t message_type, SentencePriority priority);
+
+        /** Shed the sentences of the given priority when the backlog exceeds
+         * the given number of bytes
+         */
+        void setMaxBacklog(SentencePriority priority, size_t bytes);
+
+        /** Shed the sentences of the given priority when the backlog would
+         * take longer than the given time to be consumed
+         */
+        void setMaxLatency(SentencePriority priority, base::Time const& latency);
+
+        /** Remove the thresholds of all priorities */
+        void disable();
+
+        /** Whether a threshold is set. If not, accept always returns true */
+        bool isEnabled() const;
+
+        /** The priority of a framed sentence
+         *
+         * Continuation fragments of AIS messages are classified as their
+         * tag, since they do not contain the message type
+         */
+        SentencePriority classify(uint8_t const* buffer, size_t size) const;
+
+        /** Whether a framed sentence should be kept
+         *
+         * @param backlog the number of bytes waiting to be processed
+         */
+        bool accept(uint8_t const* buffer, size_t size, size_t backlog);
+
+        /** @overload with an explicit current time */
+        bool accept(uint8_t const* buffer,
+            size_t size,
+            size_t backlog,
+            base::Time const& time);
+
+        /** Rate at which sentences are consumed, in bytes per second */
+        double getConsumptionRate() const;
+
+        LoadSheddingStatistics getStatistics(SentencePriority priority) const;
+
+        /** Count of sentences shed, all priorities included */
+        uint64_t getShedCount() const;
+    };
+}
+
+#endif
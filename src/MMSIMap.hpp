@@ -0,0 +1,135 @@
+#ifndef NMEA0183_MMSI_MAP_HPP
+#define NMEA0183_MMSI_MAP_HPP
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace nmea0183 {
+    /**
+     * Per-target values keyed by MMSI, stored contiguously
+     *
+     * Values live in a vector, so that walking all targets is a linear scan,
+     * and a hash map gives the index of each MMSI. Removal moves the last
+     * value into the freed slot: indices stay dense, but a removal changes
+     * the index of the last value.
+     */
+    template <typename T> class MMSIMap {
+        std::vector<T> m_values;
+        std::vector<int> m_mmsis;
+        std::unordered_map<int, uint32_t> m_indices;
+
+    public:
+        static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+        /** The index of a target, or NOT_FOUND */
+        uint32_t find(int mmsi) const
+        {
+            auto it = m_indices.find(mmsi);
+            return it == m_indices.end() ? NOT_FOUND : it->second;
+        }
+
+        /** The value of a target, or null. It is invalidated by any change */
+        T* get(int mmsi)
+        {
+            uint32_t index = find(mmsi);
+            return index == NOT_FOUND ? nullptr : &m_values[index];
+        }
+
+        T const* get(int mmsi) const
+        {
+            uint32_t index = find(mmsi);
+            return index == NOT_FOUND ? nullptr : &m_values[index];
+        }
+
+        /** Add the value of a target that is not in the map yet
+         *
+         * @return its index
+         */
+        uint32_t insert(int mmsi, T const& value)
+        {
+            uint32_t index = m_values.size();
+            m_values.push_back(value);
+            m_mmsis.push_back(mmsi);
+            m_indices[mmsi] = index;
+            return index;
+        }
+
+        /** Remove the value at the given index
+         *
+         * @return true if the last value has been moved to the index
+         */
+        bool removeAt(uint32_t index)
+        {
+            m_indices.erase(m_mmsis[index]);
+            uint32_t last = m_values.size() - 1;
+            bool moved = index != last;
+            if (moved) {
+                m_values[index] = std::move(m_values[last]);
+                m_mmsis[index] = m_mmsis[last];
+                m_indices[m_mmsis[index]] = index;
+            }
+            m_values.pop_back();
+            m_mmsis.pop_back();
+            return moved;
+        }
+
+        /** Remove the values for which match(value) is true
+         *
+         * @param remove called with the index of each value to remove. It
+         *   must remove it with removeAt
+         * @return the number of removed values
+         */
+        template <typename Match, typename Remove>
+        size_t removeIf(Match match, Remove remove)
+        {
+            size_t removed = 0;
+            for (size_t i = 0; i < m_values.size();) {
+                if (match(m_values[i])) {
+                    // The last value is moved to i, do not increment
+                    remove(i);
+                    removed++;
+                }
+                else {
+                    ++i;
+                }
+            }
+            return removed;
+        }
+
+        template <typename Match> size_t removeIf(Match match)
+        {
+            return removeIf(match, [this](uint32_t index) { removeAt(index); });
+        }
+
+        void clear()
+        {
+            m_values.clear();
+            m_mmsis.clear();
+            m_indices.clear();
+        }
+
+        size_t size() const
+        {
+            return m_values.size();
+        }
+
+        T& operator[](uint32_t index)
+        {
+            return m_values[index];
+        }
+
+        T const& operator[](uint32_t index) const
+        {
+            return m_values[index];
+        }
+
+        /** All values, in no particular order */
+        std::vector<T> const& values() const
+        {
+            return m_values;
+        }
+    };
+}
+
+#endif
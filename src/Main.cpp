@@ -1,21 +1,396 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iodrivers_base/TestStream.hpp>
 #include <iostream>
+#include <map>
 #include <marnav/ais/name.hpp>
+#include <mutex>
 #include <nmea0183/Driver.hpp>
 #include <nmea0183/AIS.hpp>
+#include <nmea0183/Capture.hpp>
+#include <nmea0183/GPS.hpp>
+#include <nmea0183/SharedSamples.hpp>
+#include <sstream>
+#include <thread>
 
 using namespace std;
 using namespace nmea0183;
 using namespace marnav;
 
+static const int MAX_PACKET_SIZE = 1024;
+
 void usage(ostream& out) {
     out << "nmea0183_ctl URI CMD\n"
         << "where CMD is:\n"
         << "  log-sentences: continuously shows timestamp and "
            "type of sentences received\n"
         << "  log-ais: continuously shows timestamp and type of AIS messages received\n"
+        << "  stats: shows a summary of the received data every second (rates per\n"
+        << "    sentence and AIS message type, error rates, bandwidth, latency from\n"
+        << "    the read of the last byte of a sentence to the end of its decoding,\n"
+        << "    and decode time, i.e. parsing and AIS processing only)\n"
+        << "  capture FILE: records the raw data received, with arrival timestamps,\n"
+        << "    in a binary capture file that can be read back with CaptureReader\n"
+        << "  publish NAME: decodes the GNSS solutions, AIS positions and vessel\n"
+        << "    information (class A, and joined class B parts A/B), and publishes\n"
+        << "    them in the shared memory segment NAME (e.g. /nmea0183) for\n"
+        << "    SharedSampleReader\n"
+        << "\n"
+        << "nmea0183_ctl FILE replay [BAUDRATE [SPEEDUP]]\n"
+        << "  feeds a captured NMEA stream through the sentence and AIS decoding\n"
+        << "  and reports throughput statistics at the end. The file is replayed\n"
+        << "  as fast as possible, unless BAUDRATE is given. In this case, it is\n"
+        << "  replayed at the rate of a serial line at this baudrate, optionally\n"
+        << "  sped up by SPEEDUP\n"
         << std::flush;
 }
 
+struct ReplayStatistics {
+    uint64_t sentences = 0;
+    uint64_t messages = 0;
+    uint64_t parse_errors = 0;
+};
+
+static void processAvailableSentences(Driver& driver, AIS& ais, ReplayStatistics& stats) {
+    while (true) {
+        unique_ptr<nmea::sentence> sentence;
+        try {
+            sentence = driver.readSentence();
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+            return;
+        }
+        catch (MarnavParsingError const&) {
+            stats.parse_errors++;
+            continue;
+        }
+
+        stats.sentences++;
+        try {
+            if (ais.processSentence(*sentence)) {
+                stats.messages++;
+            }
+        }
+        catch (MarnavParsingError const&) {
+            stats.parse_errors++;
+        }
+    }
+}
+
+int replay(string const& path, int baudrate, double speedup) {
+    ifstream file(path, ios::binary);
+    if (!file) {
+        cerr << "cannot open " << path << endl;
+        return 1;
+    }
+    stringstream contents;
+    contents << file.rdbuf();
+    string data = contents.str();
+
+    Driver driver;
+    driver.openURI("test://");
+    driver.setReadTimeout(base::Time());
+    auto stream = dynamic_cast<iodrivers_base::TestStream*>(driver.getMainStream());
+    AIS ais(driver);
+
+    // Serial lines transmit 10 bits per byte (start, 8 data bits, stop)
+    double bytes_per_second = baudrate * speedup / 10;
+    size_t chunk_size = 4096;
+    if (baudrate > 0) {
+        // Push about 10ms worth of data at a time
+        chunk_size = max<size_t>(1, bytes_per_second / 100);
+    }
+
+    ReplayStatistics stats;
+    auto wall_start = chrono::steady_clock::now();
+    clock_t cpu_start = clock();
+    for (size_t offset = 0; offset < data.size(); offset += chunk_size) {
+        if (baudrate > 0) {
+            auto due = wall_start + chrono::duration_cast<chrono::steady_clock::duration>(
+                chrono::duration<double>(offset / bytes_per_second));
+            this_thread::sleep_until(due);
+        }
+
+        size_t end = min(offset + chunk_size, data.size());
+        stream->pushDataToDriver(vector<uint8_t>(data.begin() + offset, data.begin() + end));
+        processAvailableSentences(driver, ais, stats);
+    }
+    double cpu_time = static_cast<double>(clock() - cpu_start) / CLOCKS_PER_SEC;
+    double wall_time = chrono::duration<double>(chrono::steady_clock::now() - wall_start).count();
+
+    auto status = driver.getStatus();
+    cout << "replayed " << data.size() << " bytes in " << wall_time << " s ("
+         << cpu_time << " s CPU)\n"
+         << "  sentences: " << stats.sentences << " ("
+         << stats.sentences / wall_time << " per second, "
+         << (stats.sentences ? cpu_time * 1e6 / stats.sentences : 0) << " us CPU per sentence)\n"
+         << "  AIS messages: " << stats.messages << " ("
+         << stats.messages / wall_time << " per second, "
+         << (stats.messages ? cpu_time * 1e6 / stats.messages : 0) << " us CPU per message)\n"
+         << "  dropped:\n"
+         << "    bytes rejected by framing or checksum: " << status.bad_rx << "\n"
+         << "    sentences that marnav could not parse: " << stats.parse_errors << "\n"
+         << "    AIS fragments discarded by reassembly: "
+         << ais.getDiscardedSentenceCount() << "\n"
+         << std::flush;
+    return 0;
+}
+
+/** Statistics gathered by the I/O thread of the stats command
+ *
+ * Counts are reset each time the printing thread collects them. The
+ * cumulative fields are copied from the driver and AIS objects, and
+ * differentiated by the printing thread
+ */
+struct LiveStatistics {
+    map<string, uint64_t> sentences;
+    map<string, uint64_t> messages;
+    uint64_t parse_errors = 0;
+    vector<double> latencies;
+    vector<double> decode_times;
+
+    uint64_t cumulative_bytes = 0;
+    uint64_t cumulative_checksum_errors = 0;
+    uint64_t cumulative_discarded_fragments = 0;
+};
+
+static double percentile(vector<double>& values, double p) {
+    if (values.empty()) {
+        return 0;
+    }
+    size_t index = min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+/** Thread that prints the statistics gathered by the stats command
+ *
+ * The thread is stopped and joined on destruction, so that it never
+ * outlives the shared statistics, e.g. when the I/O loop throws
+ */
+class StatisticsPrinter {
+    mutex m_lock;
+    condition_variable m_stop_signal;
+    bool m_stop = false;
+    LiveStatistics m_shared;
+    thread m_thread;
+
+    void run();
+
+public:
+    StatisticsPrinter()
+        : m_thread([this] { run(); }) {
+    }
+
+    ~StatisticsPrinter() {
+        {
+            lock_guard<mutex> guard(m_lock);
+            m_stop = true;
+        }
+        m_stop_signal.notify_one();
+        m_thread.join();
+    }
+
+    template <typename Update> void update(Update update) {
+        lock_guard<mutex> guard(m_lock);
+        update(m_shared);
+    }
+};
+
+void StatisticsPrinter::run() {
+    LiveStatistics& shared = m_shared;
+    LiveStatistics last;
+    auto last_time = chrono::steady_clock::now();
+    while (true) {
+        // Only swap under the lock, so that the I/O thread is never blocked
+        // while formatting
+        LiveStatistics current;
+        {
+            unique_lock<mutex> guard(m_lock);
+            bool stop = m_stop_signal.wait_until(
+                guard, last_time + chrono::seconds(1), [this] { return m_stop; });
+            if (stop) {
+                return;
+            }
+            swap(current.sentences, shared.sentences);
+            swap(current.messages, shared.messages);
+            swap(current.latencies, shared.latencies);
+            swap(current.decode_times, shared.decode_times);
+            current.parse_errors = shared.parse_errors;
+            shared.parse_errors = 0;
+            current.cumulative_bytes = shared.cumulative_bytes;
+            current.cumulative_checksum_errors = shared.cumulative_checksum_errors;
+            current.cumulative_discarded_fragments = shared.cumulative_discarded_fragments;
+        }
+        auto now = chrono::steady_clock::now();
+        double dt = chrono::duration<double>(now - last_time).count();
+        last_time = now;
+
+        ostringstream out;
+        out << base::Time::now() << "\n"
+            << "  bytes/s: " << (current.cumulative_bytes - last.cumulative_bytes) / dt << "\n"
+            << "  errors/s: checksum="
+            << (current.cumulative_checksum_errors - last.cumulative_checksum_errors) / dt
+            << " parse=" << current.parse_errors / dt << " reassembly="
+            << (current.cumulative_discarded_fragments -
+                last.cumulative_discarded_fragments) / dt << "\n"
+            << "  latency: p50=" << percentile(current.latencies, 0.5) * 1e6
+            << "us p99=" << percentile(current.latencies, 0.99) * 1e6 << "us\n"
+            << "  decode time: p50=" << percentile(current.decode_times, 0.5) * 1e6
+            << "us p99=" << percentile(current.decode_times, 0.99) * 1e6 << "us\n"
+            << "  sentences/s:";
+        for (auto const& tag : current.sentences) {
+            out << " " << tag.first << "=" << tag.second / dt;
+        }
+        out << "\n  AIS messages/s:";
+        for (auto const& type : current.messages) {
+            out << " " << type.first << "=" << type.second / dt;
+        }
+        out << "\n";
+        cout << out.str() << std::flush;
+
+        last = move(current);
+    }
+}
+
+/** Records when each chunk of data has been read from the device
+ *
+ * It is used to stamp sentences with the arrival time of their last byte
+ */
+class ArrivalListener : public iodrivers_base::IOListener {
+    struct Read {
+        /** Offset in the stream of the end of the chunk */
+        uint64_t end;
+        chrono::steady_clock::time_point time;
+    };
+
+    deque<Read> m_reads;
+    uint64_t m_received = 0;
+
+public:
+    void writeData(uint8_t const*, size_t) override {
+    }
+
+    void readData(uint8_t const*, size_t size) override {
+        m_received += size;
+        m_reads.push_back(Read{m_received, chrono::steady_clock::now()});
+    }
+
+    /** The time at which the byte at the given offset in the stream was read
+     *
+     * The reads before it are forgotten, so offsets must not decrease
+     */
+    chrono::steady_clock::time_point getArrivalTime(uint64_t offset) {
+        while (m_reads.size() > 1 && m_reads.front().end <= offset) {
+            m_reads.pop_front();
+        }
+        return m_reads.empty() ? chrono::steady_clock::now() : m_reads.front().time;
+    }
+};
+
+int stats(Driver& driver) {
+    AIS ais(driver);
+    StatisticsPrinter printer;
+    ArrivalListener arrivals;
+    driver.addListener(&arrivals);
+
+    uint8_t buffer[MAX_PACKET_SIZE];
+    while (true) {
+        int size = driver.readPacket(buffer, MAX_PACKET_SIZE);
+        auto decode_start = chrono::steady_clock::now();
+        // The framing consumed the stream up to the end of this sentence
+        auto status = driver.getStatus();
+        auto arrival = arrivals.getArrivalTime(status.good_rx + status.bad_rx - 1);
+
+        unique_ptr<nmea::sentence> sentence;
+        unique_ptr<ais::message> message;
+        bool parse_error = false;
+        try {
+            sentence = Driver::parseSentence(buffer, size);
+            message = ais.processSentence(*sentence);
+        }
+        catch (MarnavParsingError const&) {
+            parse_error = true;
+        }
+        auto decode_end = chrono::steady_clock::now();
+        double latency = chrono::duration<double>(decode_end - arrival).count();
+        double decode_time = chrono::duration<double>(decode_end - decode_start).count();
+
+        printer.update([&](LiveStatistics& shared) {
+            if (parse_error) {
+                shared.parse_errors++;
+            }
+            if (sentence) {
+                shared.sentences[sentence->tag()]++;
+            }
+            if (message) {
+                shared.messages[ais::to_name(message->type())]++;
+            }
+            shared.latencies.push_back(latency);
+            shared.decode_times.push_back(decode_time);
+            shared.cumulative_bytes = status.good_rx + status.bad_rx;
+            shared.cumulative_checksum_errors = driver.getChecksumErrorCount();
+            shared.cumulative_discarded_fragments = ais.getDiscardedSentenceCount();
+        });
+    }
+}
+
+int publish(Driver& driver, string const& name) {
+    SharedSamplePublisher publisher(name);
+    AIS ais(driver);
+    // Reused for every sentence, so that parsing does not allocate
+    FramedSentence sentence;
+    AIS::Payloads payloads;
+    GPS::RMC rmc;
+    GPS::GSA last_gsa;
+    bool has_gsa = false;
+    while (true) {
+        unique_ptr<ais::message> message;
+        try {
+            driver.readSentence(sentence);
+            if (GPS::parseGSA(sentence.data, sentence.size, last_gsa)) {
+                has_gsa = true;
+                continue;
+            }
+            else if (GPS::parseRMC(sentence.data, sentence.size, rmc)) {
+                if (has_gsa) {
+                    publisher.publish(GPS::getSolution(rmc, last_gsa));
+                }
+                continue;
+            }
+            else if (ais.reassemble(sentence.data, sentence.size, payloads)) {
+                message = AIS::decodePayloads(payloads);
+            }
+        }
+        catch (MarnavParsingError const&) {
+            continue;
+        }
+
+        if (!message) {
+            continue;
+        }
+        // Types 2 and 3 derive from message_01 in marnav
+        else if (auto position = dynamic_cast<ais::message_01 const*>(message.get())) {
+            publisher.publish(AIS::getPosition(*position));
+        }
+        else if (message->type() == ais::message_id::static_and_voyage_related_data) {
+            publisher.publish(AIS::getVesselInformation(
+                *ais::message_cast<ais::message_05>(message.get())));
+        }
+        else if (message->type() == ais::message_id::static_data_report) {
+            ais_base::VesselInformation info;
+            if (ais.processStaticDataReport(
+                    *ais::message_cast<ais::message_24>(message.get()), info)) {
+                publisher.publish(info);
+            }
+        }
+    }
+}
+
 int main(int argc, char** argv) {
     if (argc < 3) {
         usage(cerr);
@@ -25,6 +400,12 @@ int main(int argc, char** argv) {
     string uri(argv[1]);
     string cmd(argv[2]);
 
+    if (cmd == "replay") {
+        int baudrate = argc > 3 ? stoi(argv[3]) : 0;
+        double speedup = argc > 4 ? stod(argv[4]) : 1;
+        return replay(uri, baudrate, speedup);
+    }
+
     Driver driver;
     driver.openURI(uri);
     driver.setReadTimeout(base::Time::fromSeconds(3600));
@@ -42,5 +423,29 @@ int main(int argc, char** argv) {
             cout << base::Time::now() << " " << ais::to_name(message->type()) << std::endl;
         }
     }
+    else if (cmd == "stats") {
+        return stats(driver);
+    }
+    else if (cmd == "publish") {
+        if (argc < 4) {
+            usage(cerr);
+            return 1;
+        }
+        return publish(driver, argv[3]);
+    }
+    else if (cmd == "capture") {
+        if (argc < 4) {
+            usage(cerr);
+            return 1;
+        }
+        CaptureWriter writer(argv[3]);
+        CaptureListener listener(writer, 0);
+        driver.addListener(&listener);
+        uint8_t buffer[MAX_PACKET_SIZE];
+        while (true) {
+            driver.readPacket(buffer, MAX_PACKET_SIZE);
+            writer.flush();
+        }
+    }
 
 }
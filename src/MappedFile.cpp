@@ -0,0 +1,62 @@
+#include <nmea0183/MappedFile.hpp>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+MappedFile::MappedFile(string const& path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw system_error(errno, system_category(), "cannot open " + path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        int error = errno;
+        ::close(fd);
+        throw system_error(error, system_category(), "cannot stat " + path);
+    }
+
+    m_size = info.st_size;
+    if (m_size > 0) {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw system_error(error, system_category(), "cannot map " + path);
+        }
+        m_data = static_cast<uint8_t const*>(data);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data) {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+}
+
+uint8_t const* MappedFile::data() const
+{
+    return m_data;
+}
+
+size_t MappedFile::size() const
+{
+    return m_size;
+}
+
+void MappedFile::adviseSequential()
+{
+    if (m_data) {
+        madvise(const_cast<uint8_t*>(m_data), m_size, MADV_SEQUENTIAL);
+    }
+}
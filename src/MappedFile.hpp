@@ -0,0 +1,30 @@
+#ifndef NMEA0183_MAPPED_FILE_HPP
+#define NMEA0183_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace nmea0183 {
+    /** Read-only memory mapping of a whole file */
+    class MappedFile {
+        uint8_t const* m_data = nullptr;
+        size_t m_size = 0;
+
+    public:
+        /** @throw std::system_error if the file cannot be opened or mapped */
+        explicit MappedFile(std::string const& path);
+        ~MappedFile();
+
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        uint8_t const* data() const;
+        size_t size() const;
+
+        /** Tell the kernel that the file will be read sequentially */
+        void adviseSequential();
+    };
+}
+
+#endif
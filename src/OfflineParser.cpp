@@ -0,0 +1,290 @@
+#include <nmea0183/OfflineParser.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <marnav/nmea/vdm.hpp>
+#include <mutex>
+#include <nmea0183/AIS.hpp>
+#include <nmea0183/Driver.hpp>
+#include <nmea0183/Exceptions.hpp>
+#include <thread>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+
+struct OfflineParser::Chunk {
+    size_t begin = 0;
+    size_t end = 0;
+    vector<OfflineEntry> entries;
+
+    /** Whether the chunk contains the first fragment of an AIS message
+     *
+     * The reassembly state after such a fragment does not depend on what
+     * came before. The chunk-local reassembly starts there.
+     */
+    bool has_message_start = false;
+    /** Indexes of the VDM entries before the first message start
+     *
+     * They may be the continuation of a message started in a previous chunk
+     */
+    vector<size_t> head;
+    /** Indexes of the VDM entries of the message that is still being
+     * reassembled at the end of the chunk
+     */
+    vector<size_t> tail;
+
+    OfflineStatistics stats;
+};
+
+OfflineParser::OfflineParser(string const& path)
+    : m_file(path)
+    , m_thread_count(max(1u, thread::hardware_concurrency()))
+{
+    m_file.adviseSequential();
+}
+
+void OfflineParser::setThreadCount(size_t count)
+{
+    m_thread_count = max<size_t>(1, count);
+}
+
+void OfflineParser::setChunkSize(size_t size)
+{
+    m_chunk_size = max<size_t>(1, size);
+}
+
+vector<size_t> OfflineParser::computeChunkBoundaries() const
+{
+    uint8_t const* data = m_file.data();
+    size_t size = m_file.size();
+
+    vector<size_t> boundaries{0};
+    size_t pos = m_chunk_size;
+    while (pos < size) {
+        // Move to the beginning of the next line. pos itself if it is
+        // already at the beginning of a line
+        void const* eol = memchr(data + pos - 1, '\n', size - pos + 1);
+        if (!eol) {
+            break;
+        }
+        size_t line_start = static_cast<uint8_t const*>(eol) - data + 1;
+        if (line_start >= size) {
+            break;
+        }
+        boundaries.push_back(line_start);
+        pos = line_start + m_chunk_size;
+    }
+    boundaries.push_back(size);
+    return boundaries;
+}
+
+void OfflineParser::processChunk(Chunk& chunk) const
+{
+    uint8_t const* data = m_file.data();
+    AIS ais;
+    uint32_t checksum_errors = 0;
+
+    size_t pos = chunk.begin;
+    while (pos < chunk.end) {
+        // Bound the framing window, otherwise every '$' not followed by a
+        // CR/LF (e.g. in LF-only logs) makes extractSentence scan the rest
+        // of the chunk
+        size_t window = min<size_t>(chunk.end - pos, Driver::MAX_PACKET_LENGTH);
+        int size = Driver::extractSentence(data + pos, window, &checksum_errors);
+        if (size == 0 && window < chunk.end - pos) {
+            // No complete sentence fits in the window
+            size = -1;
+        }
+        if (size == 0) {
+            // Truncated sentence at the end of the file
+            chunk.stats.rejected_bytes += chunk.end - pos;
+            break;
+        }
+        else if (size < 0) {
+            chunk.stats.rejected_bytes += -size;
+            pos += -size;
+            continue;
+        }
+
+        OfflineEntry entry;
+        entry.offset = pos;
+        pos += size;
+        try {
+            entry.sentence = Driver::parseSentence(data + entry.offset, size);
+        }
+        catch (MarnavParsingError const&) {
+            chunk.stats.parse_errors++;
+            continue;
+        }
+        chunk.stats.sentences++;
+
+        size_t index = chunk.entries.size();
+        if (entry.sentence->id() == nmea::sentence_id::VDM) {
+            auto vdm = nmea::sentence_cast<nmea::vdm>(entry.sentence.get());
+            if (!chunk.has_message_start && vdm->get_fragment() != 1) {
+                chunk.head.push_back(index);
+            }
+            else {
+                chunk.has_message_start = true;
+                try {
+                    entry.message = ais.processSentence(*entry.sentence);
+                }
+                catch (MarnavParsingError const&) {
+                    chunk.stats.parse_errors++;
+                }
+                if (entry.message) {
+                    chunk.stats.messages++;
+                }
+
+                size_t pending = ais.getPendingFragmentCount();
+                if (pending <= 1) {
+                    chunk.tail.clear();
+                }
+                if (pending > 0) {
+                    chunk.tail.push_back(index);
+                }
+            }
+        }
+        chunk.entries.push_back(move(entry));
+    }
+
+    chunk.stats.checksum_errors = checksum_errors;
+    chunk.stats.discarded_fragments = ais.getDiscardedSentenceCount();
+}
+
+static void addStatistics(OfflineStatistics& total, OfflineStatistics const& stats)
+{
+    total.sentences += stats.sentences;
+    total.messages += stats.messages;
+    total.rejected_bytes += stats.rejected_bytes;
+    total.checksum_errors += stats.checksum_errors;
+    total.parse_errors += stats.parse_errors;
+    total.discarded_fragments += stats.discarded_fragments;
+}
+
+OfflineStatistics OfflineParser::process(Callback callback)
+{
+    auto boundaries = computeChunkBoundaries();
+    size_t chunk_count = boundaries.size() - 1;
+    size_t window = 2 * m_thread_count;
+
+    mutex lock;
+    condition_variable signal;
+    vector<unique_ptr<Chunk>> chunks(chunk_count);
+    size_t next_chunk = 0;
+    size_t delivered = 0;
+    bool stop = false;
+    exception_ptr error;
+
+    auto worker = [&]() {
+        while (true) {
+            size_t index;
+            {
+                unique_lock<mutex> guard(lock);
+                signal.wait(guard, [&] {
+                    return stop || next_chunk >= chunk_count ||
+                           next_chunk < delivered + window;
+                });
+                if (stop || next_chunk >= chunk_count) {
+                    return;
+                }
+                index = next_chunk++;
+            }
+
+            unique_ptr<Chunk> chunk(new Chunk);
+            chunk->begin = boundaries[index];
+            chunk->end = boundaries[index + 1];
+            try {
+                processChunk(*chunk);
+            }
+            catch (...) {
+                lock_guard<mutex> guard(lock);
+                error = current_exception();
+                stop = true;
+                signal.notify_all();
+                return;
+            }
+
+            lock_guard<mutex> guard(lock);
+            chunks[index] = move(chunk);
+            signal.notify_all();
+        }
+    };
+
+    // Make sure the threads are stopped and joined whichever way we leave
+    // this method, including through an exception in the callback
+    struct Workers {
+        mutex& lock;
+        condition_variable& signal;
+        bool& stop;
+        vector<thread> threads;
+
+        ~Workers()
+        {
+            {
+                lock_guard<mutex> guard(lock);
+                stop = true;
+            }
+            signal.notify_all();
+            for (auto& t : threads) {
+                t.join();
+            }
+        }
+    } workers{lock, signal, stop, {}};
+    for (size_t i = 0; i < min(m_thread_count, chunk_count); ++i) {
+        workers.threads.emplace_back(worker);
+    }
+
+    OfflineStatistics total;
+    // Reassembly of the messages that cross chunk boundaries
+    AIS boundary;
+    for (size_t i = 0; i < chunk_count; ++i) {
+        unique_ptr<Chunk> chunk;
+        {
+            unique_lock<mutex> guard(lock);
+            signal.wait(guard, [&] { return chunks[i] || error; });
+            if (error) {
+                rethrow_exception(error);
+            }
+            chunk = move(chunks[i]);
+        }
+
+        for (size_t index : chunk->head) {
+            auto& entry = chunk->entries[index];
+            try {
+                entry.message = boundary.processSentence(*entry.sentence);
+            }
+            catch (MarnavParsingError const&) {
+                chunk->stats.parse_errors++;
+            }
+            if (entry.message) {
+                chunk->stats.messages++;
+            }
+        }
+        if (chunk->has_message_start) {
+            // A single reassembly would discard the pending fragments when
+            // receiving this chunk's message start
+            total.discarded_fragments += boundary.getDiscardedSentenceCount() +
+                                         boundary.getPendingFragmentCount();
+            boundary = AIS();
+            for (size_t index : chunk->tail) {
+                boundary.processSentence(*chunk->entries[index].sentence);
+            }
+        }
+        addStatistics(total, chunk->stats);
+
+        for (auto& entry : chunk->entries) {
+            callback(entry);
+        }
+
+        {
+            lock_guard<mutex> guard(lock);
+            delivered = i + 1;
+        }
+        signal.notify_all();
+    }
+    total.discarded_fragments += boundary.getDiscardedSentenceCount();
+    return total;
+}
@@ -0,0 +1,75 @@
+#ifndef NMEA0183_OFFLINE_PARSER_HPP
+#define NMEA0183_OFFLINE_PARSER_HPP
+
+#include <functional>
+#include <marnav/ais/message.hpp>
+#include <marnav/nmea/sentence.hpp>
+#include <memory>
+#include <nmea0183/MappedFile.hpp>
+#include <string>
+
+namespace nmea0183 {
+    /** One sentence decoded by OfflineParser */
+    struct OfflineEntry {
+        /** Offset of the sentence's first byte in the file */
+        uint64_t offset = 0;
+        std::unique_ptr<marnav::nmea::sentence> sentence;
+        /** The AIS message this sentence completed, if there is one */
+        std::unique_ptr<marnav::ais::message> message;
+    };
+
+    struct OfflineStatistics {
+        uint64_t sentences = 0;
+        uint64_t messages = 0;
+        /** Bytes that were not part of a valid sentence */
+        uint64_t rejected_bytes = 0;
+        uint64_t checksum_errors = 0;
+        uint64_t parse_errors = 0;
+        uint64_t discarded_fragments = 0;
+    };
+
+    /**
+     * Parallel decoding of NMEA log files
+     *
+     * The file is memory-mapped and split in chunks that start at the
+     * beginning of a line. Each chunk is framed, parsed and AIS-reassembled by
+     * a pool of threads. The results are then handed over in file order.
+     *
+     * AIS fragments that are split across two chunks are reassembled while
+     * merging the chunks, so the result is the same as feeding the whole file
+     * to a single Driver and AIS.
+     */
+    class OfflineParser {
+    public:
+        typedef std::function<void(OfflineEntry& entry)> Callback;
+
+    private:
+        struct Chunk;
+
+        MappedFile m_file;
+        size_t m_thread_count;
+        size_t m_chunk_size = 4 * 1024 * 1024;
+
+        std::vector<size_t> computeChunkBoundaries() const;
+        void processChunk(Chunk& chunk) const;
+
+    public:
+        explicit OfflineParser(std::string const& path);
+
+        /** Set the number of worker threads. Defaults to the number of cores */
+        void setThreadCount(size_t count);
+
+        /** Set the nominal size of a chunk, in bytes. Defaults to 4MB */
+        void setChunkSize(size_t size);
+
+        /** Decode the whole file
+         *
+         * The callback is called from the calling thread, in file order, once
+         * for each sentence that could be parsed. At most twice as many chunks
+         * as there are threads are held in memory at any given time.
+         */
+        OfflineStatistics process(Callback callback);
+    };
+}
+
+#endif
@@ -0,0 +1,336 @@
+#ifndef NMEA0183_SPSC_QUEUE_HPP
+#define NMEA0183_SPSC_QUEUE_HPP
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace nmea0183 {
+    /** What SPSCQueue does when a push is attempted on a full queue */
+    enum SPSCOverflowPolicy {
+        /** The pushed value is discarded and counted as dropped */
+        SPSC_DROP_NEWEST,
+        /** The producer waits until the consumer frees a slot */
+        SPSC_BLOCK
+    };
+
+    /**
+     * Lock-free single-producer / single-consumer ring buffer
+     *
+     * The slots are allocated once at construction. Values can either be
+     * moved in and out with push() and pop(), or be filled and read in place
+     * with beginPush() / commitPush() and front() / release(), which avoids
+     * any allocation or copy on the hot path. This is meant to hand over
+     * FramedSentence, or decoded samples such as ais_base::Position, from a
+     * reading thread to a processing thread.
+     *
+     * Exactly one thread may call the producer methods and exactly one
+     * thread the consumer methods. The waiting methods sleep on an eventfd,
+     * which the other side only signals when it is known to be waiting.
+     */
+    template <typename T> class SPSCQueue {
+        static constexpr size_t CACHE_LINE = 64;
+
+        std::unique_ptr<T[]> m_slots;
+        size_t m_mask;
+        SPSCOverflowPolicy m_policy;
+        int m_data_fd = -1;
+        int m_space_fd = -1;
+
+        // Consumer side
+        alignas(CACHE_LINE) std::atomic<size_t> m_head{0};
+        size_t m_cached_tail = 0;
+        std::atomic<bool> m_consumer_waiting{false};
+
+        // Producer side
+        alignas(CACHE_LINE) std::atomic<size_t> m_tail{0};
+        size_t m_cached_head = 0;
+        std::atomic<bool> m_producer_waiting{false};
+        std::atomic<uint64_t> m_dropped{0};
+
+        alignas(CACHE_LINE) std::atomic<bool> m_closed{false};
+
+        static size_t roundCapacity(size_t capacity)
+        {
+            size_t result = 1;
+            while (result < capacity) {
+                result <<= 1;
+            }
+            return result;
+        }
+
+        static void signal(int fd)
+        {
+            uint64_t one = 1;
+            while (::write(fd, &one, sizeof(one)) < 0 && errno == EINTR) {
+            }
+        }
+
+        /** Wait until fd is signalled or the timeout (in ms, negative for
+         * infinite) expires, and reset it
+         */
+        static void wait(int fd, int timeout)
+        {
+            pollfd pfd = {fd, POLLIN, 0};
+            int ret = ::poll(&pfd, 1, timeout);
+            if (ret < 0 && errno != EINTR) {
+                throw std::system_error(errno, std::system_category(), "poll failed");
+            }
+            uint64_t count;
+            while (::read(fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+            }
+        }
+
+        bool hasSpace()
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cached_head <= m_mask) {
+                return true;
+            }
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            return tail - m_cached_head <= m_mask;
+        }
+
+        bool hasData()
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (head != m_cached_tail) {
+                return true;
+            }
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            return head != m_cached_tail;
+        }
+
+        /** Wait for the condition, using flag to tell the other side that it
+         * must signal fd
+         *
+         * The flag store and the condition check are ordered by a full
+         * fence, matching the one in the other side's notify. Either this
+         * side sees the change, or the other side sees the flag.
+         */
+        template <typename Condition>
+        bool waitFor(Condition condition, std::atomic<bool>& flag, int fd, int timeout)
+        {
+            if (condition()) {
+                return true;
+            }
+
+            auto deadline =
+                std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+            flag.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            bool result = condition();
+            while (!result && !m_closed.load(std::memory_order_relaxed)) {
+                int remaining = -1;
+                if (timeout >= 0) {
+                    auto now = std::chrono::steady_clock::now();
+                    if (now >= deadline) {
+                        break;
+                    }
+                    auto left = deadline - now + std::chrono::microseconds(999);
+                    remaining =
+                        std::chrono::duration_cast<std::chrono::milliseconds>(left).count();
+                }
+                wait(fd, remaining);
+                result = condition();
+            }
+            flag.store(false, std::memory_order_relaxed);
+            return result;
+        }
+
+        void notify(std::atomic<bool>& flag, int fd)
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (flag.load(std::memory_order_relaxed)) {
+                signal(fd);
+            }
+        }
+
+    public:
+        /**
+         * @param capacity the minimum number of slots. It is rounded up to
+         *   the next power of two
+         * @param policy what push() does when the queue is full
+         */
+        explicit SPSCQueue(size_t capacity, SPSCOverflowPolicy policy = SPSC_DROP_NEWEST)
+            : m_slots(new T[roundCapacity(capacity)])
+            , m_mask(roundCapacity(capacity) - 1)
+            , m_policy(policy)
+        {
+            m_data_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            m_space_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (m_data_fd < 0 || m_space_fd < 0) {
+                int error = errno;
+                if (m_data_fd >= 0) {
+                    ::close(m_data_fd);
+                }
+                throw std::system_error(error, std::system_category(),
+                    "failed to create eventfd");
+            }
+        }
+
+        ~SPSCQueue()
+        {
+            ::close(m_data_fd);
+            ::close(m_space_fd);
+        }
+
+        SPSCQueue(SPSCQueue const&) = delete;
+        SPSCQueue& operator=(SPSCQueue const&) = delete;
+
+        size_t capacity() const
+        {
+            return m_mask + 1;
+        }
+
+        /** Number of values currently queued. Only approximate when called
+         * while the other side is active
+         */
+        size_t size() const
+        {
+            return m_tail.load(std::memory_order_acquire) -
+                   m_head.load(std::memory_order_acquire);
+        }
+
+        /** Number of values discarded because of SPSC_DROP_NEWEST */
+        uint64_t getDroppedCount() const
+        {
+            return m_dropped.load(std::memory_order_relaxed);
+        }
+
+        /** File descriptor that becomes readable when data is pushed while
+         * the consumer waits. Only meaningful for the wait* methods
+         */
+        int getFileDescriptor() const
+        {
+            return m_data_fd;
+        }
+
+        /** Wake up both sides and make all waits return immediately
+         *
+         * This is meant to stop the threads. The values already in the queue
+         * can still be consumed
+         */
+        void close()
+        {
+            m_closed.store(true);
+            signal(m_data_fd);
+            signal(m_space_fd);
+        }
+
+        bool isClosed() const
+        {
+            return m_closed.load();
+        }
+
+        /** Producer: get the next free slot to fill it in place
+         *
+         * With SPSC_BLOCK, this waits for a free slot. Otherwise, or if the
+         * queue gets closed, it returns nullptr when the queue is full, and
+         * counts the value as dropped.
+         */
+        T* beginPush()
+        {
+            if (!hasSpace()) {
+                bool found = m_policy == SPSC_BLOCK && waitForSpace(-1);
+                if (!found) {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+            }
+            return &m_slots[m_tail.load(std::memory_order_relaxed) & m_mask];
+        }
+
+        /** Producer: publish the slot returned by beginPush */
+        void commitPush()
+        {
+            m_tail.store(m_tail.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+            notify(m_consumer_waiting, m_data_fd);
+        }
+
+        /** Producer: move a value into the queue
+         *
+         * @return false if the value was dropped
+         */
+        bool push(T&& value)
+        {
+            T* slot = beginPush();
+            if (!slot) {
+                return false;
+            }
+            *slot = std::move(value);
+            commitPush();
+            return true;
+        }
+
+        /** Producer: wait until there is at least one free slot
+         *
+         * @param timeout in milliseconds, negative to wait until a slot is
+         *   freed or the queue is closed
+         * @return true if there is a free slot
+         */
+        bool waitForSpace(int timeout)
+        {
+            return waitFor(
+                [this] { return hasSpace(); }, m_producer_waiting, m_space_fd, timeout);
+        }
+
+        /** Consumer: the oldest queued value, or nullptr if the queue is
+         * empty
+         *
+         * The value stays valid and in place until release() is called
+         */
+        T* front()
+        {
+            if (!hasData()) {
+                return nullptr;
+            }
+            return &m_slots[m_head.load(std::memory_order_relaxed) & m_mask];
+        }
+
+        /** Consumer: free the slot returned by front() */
+        void release()
+        {
+            m_head.store(m_head.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+            notify(m_producer_waiting, m_space_fd);
+        }
+
+        /** Consumer: move the oldest value out of the queue
+         *
+         * @return false if the queue is empty
+         */
+        bool pop(T& value)
+        {
+            T* slot = front();
+            if (!slot) {
+                return false;
+            }
+            value = std::move(*slot);
+            release();
+            return true;
+        }
+
+        /** Consumer: wait until there is at least one value in the queue
+         *
+         * @param timeout in milliseconds, negative to wait until data arrives
+         *   or the queue is closed
+         * @return true if there is data
+         */
+        bool waitForData(int timeout)
+        {
+            return waitFor(
+                [this] { return hasData(); }, m_consumer_waiting, m_data_fd, timeout);
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,105 @@
+#include <nmea0183/SentenceDispatcher.hpp>
+
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+
+SentenceDispatcher::SentenceDispatcher()
+    : m_table(TABLE_SIZE, NO_HANDLER)
+{
+}
+
+int SentenceDispatcher::tagIndex(string_view tag)
+{
+    if (tag.size() != 3) {
+        return -1;
+    }
+    return tagIndex(tag.data());
+}
+
+void SentenceDispatcher::setHandler(int index, Handler handler)
+{
+    uint16_t& entry = m_table[index];
+    if (entry != NO_HANDLER) {
+        m_handlers[entry - 1] = handler;
+        return;
+    }
+
+    m_handlers.push_back(handler);
+    entry = m_handlers.size();
+}
+
+void SentenceDispatcher::on(string_view tag, Handler handler)
+{
+    int index = tagIndex(tag);
+    if (index < 0) {
+        throw invalid_argument("invalid sentence tag '" + string(tag) + "'");
+    }
+    setHandler(index, handler);
+}
+
+void SentenceDispatcher::remove(string_view tag)
+{
+    int index = tagIndex(tag);
+    if (index < 0 || m_table[index] == NO_HANDLER) {
+        return;
+    }
+
+    // Keep the slot to not invalidate the other entries, but release
+    // whatever the handler holds
+    m_handlers[m_table[index] - 1] = Handler();
+    m_table[index] = NO_HANDLER;
+}
+
+bool SentenceDispatcher::handles(uint8_t const* buffer, size_t size) const
+{
+    int index = tagIndex(Driver::peekSentenceTag(buffer, size));
+    return index >= 0 && m_table[index] != NO_HANDLER;
+}
+
+bool SentenceDispatcher::dispatch(uint8_t const* buffer, size_t size)
+{
+    int index = tagIndex(Driver::peekSentenceTag(buffer, size));
+    uint16_t entry = index < 0 ? NO_HANDLER : m_table[index];
+    if (entry == NO_HANDLER) {
+        m_unhandled_count++;
+        return false;
+    }
+
+    auto sentence = Driver::parseSentence(buffer, size);
+    m_handlers[entry - 1](*sentence);
+    return true;
+}
+
+bool SentenceDispatcher::dispatch(FramedSentence const& sentence)
+{
+    return dispatch(sentence.data, sentence.size);
+}
+
+bool SentenceDispatcher::dispatch(nmea::sentence const& sentence)
+{
+    int index = tagIndex(sentence.tag());
+    uint16_t entry = index < 0 ? NO_HANDLER : m_table[index];
+    if (entry == NO_HANDLER) {
+        m_unhandled_count++;
+        return false;
+    }
+
+    m_handlers[entry - 1](sentence);
+    return true;
+}
+
+bool SentenceDispatcher::readSentence(Driver& driver)
+{
+    uint8_t buffer[Driver::BUFFER_SIZE];
+    int size = driver.readSentencePacket(buffer, Driver::BUFFER_SIZE);
+    return dispatch(buffer, size);
+}
+
+uint64_t SentenceDispatcher::getUnhandledCount() const
+{
+    return m_unhandled_count;
+}
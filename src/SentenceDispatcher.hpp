@@ -0,0 +1,121 @@
+#ifndef NMEA0183_SENTENCE_DISPATCHER_HPP
+#define NMEA0183_SENTENCE_DISPATCHER_HPP
+
+#include <functional>
+#include <marnav/nmea/sentence.hpp>
+#include <nmea0183/Driver.hpp>
+#include <string_view>
+#include <vector>
+
+namespace nmea0183 {
+    /**
+     * Calls typed handlers for the sentences, based on their tag
+     *
+     * Handlers are registered per marnav sentence class:
+     *
+     * ~~~ cpp
+     * SentenceDispatcher dispatcher;
+     * dispatcher.on<marnav::nmea::rmc>([](marnav::nmea::rmc const& rmc) {
+     *     ...
+     * });
+     * dispatcher.readSentence(driver);
+     * ~~~
+     *
+     * The tag of a framed sentence is looked up in a table indexed by its
+     * three letters, before the sentence gets parsed. Sentences that have no
+     * handler are never parsed.
+     */
+    class SentenceDispatcher {
+    public:
+        typedef std::function<void(marnav::nmea::sentence const&)> Handler;
+
+    private:
+        static constexpr size_t TABLE_SIZE = 26 * 26 * 26;
+        static constexpr uint16_t NO_HANDLER = 0;
+
+        /** Index in m_handlers, plus one, of the handler for each tag */
+        std::vector<uint16_t> m_table;
+        std::vector<Handler> m_handlers;
+        uint64_t m_unhandled_count = 0;
+
+        static constexpr int letterIndex(char c)
+        {
+            return c >= 'A' && c <= 'Z' ? c - 'A' : -1;
+        }
+
+        void setHandler(int index, Handler handler);
+
+    public:
+        SentenceDispatcher();
+
+        /** Index of a tag in the dispatch table, or -1 if it is not made of
+         * three uppercase letters
+         */
+        static constexpr int tagIndex(char const* tag)
+        {
+            int a = letterIndex(tag[0]);
+            int b = a < 0 ? -1 : letterIndex(tag[1]);
+            int c = b < 0 ? -1 : letterIndex(tag[2]);
+            return c < 0 ? -1 : (a * 26 + b) * 26 + c;
+        }
+
+        static int tagIndex(std::string_view tag);
+
+        /** Register the handler for the sentences of type T
+         *
+         * The handler is called with a T const&. It replaces any handler
+         * previously registered for the same tag.
+         */
+        template <typename T, typename F> void on(F handler)
+        {
+            constexpr int index = tagIndex(T::TAG);
+            static_assert(index >= 0, "sentence tag must be three uppercase letters");
+            setHandler(index, [handler](marnav::nmea::sentence const& sentence) {
+                handler(static_cast<T const&>(sentence));
+            });
+        }
+
+        /** Register an untyped handler for the given tag
+         *
+         * @throw std::invalid_argument if the tag is not made of three
+         *   uppercase letters
+         */
+        void on(std::string_view tag, Handler handler);
+
+        /** Remove the handler of the given tag, if there is one */
+        void remove(std::string_view tag);
+
+        /** Whether a framed sentence has a handler */
+        bool handles(uint8_t const* buffer, size_t size) const;
+
+        /** Parse a framed sentence and call its handler
+         *
+         * @return false if there is no handler for this sentence, in which
+         *   case it is not parsed
+         * @throw MarnavParsingError if the sentence cannot be parsed
+         */
+        bool dispatch(uint8_t const* buffer, size_t size);
+
+        /** @overload */
+        bool dispatch(FramedSentence const& sentence);
+
+        /** Call the handler of an already parsed sentence
+         *
+         * @return false if there is no handler for this sentence
+         */
+        bool dispatch(marnav::nmea::sentence const& sentence);
+
+        /** Read and dispatch one sentence from the driver
+         *
+         * Sentences dropped by the driver's decimator are skipped
+         *
+         * @return whether the sentence had a handler
+         */
+        bool readSentence(Driver& driver);
+
+        /** Count of sentences that were dispatched without a handler */
+        uint64_t getUnhandledCount() const;
+    };
+}
+
+#endif
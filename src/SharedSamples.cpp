@@ -0,0 +1,287 @@
+#include <nmea0183/SharedSamples.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+static const char SHARED_SAMPLES_MAGIC[8] = {'N', 'M', 'E', 'A', 'S', 'H', 'M', '1'};
+static const uint32_t SHARED_SAMPLES_VERSION = 1;
+static const size_t SAMPLE_WORDS = sizeof(SharedSample) / sizeof(uint64_t);
+
+static_assert(atomic<uint64_t>::is_always_lock_free, "64-bit atomics are required");
+
+namespace nmea0183 {
+    struct SharedSampleHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t slot_count;
+        uint32_t slot_size;
+        uint32_t reserved;
+        /** Number of samples published so far. On its own cache line, as
+         * it is polled by all readers
+         */
+        alignas(64) atomic<uint64_t> head;
+    };
+
+    /** A ring slot, protected by a seqlock
+     *
+     * The sequence is odd while the slot is being written. The sample is
+     * stored as relaxed atomic words, so that concurrent reads of a slot
+     * being written are well-defined, and detected by the sequence check.
+     */
+    struct alignas(64) SharedSampleSlot {
+        atomic<uint32_t> sequence;
+        uint32_t reserved;
+        atomic<uint64_t> words[SAMPLE_WORDS];
+    };
+}
+
+static size_t getSegmentSize(uint32_t slot_count)
+{
+    return sizeof(SharedSampleHeader) + slot_count * sizeof(SharedSampleSlot);
+}
+
+static SharedSampleSlot* getSlots(void* segment)
+{
+    return reinterpret_cast<SharedSampleSlot*>(
+        static_cast<uint8_t*>(segment) + sizeof(SharedSampleHeader));
+}
+
+SharedSamplePublisher::SharedSamplePublisher(string const& name, uint32_t slot_count)
+    : m_name(name)
+{
+    if (slot_count == 0) {
+        throw invalid_argument("SharedSamplePublisher: slot count must be strictly positive");
+    }
+
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        throw system_error(errno, system_category(), "cannot create " + name);
+    }
+
+    m_size = getSegmentSize(slot_count);
+    if (ftruncate(fd, m_size) < 0) {
+        int error = errno;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        throw system_error(error, system_category(), "cannot resize " + name);
+    }
+    void* segment = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        int error = errno;
+        shm_unlink(name.c_str());
+        throw system_error(error, system_category(), "cannot map " + name);
+    }
+
+    // The segment is zero-filled, i.e. all slots have an even sequence and
+    // the head is at zero. The magic is written last, once the header is
+    // complete
+    m_header = new (segment) SharedSampleHeader();
+    m_header->version = SHARED_SAMPLES_VERSION;
+    m_header->slot_count = slot_count;
+    m_header->slot_size = sizeof(SharedSampleSlot);
+    m_slots = getSlots(segment);
+    atomic_thread_fence(memory_order_release);
+    memcpy(m_header->magic, SHARED_SAMPLES_MAGIC, sizeof(SHARED_SAMPLES_MAGIC));
+}
+
+SharedSamplePublisher::~SharedSamplePublisher()
+{
+    munmap(m_header, m_size);
+    shm_unlink(m_name.c_str());
+}
+
+void SharedSamplePublisher::publish(SharedSample& sample)
+{
+    uint64_t index = m_header->head.load(memory_order_relaxed);
+    sample.index = index;
+    uint64_t words[SAMPLE_WORDS];
+    memcpy(words, &sample, sizeof(sample));
+
+    SharedSampleSlot& slot = m_slots[index % m_header->slot_count];
+    uint32_t sequence = slot.sequence.load(memory_order_relaxed);
+    slot.sequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    for (size_t i = 0; i < SAMPLE_WORDS; ++i) {
+        slot.words[i].store(words[i], memory_order_relaxed);
+    }
+    slot.sequence.store(sequence + 2, memory_order_release);
+    m_header->head.store(index + 1, memory_order_release);
+}
+
+void SharedSamplePublisher::publish(gps_base::Solution const& solution)
+{
+    SharedSample sample = {};
+    sample.type = SHARED_SAMPLE_SOLUTION;
+    GNSSSolutionRecord& record = sample.solution;
+    record.time = solution.time.toMicroseconds();
+    record.latitude = solution.latitude;
+    record.longitude = solution.longitude;
+    record.altitude = solution.altitude;
+    record.geoidal_separation = solution.geoidalSeparation;
+    record.age_of_differential_corrections = solution.ageOfDifferentialCorrections;
+    record.deviation_latitude = solution.deviationLatitude;
+    record.deviation_longitude = solution.deviationLongitude;
+    record.deviation_altitude = solution.deviationAltitude;
+    record.position_type = solution.positionType;
+    record.satellite_count = solution.noOfSatellites;
+    publish(sample);
+}
+
+void SharedSamplePublisher::publish(ais_base::Position const& position)
+{
+    SharedSample sample = {};
+    sample.type = SHARED_SAMPLE_POSITION;
+    sample.target = AISTargetState::makeRecord(position.mmsi);
+    AISTargetState::updateRecord(sample.target, position);
+    publish(sample);
+}
+
+void SharedSamplePublisher::publish(ais_base::VesselInformation const& info)
+{
+    SharedSample sample = {};
+    sample.type = SHARED_SAMPLE_VESSEL_INFORMATION;
+    sample.target = AISTargetState::makeRecord(info.mmsi);
+    AISTargetState::updateRecord(sample.target, info);
+    publish(sample);
+}
+
+uint64_t SharedSamplePublisher::getPublishedCount() const
+{
+    return m_header->head.load(memory_order_relaxed);
+}
+
+SharedSampleReader::SharedSampleReader(string const& name)
+{
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw system_error(errno, system_category(), "cannot open " + name);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
+        int error = errno;
+        ::close(fd);
+        throw system_error(error, system_category(), "cannot stat " + name);
+    }
+    m_size = info.st_size;
+    if (m_size < sizeof(SharedSampleHeader)) {
+        ::close(fd);
+        throw invalid_argument(name + " is not a NMEA sample ring");
+    }
+
+    void* segment = mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (segment == MAP_FAILED) {
+        throw system_error(errno, system_category(), "cannot map " + name);
+    }
+
+    m_header = static_cast<SharedSampleHeader const*>(segment);
+    bool valid =
+        !memcmp(m_header->magic, SHARED_SAMPLES_MAGIC, sizeof(SHARED_SAMPLES_MAGIC));
+    atomic_thread_fence(memory_order_acquire);
+    valid = valid && m_header->version == SHARED_SAMPLES_VERSION &&
+            m_header->slot_size == sizeof(SharedSampleSlot) &&
+            m_header->slot_count > 0 &&
+            m_size >= getSegmentSize(m_header->slot_count);
+    if (!valid) {
+        munmap(segment, m_size);
+        throw invalid_argument(name + " is not a NMEA sample ring, or has an "
+                                      "incompatible version");
+    }
+
+    m_slots = getSlots(segment);
+    m_slot_count = m_header->slot_count;
+    m_next = m_header->head.load(memory_order_acquire);
+}
+
+SharedSampleReader::~SharedSampleReader()
+{
+    munmap(const_cast<SharedSampleHeader*>(m_header), m_size);
+}
+
+bool SharedSampleReader::read(SharedSample& sample)
+{
+    while (true) {
+        uint64_t head = m_header->head.load(memory_order_acquire);
+        if (m_next >= head) {
+            return false;
+        }
+        if (head - m_next > m_slot_count) {
+            m_lost += head - m_slot_count - m_next;
+            m_next = head - m_slot_count;
+        }
+
+        SharedSampleSlot const& slot = m_slots[m_next % m_slot_count];
+        uint32_t sequence = slot.sequence.load(memory_order_acquire);
+        uint64_t words[SAMPLE_WORDS];
+        for (size_t i = 0; i < SAMPLE_WORDS; ++i) {
+            words[i] = slot.words[i].load(memory_order_relaxed);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        bool consistent =
+            !(sequence & 1) && slot.sequence.load(memory_order_relaxed) == sequence;
+        if (consistent) {
+            memcpy(&sample, words, sizeof(sample));
+        }
+
+        // If the slot has been or is being overwritten by the publisher, the
+        // sample we're looking for is lost
+        if (!consistent || sample.index != m_next) {
+            m_lost++;
+            m_next++;
+            continue;
+        }
+        m_next++;
+        return true;
+    }
+}
+
+void SharedSampleReader::seekToOldest()
+{
+    uint64_t head = m_header->head.load(memory_order_acquire);
+    m_next = head > m_slot_count ? head - m_slot_count : 0;
+}
+
+uint64_t SharedSampleReader::getLostCount() const
+{
+    return m_lost;
+}
+
+gps_base::Solution SharedSample::getSolution() const
+{
+    gps_base::Solution result;
+    result.time = base::Time::fromMicroseconds(solution.time);
+    result.latitude = solution.latitude;
+    result.longitude = solution.longitude;
+    result.altitude = solution.altitude;
+    result.geoidalSeparation = solution.geoidal_separation;
+    result.ageOfDifferentialCorrections = solution.age_of_differential_corrections;
+    result.deviationLatitude = solution.deviation_latitude;
+    result.deviationLongitude = solution.deviation_longitude;
+    result.deviationAltitude = solution.deviation_altitude;
+    result.positionType = static_cast<gps_base::GPS_SOLUTION_TYPES>(solution.position_type);
+    result.noOfSatellites = solution.satellite_count;
+    return result;
+}
+
+ais_base::Position SharedSample::getPosition() const
+{
+    return AISTargetState::toPosition(target);
+}
+
+ais_base::VesselInformation SharedSample::getVesselInformation() const
+{
+    return AISTargetState::toVesselInformation(target);
+}
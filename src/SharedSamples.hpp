@@ -0,0 +1,149 @@
+#ifndef NMEA0183_SHARED_SAMPLES_HPP
+#define NMEA0183_SHARED_SAMPLES_HPP
+
+#include <ais_base/Position.hpp>
+#include <ais_base/VesselInformation.hpp>
+#include <gps_base/BaseTypes.hpp>
+#include <nmea0183/AISTargetState.hpp>
+#include <string>
+
+namespace nmea0183 {
+    /** Fixed-layout copy of a gps_base::Solution */
+    struct GNSSSolutionRecord {
+        /** Microseconds since the epoch */
+        int64_t time;
+        double latitude;
+        double longitude;
+        double altitude;
+        double geoidal_separation;
+        double age_of_differential_corrections;
+        double deviation_latitude;
+        double deviation_longitude;
+        double deviation_altitude;
+        int32_t position_type;
+        int32_t satellite_count;
+    };
+
+    enum SharedSampleType : uint32_t {
+        SHARED_SAMPLE_SOLUTION = 1,
+        /** An AISTargetRecord with only its position set */
+        SHARED_SAMPLE_POSITION = 2,
+        /** An AISTargetRecord with only its vessel information set */
+        SHARED_SAMPLE_VESSEL_INFORMATION = 3
+    };
+
+    struct SharedSample {
+        /** Index of the sample in publication order */
+        uint64_t index;
+        uint32_t type;
+        uint32_t reserved;
+        union {
+            GNSSSolutionRecord solution;
+            AISTargetRecord target;
+        };
+
+        gps_base::Solution getSolution() const;
+        ais_base::Position getPosition() const;
+        ais_base::VesselInformation getVesselInformation() const;
+    };
+    static_assert(sizeof(SharedSample) % sizeof(uint64_t) == 0,
+        "SharedSample must be made of 64-bit words");
+
+    struct SharedSampleHeader;
+    struct SharedSampleSlot;
+
+    /**
+     * Publication of decoded samples to other local processes
+     *
+     * Samples are written in a ring of slots in a POSIX shared memory
+     * segment. Each slot is protected by a sequence counter (seqlock), so
+     * that the single publisher never waits for readers, and any number of
+     * readers can follow the stream without system calls. Readers that fall
+     * more than a ring behind lose the overwritten samples.
+     *
+     * ~~~ cpp
+     * SharedSamplePublisher publisher("/nmea0183");
+     * publisher.publish(AIS::getPosition(*position_report));
+     *
+     * // In another process
+     * SharedSampleReader reader("/nmea0183");
+     * SharedSample sample;
+     * while (reader.read(sample)) {
+     *     if (sample.type == SHARED_SAMPLE_POSITION) {
+     *         auto position = sample.getPosition();
+     *     }
+     * }
+     * ~~~
+     */
+    class SharedSamplePublisher {
+        std::string m_name;
+        size_t m_size = 0;
+        SharedSampleHeader* m_header = nullptr;
+        SharedSampleSlot* m_slots = nullptr;
+
+        void publish(SharedSample& sample);
+
+    public:
+        /** Create the shared memory segment
+         *
+         * A segment left by a previous publisher is replaced. Its readers
+         * need to be re-created to follow the new one.
+         *
+         * @param name the segment name, as given to shm_open, e.g. "/nmea0183"
+         * @throw std::invalid_argument if the slot count is zero
+         * @throw std::system_error if the segment cannot be created
+         */
+        explicit SharedSamplePublisher(std::string const& name,
+            uint32_t slot_count = 4096);
+
+        /** Unmaps and removes the segment */
+        ~SharedSamplePublisher();
+
+        SharedSamplePublisher(SharedSamplePublisher const&) = delete;
+        SharedSamplePublisher& operator=(SharedSamplePublisher const&) = delete;
+
+        void publish(gps_base::Solution const& solution);
+        void publish(ais_base::Position const& position);
+        void publish(ais_base::VesselInformation const& info);
+
+        uint64_t getPublishedCount() const;
+    };
+
+    class SharedSampleReader {
+        size_t m_size = 0;
+        SharedSampleHeader const* m_header = nullptr;
+        SharedSampleSlot const* m_slots = nullptr;
+        uint32_t m_slot_count = 0;
+        uint64_t m_next = 0;
+        uint64_t m_lost = 0;
+
+    public:
+        /** Open an existing segment
+         *
+         * The reader starts with the samples published after its creation
+         *
+         * @throw std::system_error if the segment cannot be opened
+         * @throw std::invalid_argument if the segment is not a valid sample
+         *   ring
+         */
+        explicit SharedSampleReader(std::string const& name);
+        ~SharedSampleReader();
+
+        SharedSampleReader(SharedSampleReader const&) = delete;
+        SharedSampleReader& operator=(SharedSampleReader const&) = delete;
+
+        /** Get the next sample
+         *
+         * @return false if there is no new sample
+         */
+        bool read(SharedSample& sample);
+
+        /** Position the reader on the oldest sample still in the ring */
+        void seekToOldest();
+
+        /** Number of samples that were overwritten before they could be read */
+        uint64_t getLostCount() const;
+    };
+}
+
+#endif
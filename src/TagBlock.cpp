@@ -0,0 +1,151 @@
+#include <nmea0183/TagBlock.hpp>
+
+#include <charconv>
+
+using namespace std;
+using namespace nmea0183;
+
+/** Unix times above this are in milliseconds. In seconds, it is year 5138 */
+static const int64_t MAX_UNIX_TIME_SECONDS = 100000000000LL;
+
+static int hexValue(uint8_t c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    else if (c >= 'A' && c <= 'F') {
+        return 10 + c - 'A';
+    }
+    else if (c >= 'a' && c <= 'f') {
+        return 10 + c - 'a';
+    }
+    return -1;
+}
+
+template <typename T> static bool parseNumber(string_view text, T& value)
+{
+    auto result = from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == errc() && result.ptr == text.data() + text.size();
+}
+
+int TagBlock::extract(uint8_t const* buffer, size_t size, uint32_t* checksum_error_count)
+{
+    if (buffer[0] != '\\') {
+        return -1;
+    }
+
+    size_t end = 0;
+    for (size_t i = 1; i < size && i < MAX_LENGTH; ++i) {
+        if (buffer[i] == '\\') {
+            end = i;
+            break;
+        }
+        else if (buffer[i] == '\r' || buffer[i] == '\n' || buffer[i] == '$' ||
+                 buffer[i] == '!') {
+            return -1;
+        }
+    }
+    if (end == 0) {
+        return size < MAX_LENGTH ? 0 : -1;
+    }
+
+    // Shortest valid block is \*hh\ (5 bytes)
+    if (end < 4 || buffer[end - 3] != '*') {
+        return -1;
+    }
+    int high = hexValue(buffer[end - 2]);
+    int low = hexValue(buffer[end - 1]);
+    if (high < 0 || low < 0) {
+        return -1;
+    }
+
+    uint8_t checksum = 0;
+    for (size_t i = 1; i < end - 3; ++i) {
+        checksum ^= buffer[i];
+    }
+    if (checksum != ((high << 4) | low)) {
+        if (checksum_error_count) {
+            (*checksum_error_count)++;
+        }
+        return -1;
+    }
+    return end + 1;
+}
+
+size_t TagBlock::getSize(uint8_t const* buffer, size_t size)
+{
+    if (size == 0 || buffer[0] != '\\') {
+        return 0;
+    }
+    for (size_t i = 1; i < size; ++i) {
+        if (buffer[i] == '\\') {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+TagBlock TagBlock::parse(uint8_t const* buffer, size_t size)
+{
+    TagBlock block;
+    size_t block_size = getSize(buffer, size);
+    if (block_size < 5) {
+        return block;
+    }
+    block.valid = true;
+
+    // Contents between the leading backslash and the checksum
+    string_view contents(reinterpret_cast<char const*>(buffer) + 1, block_size - 5);
+    while (!contents.empty()) {
+        size_t comma = contents.find(',');
+        string_view field = contents.substr(0, comma);
+        contents = comma == string_view::npos ? string_view() : contents.substr(comma + 1);
+        if (field.size() < 2 || field[1] != ':') {
+            continue;
+        }
+
+        string_view value = field.substr(2);
+        switch (field[0]) {
+            case 's':
+                block.source = value;
+                break;
+            case 'd':
+                block.destination = value;
+                break;
+            case 't':
+                block.text = value;
+                break;
+            case 'n':
+                parseNumber(value, block.line_count);
+                break;
+            case 'c': {
+                int64_t time;
+                if (parseNumber(value, time)) {
+                    block.time = time > MAX_UNIX_TIME_SECONDS
+                                     ? base::Time::fromMilliseconds(time)
+                                     : base::Time::fromSeconds(time);
+                }
+                break;
+            }
+            case 'g': {
+                size_t first = value.find('-');
+                size_t second = value.find('-', first + 1);
+                if (first == string_view::npos || second == string_view::npos) {
+                    break;
+                }
+                uint32_t sentence, total, id;
+                if (parseNumber(value.substr(0, first), sentence) &&
+                    parseNumber(value.substr(first + 1, second - first - 1), total) &&
+                    parseNumber(value.substr(second + 1), id)) {
+                    block.group_sentence = sentence;
+                    block.group_size = total;
+                    block.group_id = id;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return block;
+}
@@ -0,0 +1,69 @@
+#ifndef NMEA0183_TAG_BLOCK_HPP
+#define NMEA0183_TAG_BLOCK_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <string_view>
+
+namespace nmea0183 {
+    /**
+     * NMEA 4.x TAG block, as prefixed to sentences by e.g. AIS network feeds
+     *
+     * ~~~
+     * \g:1-2-73874,s:station1,c:1241544035*4A\!AIVDM,...
+     * ~~~
+     *
+     * The string fields are views into the buffer the block was parsed from.
+     * They are only valid as long as that buffer is.
+     */
+    struct TagBlock {
+        /** Maximum size of a TAG block, including the delimiters */
+        static const int MAX_LENGTH = 80;
+
+        /** Whether the sentence had a TAG block */
+        bool valid = false;
+        /** Source station (s:) */
+        std::string_view source;
+        /** Destination (d:) */
+        std::string_view destination;
+        /** Free text (t:) */
+        std::string_view text;
+        /** Reception time (c:), null if absent */
+        base::Time time;
+        /** Line count (n:), or -1 if absent */
+        int64_t line_count = -1;
+        /** Sentence grouping (g:). Zero if absent */
+        uint32_t group_sentence = 0;
+        uint32_t group_size = 0;
+        uint32_t group_id = 0;
+
+        /** Size of the TAG block at the beginning of a framed sentence,
+         * including the delimiters. Zero if there is none
+         */
+        static size_t getSize(uint8_t const* buffer, size_t size);
+
+        /** Frame the TAG block at the beginning of a buffer
+         *
+         * It follows the extractPacket protocol: it returns the size of the
+         * block if it is complete and valid, 0 if more data is needed and -1
+         * if the first byte should be discarded.
+         *
+         * @param checksum_error_count if non-null, incremented when the block
+         *   is rejected because of its checksum
+         */
+        static int extract(uint8_t const* buffer, size_t size,
+            uint32_t* checksum_error_count = nullptr);
+
+        /** Parse the TAG block of a framed sentence
+         *
+         * The c: field is expected to be in seconds since the epoch. Values
+         * that can only be milliseconds, as sent by some providers, are
+         * interpreted as such. Unknown fields are ignored.
+         *
+         * @return the block. Its valid flag is false if the sentence has none
+         */
+        static TagBlock parse(uint8_t const* buffer, size_t size);
+    };
+}
+
+#endif
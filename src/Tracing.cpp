@@ -0,0 +1,270 @@
+#include <nmea0183/Tracing.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+
+using namespace std;
+using namespace nmea0183;
+using namespace nmea0183::tracing;
+
+namespace {
+    struct Ring {
+        unique_ptr<Event[]> events{new Event[RING_SIZE]};
+        /** Number of events ever recorded in this ring */
+        atomic<uint64_t> head{0};
+        /** Value of head at the last clear() */
+        atomic<uint64_t> cleared{0};
+        atomic<bool> in_use{false};
+        uint16_t thread = 0;
+    };
+
+    struct Registry {
+        mutex lock;
+        vector<unique_ptr<Ring>> rings;
+    };
+
+    /** Never destroyed, threads may record events during static
+     * destruction */
+    Registry& getRegistry()
+    {
+        static Registry* registry = new Registry();
+        return *registry;
+    }
+
+    /** Hands the ring back to the registry when its thread exits */
+    struct ThreadRing {
+        Ring* ring = nullptr;
+        ~ThreadRing()
+        {
+            if (ring) {
+                ring->in_use = false;
+            }
+        }
+    };
+
+    thread_local ThreadRing thread_ring;
+    thread_local uint64_t current_id = 0;
+    atomic<uint64_t> next_id{1};
+    atomic<bool> enabled{true};
+}
+
+static Ring& getThreadRing()
+{
+    if (thread_ring.ring) {
+        return *thread_ring.ring;
+    }
+
+    Registry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    for (auto& ring : registry.rings) {
+        bool expected = false;
+        if (ring->in_use.compare_exchange_strong(expected, true)) {
+            thread_ring.ring = ring.get();
+            return *ring;
+        }
+    }
+
+    registry.rings.emplace_back(new Ring());
+    Ring& ring = *registry.rings.back();
+    ring.thread = registry.rings.size() - 1;
+    ring.in_use = true;
+    thread_ring.ring = &ring;
+    return ring;
+}
+
+/** Index of the oldest event that can be read given the ring's head
+ *
+ * The slot of the event at head - RING_SIZE may be being written
+ */
+static uint64_t firstValidEvent(uint64_t head)
+{
+    return head + 1 > RING_SIZE ? head + 1 - RING_SIZE : 0;
+}
+
+char const* tracing::getStageName(Stage stage)
+{
+    switch (stage) {
+        case STAGE_READ:
+            return "read";
+        case STAGE_EXTRACT:
+            return "extract";
+        case STAGE_PARSE:
+            return "parse";
+        case STAGE_REASSEMBLY:
+            return "reassembly";
+        case STAGE_QUEUE:
+            return "queue";
+        case STAGE_DECODE:
+            return "decode";
+        case STAGE_POSITION:
+            return "position";
+        case STAGE_CORRECTION:
+            return "correction";
+        default:
+            return "unknown";
+    }
+}
+
+uint64_t tracing::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+uint64_t tracing::newId()
+{
+    return next_id.fetch_add(1, memory_order_relaxed);
+}
+
+uint64_t tracing::getCurrentId()
+{
+    return current_id;
+}
+
+void tracing::setCurrentId(uint64_t id)
+{
+    current_id = id;
+}
+
+void tracing::setEnabled(bool enable)
+{
+    enabled.store(enable, memory_order_relaxed);
+}
+
+bool tracing::isEnabled()
+{
+    return enabled.load(memory_order_relaxed);
+}
+
+void tracing::record(Stage stage, uint64_t id, uint64_t start, uint64_t end)
+{
+    if (!enabled.load(memory_order_relaxed)) {
+        return;
+    }
+
+    Ring& ring = getThreadRing();
+    uint64_t head = ring.head.load(memory_order_relaxed);
+    Event& event = ring.events[head % RING_SIZE];
+    event.id = id;
+    event.start = start;
+    event.duration = min<uint64_t>(end - start, UINT32_MAX);
+    event.stage = stage;
+    event.thread = ring.thread;
+    ring.head.store(head + 1, memory_order_release);
+}
+
+vector<Event> tracing::getEvents()
+{
+    vector<Event> result;
+    Registry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    for (auto const& ring : registry.rings) {
+        uint64_t head = ring->head.load(memory_order_acquire);
+        uint64_t cleared = ring->cleared.load(memory_order_relaxed);
+        size_t initial_size = result.size();
+        uint64_t first = max(cleared, firstValidEvent(head));
+        for (uint64_t i = first; i < head; ++i) {
+            result.push_back(ring->events[i % RING_SIZE]);
+        }
+
+        // The writer may have overwritten the oldest events while we were
+        // copying them
+        uint64_t first_valid = firstValidEvent(ring->head.load(memory_order_acquire));
+        if (first_valid > first) {
+            size_t overwritten = min(first_valid, head) - first;
+            result.erase(result.begin() + initial_size,
+                result.begin() + initial_size + overwritten);
+        }
+    }
+    return result;
+}
+
+void tracing::clear()
+{
+    Registry& registry = getRegistry();
+    lock_guard<mutex> guard(registry.lock);
+    for (auto const& ring : registry.rings) {
+        ring->cleared.store(ring->head.load(memory_order_acquire));
+    }
+}
+
+vector<StageSummary> tracing::getSummary(vector<Event> const& events)
+{
+    vector<vector<uint64_t>> durations(STAGE_COUNT);
+    for (auto const& event : events) {
+        if (event.stage < STAGE_COUNT) {
+            durations[event.stage].push_back(event.duration);
+        }
+    }
+
+    vector<StageSummary> result;
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        auto& values = durations[stage];
+        if (values.empty()) {
+            continue;
+        }
+        sort(values.begin(), values.end());
+
+        StageSummary summary;
+        summary.stage = static_cast<Stage>(stage);
+        summary.count = values.size();
+        summary.min = values.front();
+        summary.max = values.back();
+        uint64_t total = 0;
+        for (auto v : values) {
+            total += v;
+        }
+        summary.mean = total / values.size();
+        auto percentile = [&](double p) {
+            size_t rank = ceil(p * values.size());
+            return values[max<size_t>(rank, 1) - 1];
+        };
+        summary.p50 = percentile(0.5);
+        summary.p90 = percentile(0.9);
+        summary.p99 = percentile(0.99);
+        result.push_back(summary);
+    }
+    return result;
+}
+
+void tracing::writeChromeTrace(ostream& out, vector<Event> const& events)
+{
+    out << "{\"traceEvents\":[";
+    out << fixed << setprecision(3);
+    bool first = true;
+    for (auto const& event : events) {
+        if (!first) {
+            out << ",";
+        }
+        first = false;
+        out << "\n{\"name\":\"" << getStageName(static_cast<Stage>(event.stage))
+            << "\",\"cat\":\"nmea0183\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+            << ",\"ts\":" << event.start / 1e3 << ",\"dur\":" << event.duration / 1e3
+            << ",\"args\":{\"id\":" << event.id << "}}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+void tracing::writeSummary(ostream& out, vector<StageSummary> const& summary)
+{
+    out << left << setw(12) << "stage" << right << setw(10) << "count";
+    for (auto name : {"min", "mean", "p50", "p90", "p99", "max"}) {
+        out << setw(12) << name;
+    }
+    out << " (us)\n";
+
+    out << fixed << setprecision(3);
+    for (auto const& s : summary) {
+        out << left << setw(12) << getStageName(s.stage) << right << setw(10) << s.count;
+        for (auto value : {s.min, s.mean, s.p50, s.p90, s.p99, s.max}) {
+            out << setw(12) << value / 1e3;
+        }
+        out << "\n";
+    }
+}
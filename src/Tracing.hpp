@@ -0,0 +1,160 @@
+#ifndef NMEA0183_TRACING_HPP
+#define NMEA0183_TRACING_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace nmea0183 {
+    /**
+     * Latency tracing of the decoding stages
+     *
+     * Each thread records its events in its own fixed-size ring, without
+     * locks. The oldest events get overwritten. Events of the same sentence
+     * or message share an ID, which follows the message across threads in
+     * AISPipeline.
+     *
+     * The library is only instrumented when built with the NMEA0183_TRACING
+     * CMake option. Otherwise the NMEA0183_TRACE_* macros compile to nothing,
+     * and the functions below only see events recorded by the caller.
+     */
+    namespace tracing {
+        enum Stage : uint16_t {
+            /** readPacket, i.e. waiting for and reading the sentence */
+            STAGE_READ,
+            /** A call to Driver::extractPacket */
+            STAGE_EXTRACT,
+            /** Sentence parsing by marnav */
+            STAGE_PARSE,
+            /** From the first to the last fragment of an AIS message */
+            STAGE_REASSEMBLY,
+            /** Time spent in AISPipeline's job queue */
+            STAGE_QUEUE,
+            /** AIS message decoding by marnav */
+            STAGE_DECODE,
+            /** AIS::getPosition */
+            STAGE_POSITION,
+            /** AIS::applyPositionCorrection */
+            STAGE_CORRECTION,
+            STAGE_COUNT
+        };
+
+        struct Event {
+            uint64_t id;
+            /** Start time, in nanoseconds of the monotonic clock */
+            uint64_t start;
+            uint32_t duration;
+            uint16_t stage;
+            uint16_t thread;
+        };
+
+        struct StageSummary {
+            Stage stage;
+            uint64_t count = 0;
+            /** Durations, in nanoseconds */
+            uint64_t min = 0;
+            uint64_t mean = 0;
+            uint64_t p50 = 0;
+            uint64_t p90 = 0;
+            uint64_t p99 = 0;
+            uint64_t max = 0;
+        };
+
+        /** Size of the per-thread rings. The last RING_SIZE - 1 events of
+         * each thread can be read back
+         */
+        static const uint32_t RING_SIZE = 1 << 16;
+
+        /** Name of a stage, as used in the exports */
+        char const* getStageName(Stage stage);
+
+        /** Monotonic time in nanoseconds */
+        uint64_t now();
+
+        /** A new unique sentence or message ID */
+        uint64_t newId();
+
+        /** The ID of the sentence or message the calling thread is processing */
+        uint64_t getCurrentId();
+
+        /** Set the ID of the sentence or message the calling thread is
+         * processing
+         */
+        void setCurrentId(uint64_t id);
+
+        /** Pause or resume the recording. It is enabled by default */
+        void setEnabled(bool enabled);
+
+        bool isEnabled();
+
+        /** Record an event in the calling thread's ring */
+        void record(Stage stage, uint64_t id, uint64_t start, uint64_t end);
+
+        /** Copy the events of all threads, oldest first within a thread
+         *
+         * Events that get overwritten while being copied are skipped
+         */
+        std::vector<Event> getEvents();
+
+        /** Drop all recorded events */
+        void clear();
+
+        /** Duration statistics per stage, for the stages that have events */
+        std::vector<StageSummary> getSummary(std::vector<Event> const& events);
+
+        /** Write events in the Chrome trace format (chrome://tracing, Perfetto) */
+        void writeChromeTrace(std::ostream& out, std::vector<Event> const& events);
+
+        /** Write the per-stage statistics as a text table, in microseconds */
+        void writeSummary(std::ostream& out, std::vector<StageSummary> const& summary);
+
+        /** Records an event covering its lifetime */
+        class Scope {
+            Stage m_stage;
+            uint64_t m_start;
+
+        public:
+            explicit Scope(Stage stage)
+                : m_stage(stage)
+                , m_start(now())
+            {
+            }
+            ~Scope()
+            {
+                record(m_stage, getCurrentId(), m_start, now());
+            }
+            Scope(Scope const&) = delete;
+            Scope& operator=(Scope const&) = delete;
+        };
+    }
+}
+
+#define NMEA0183_TRACE_CONCAT_(a, b) a##b
+#define NMEA0183_TRACE_CONCAT(a, b) NMEA0183_TRACE_CONCAT_(a, b)
+
+#ifdef NMEA0183_TRACING
+/** Record the rest of the enclosing scope as an event of the given stage */
+#define NMEA0183_TRACE_SCOPE(stage)                                                     \
+    ::nmea0183::tracing::Scope NMEA0183_TRACE_CONCAT(nmea0183_trace_scope_, __LINE__)( \
+        ::nmea0183::tracing::stage)
+/** Record an event of the given stage, from start to now */
+#define NMEA0183_TRACE_RECORD(stage, start)                                             \
+    ::nmea0183::tracing::record(::nmea0183::tracing::stage,                           \
+        ::nmea0183::tracing::getCurrentId(),                                          \
+        start,                                                                        \
+        ::nmea0183::tracing::now())
+#define NMEA0183_TRACE_NOW() ::nmea0183::tracing::now()
+#define NMEA0183_TRACE_NEW_ID() \
+    ::nmea0183::tracing::setCurrentId(::nmea0183::tracing::newId())
+#define NMEA0183_TRACE_SET_ID(id) ::nmea0183::tracing::setCurrentId(id)
+#define NMEA0183_TRACE_CURRENT_ID() ::nmea0183::tracing::getCurrentId()
+#else
+#define NMEA0183_TRACE_SCOPE(stage) static_cast<void>(0)
+#define NMEA0183_TRACE_RECORD(stage, start) static_cast<void>(start)
+#define NMEA0183_TRACE_NOW() static_cast<uint64_t>(0)
+#define NMEA0183_TRACE_NEW_ID() static_cast<void>(0)
+#define NMEA0183_TRACE_SET_ID(id) static_cast<void>(0)
+#define NMEA0183_TRACE_CURRENT_ID() static_cast<uint64_t>(0)
+#endif
+
+#endif
@@ -0,0 +1,349 @@
+#include <nmea0183/TrackHistory.hpp>
+
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+using namespace nmea0183;
+
+/** Columns, in order, in a track's buffer */
+enum Column {
+    TIME,
+    LATITUDE,
+    LONGITUDE,
+    SPEED,
+    COURSE,
+    HEADING
+};
+
+static const double TIME_RESOLUTION = 0.1;
+static const double POSITION_RESOLUTION = 1e-5;
+static const double SPEED_RESOLUTION = 0.01;
+static const double ANGLE_RESOLUTION = 0.01;
+static const uint16_t UNKNOWN = 0xFFFF;
+
+/** Rough size of an entry in the MMSI map */
+static const size_t MAP_ENTRY_SIZE = 32;
+
+static int64_t quantizeTime(base::Time const& time)
+{
+    return llround(time.toSeconds() / TIME_RESOLUTION);
+}
+
+static int32_t quantizePosition(base::Angle const& angle)
+{
+    return lround(angle.getDeg() / POSITION_RESOLUTION);
+}
+
+static uint16_t quantizeSpeed(double speed)
+{
+    if (std::isnan(speed) || speed < 0) {
+        return UNKNOWN;
+    }
+    return min<long>(lround(speed / SPEED_RESOLUTION), UNKNOWN - 1);
+}
+
+static double dequantizeSpeed(uint16_t speed)
+{
+    return speed == UNKNOWN ? base::unknown<double>() : speed * SPEED_RESOLUTION;
+}
+
+static uint16_t quantizeAngle(base::Angle const& angle)
+{
+    double degrees = angle.getDeg();
+    if (std::isnan(degrees)) {
+        return UNKNOWN;
+    }
+    long steps = lround(degrees / ANGLE_RESOLUTION) % 36000;
+    return steps < 0 ? steps + 36000 : steps;
+}
+
+static base::Angle dequantizeAngle(uint16_t angle)
+{
+    if (angle == UNKNOWN) {
+        return base::Angle();
+    }
+    double degrees = angle * ANGLE_RESOLUTION;
+    return base::Angle::fromDeg(degrees >= 180 ? degrees - 360 : degrees);
+}
+
+/** Longitude difference, wrapped around the antimeridian */
+static int64_t longitudeDelta(int32_t longitude, int32_t reference)
+{
+    const int64_t full_turn = llround(360 / POSITION_RESOLUTION);
+    int64_t delta = (static_cast<int64_t>(longitude) - reference) % full_turn;
+    if (delta >= full_turn / 2) {
+        return delta - full_turn;
+    }
+    else if (delta < -full_turn / 2) {
+        return delta + full_turn;
+    }
+    return delta;
+}
+
+static base::Angle dequantizeLongitude(int64_t longitude)
+{
+    double degrees = fmod(longitude * POSITION_RESOLUTION, 360);
+    if (degrees >= 180) {
+        degrees -= 360;
+    }
+    else if (degrees < -180) {
+        degrees += 360;
+    }
+    return base::Angle::fromDeg(degrees);
+}
+
+static bool fitsInt16(int64_t value)
+{
+    return value >= INT16_MIN && value <= INT16_MAX;
+}
+
+TrackHistory::TrackHistory(uint32_t capacity, size_t memory_budget)
+    : m_capacity(capacity)
+{
+    if (capacity == 0) {
+        throw invalid_argument("TrackHistory: capacity must be strictly positive");
+    }
+    m_max_tracks = memory_budget / getTrackMemorySize(capacity);
+    if (m_max_tracks == 0) {
+        throw invalid_argument("TrackHistory: memory budget of " +
+                               to_string(memory_budget) +
+                               " bytes is too small for a single track");
+    }
+}
+
+size_t TrackHistory::getTrackMemorySize(uint32_t capacity)
+{
+    return sizeof(Track) + MAP_ENTRY_SIZE + capacity * COLUMN_COUNT * sizeof(uint16_t);
+}
+
+void TrackHistory::unlink(uint32_t index)
+{
+    Track& track = m_tracks[index];
+    if (track.previous != NONE) {
+        m_tracks[track.previous].next = track.next;
+    }
+    else {
+        m_oldest = track.next;
+    }
+    if (track.next != NONE) {
+        m_tracks[track.next].previous = track.previous;
+    }
+    else {
+        m_newest = track.previous;
+    }
+    track.previous = NONE;
+    track.next = NONE;
+}
+
+void TrackHistory::linkAsNewest(uint32_t index)
+{
+    Track& track = m_tracks[index];
+    track.previous = m_newest;
+    track.next = NONE;
+    if (m_newest != NONE) {
+        m_tracks[m_newest].next = index;
+    }
+    else {
+        m_oldest = index;
+    }
+    m_newest = index;
+}
+
+uint32_t TrackHistory::allocateTrack(int mmsi)
+{
+    if (m_mmsi_to_track.size() >= m_max_tracks) {
+        releaseTrack(m_oldest);
+        m_eviction_count++;
+    }
+
+    uint32_t index;
+    if (!m_free_tracks.empty()) {
+        index = m_free_tracks.back();
+        m_free_tracks.pop_back();
+    }
+    else {
+        index = m_tracks.size();
+        m_tracks.emplace_back();
+        m_tracks.back().columns.reset(new uint16_t[m_capacity * COLUMN_COUNT]);
+    }
+
+    Track& track = m_tracks[index];
+    track.mmsi = mmsi;
+    track.start = 0;
+    track.count = 0;
+    m_mmsi_to_track[mmsi] = index;
+    linkAsNewest(index);
+    return index;
+}
+
+void TrackHistory::releaseTrack(uint32_t index)
+{
+    unlink(index);
+    m_mmsi_to_track.erase(m_tracks[index].mmsi);
+    m_free_tracks.push_back(index);
+}
+
+void TrackHistory::push(Track& track,
+    ais_base::Position const& position,
+    int64_t time,
+    int32_t latitude,
+    int32_t longitude)
+{
+    uint16_t* columns = track.columns.get();
+    uint32_t slot;
+    if (track.count == m_capacity && m_capacity == 1) {
+        // The only sample is dropped, there is no next one to become the
+        // reference
+        track.count = 0;
+    }
+    if (track.count == 0) {
+        track.first_time = time;
+        track.first_latitude = latitude;
+        track.first_longitude = longitude;
+        track.start = 0;
+        slot = 0;
+        columns[TIME * m_capacity] = 0;
+        columns[LATITUDE * m_capacity] = 0;
+        columns[LONGITUDE * m_capacity] = 0;
+        track.count = 1;
+    }
+    else {
+        if (track.count == m_capacity) {
+            // Drop the oldest sample. The next one becomes the reference
+            track.start = (track.start + 1) % m_capacity;
+            track.first_time += columns[TIME * m_capacity + track.start];
+            track.first_latitude +=
+                static_cast<int16_t>(columns[LATITUDE * m_capacity + track.start]);
+            track.first_longitude = longitudeDelta(
+                track.first_longitude +
+                    static_cast<int16_t>(columns[LONGITUDE * m_capacity + track.start]),
+                0);
+            track.count--;
+        }
+        slot = (track.start + track.count) % m_capacity;
+        columns[TIME * m_capacity + slot] = time - track.last_time;
+        columns[LATITUDE * m_capacity + slot] =
+            static_cast<int16_t>(latitude - track.last_latitude);
+        columns[LONGITUDE * m_capacity + slot] =
+            static_cast<int16_t>(longitudeDelta(longitude, track.last_longitude));
+        track.count++;
+    }
+
+    columns[SPEED * m_capacity + slot] = quantizeSpeed(position.speed_over_ground);
+    columns[COURSE * m_capacity + slot] = quantizeAngle(position.course_over_ground);
+    columns[HEADING * m_capacity + slot] = quantizeAngle(position.yaw);
+    track.last_time = time;
+    track.last_latitude = latitude;
+    track.last_longitude = longitude;
+}
+
+bool TrackHistory::update(ais_base::Position const& position)
+{
+    if (std::isnan(position.latitude.getRad()) ||
+        std::isnan(position.longitude.getRad())) {
+        return false;
+    }
+
+    int64_t time = quantizeTime(position.time);
+    int32_t latitude = quantizePosition(position.latitude);
+    int32_t longitude = quantizePosition(position.longitude);
+
+    auto it = m_mmsi_to_track.find(position.mmsi);
+    if (it == m_mmsi_to_track.end()) {
+        uint32_t index = allocateTrack(position.mmsi);
+        push(m_tracks[index], position, time, latitude, longitude);
+        return true;
+    }
+
+    Track& track = m_tracks[it->second];
+    int64_t time_delta = time - track.last_time;
+    if (time_delta < 0) {
+        return false;
+    }
+    else if (time_delta > UINT16_MAX || !fitsInt16(latitude - track.last_latitude) ||
+             !fitsInt16(longitudeDelta(longitude, track.last_longitude))) {
+        track.count = 0;
+    }
+
+    push(track, position, time, latitude, longitude);
+    unlink(it->second);
+    linkAsNewest(it->second);
+    return true;
+}
+
+size_t TrackHistory::getTrack(int mmsi,
+    base::Time const& from,
+    base::Time const& to,
+    vector<ais_base::Position>& samples) const
+{
+    auto it = m_mmsi_to_track.find(mmsi);
+    if (it == m_mmsi_to_track.end()) {
+        return 0;
+    }
+
+    Track const& track = m_tracks[it->second];
+    uint16_t const* columns = track.columns.get();
+    int64_t min_time = quantizeTime(from);
+    int64_t max_time = quantizeTime(to);
+    int64_t time = track.first_time;
+    int32_t latitude = track.first_latitude;
+    int64_t longitude = track.first_longitude;
+    size_t initial_size = samples.size();
+    for (uint32_t i = 0; i < track.count; ++i) {
+        uint32_t slot = (track.start + i) % m_capacity;
+        if (i != 0) {
+            time += columns[TIME * m_capacity + slot];
+            latitude += static_cast<int16_t>(columns[LATITUDE * m_capacity + slot]);
+            longitude += static_cast<int16_t>(columns[LONGITUDE * m_capacity + slot]);
+        }
+        if (time < min_time) {
+            continue;
+        }
+        else if (time > max_time) {
+            break;
+        }
+
+        ais_base::Position sample;
+        sample.mmsi = mmsi;
+        sample.time = base::Time::fromSeconds(time * TIME_RESOLUTION);
+        sample.latitude = base::Angle::fromDeg(latitude * POSITION_RESOLUTION);
+        sample.longitude = dequantizeLongitude(longitude);
+        sample.speed_over_ground = dequantizeSpeed(columns[SPEED * m_capacity + slot]);
+        sample.course_over_ground = dequantizeAngle(columns[COURSE * m_capacity + slot]);
+        sample.yaw = dequantizeAngle(columns[HEADING * m_capacity + slot]);
+        samples.push_back(sample);
+    }
+    return samples.size() - initial_size;
+}
+
+size_t TrackHistory::getSampleCount(int mmsi) const
+{
+    auto it = m_mmsi_to_track.find(mmsi);
+    return it == m_mmsi_to_track.end() ? 0 : m_tracks[it->second].count;
+}
+
+bool TrackHistory::remove(int mmsi)
+{
+    auto it = m_mmsi_to_track.find(mmsi);
+    if (it == m_mmsi_to_track.end()) {
+        return false;
+    }
+    releaseTrack(it->second);
+    return true;
+}
+
+size_t TrackHistory::size() const
+{
+    return m_mmsi_to_track.size();
+}
+
+size_t TrackHistory::getMaxTrackCount() const
+{
+    return m_max_tracks;
+}
+
+uint64_t TrackHistory::getEvictionCount() const
+{
+    return m_eviction_count;
+}
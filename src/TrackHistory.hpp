@@ -0,0 +1,121 @@
+#ifndef NMEA0183_TRACK_HISTORY_HPP
+#define NMEA0183_TRACK_HISTORY_HPP
+
+#include <ais_base/Position.hpp>
+#include <base/Time.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace nmea0183 {
+    /**
+     * Recent history of the positions of AIS targets, in bounded memory
+     *
+     * Each target has a fixed-capacity ring of samples stored as 16-bit
+     * columns: time, latitude and longitude are delta-encoded against the
+     * oldest sample, speed, course and heading are quantized. A sample takes
+     * 12 bytes.
+     *
+     * Resolutions are 0.1s, 1e-5 deg (about 1m) for latitude and longitude,
+     * 0.01 m/s and 0.01 deg. Consecutive samples more than 6553s or 0.32 deg
+     * apart cannot be delta-encoded, the target's track is then restarted
+     * from the new sample.
+     *
+     * The number of targets is bounded by a global memory budget. When it is
+     * reached, the least recently updated target is evicted.
+     */
+    class TrackHistory {
+    public:
+        static const int COLUMN_COUNT = 6;
+
+    private:
+        static const uint32_t NONE = UINT32_MAX;
+
+        struct Track {
+            int mmsi = 0;
+            /** Quantized values of the oldest sample */
+            int64_t first_time = 0;
+            int32_t first_latitude = 0;
+            int32_t first_longitude = 0;
+            /** Quantized values of the newest sample */
+            int64_t last_time = 0;
+            int32_t last_latitude = 0;
+            int32_t last_longitude = 0;
+
+            uint32_t start = 0;
+            uint32_t count = 0;
+            std::unique_ptr<uint16_t[]> columns;
+
+            /** Least recently updated list */
+            uint32_t previous = NONE;
+            uint32_t next = NONE;
+        };
+
+        uint32_t m_capacity;
+        size_t m_max_tracks;
+        std::vector<Track> m_tracks;
+        std::vector<uint32_t> m_free_tracks;
+        std::unordered_map<int, uint32_t> m_mmsi_to_track;
+        uint32_t m_oldest = NONE;
+        uint32_t m_newest = NONE;
+        uint64_t m_eviction_count = 0;
+
+        uint32_t allocateTrack(int mmsi);
+        void releaseTrack(uint32_t index);
+        void unlink(uint32_t index);
+        void linkAsNewest(uint32_t index);
+        void push(Track& track, ais_base::Position const& position,
+            int64_t time, int32_t latitude, int32_t longitude);
+
+    public:
+        /**
+         * @param capacity the number of samples kept per target
+         * @param memory_budget the memory, in bytes, that the history may use
+         * @throw std::invalid_argument if the capacity is zero, or the
+         *   budget is too small for a single target
+         */
+        TrackHistory(uint32_t capacity, size_t memory_budget);
+
+        /** Add a position to the track of its target
+         *
+         * @return false if the position has no latitude or longitude, or is
+         *   older than the last sample of the target, in which case it is
+         *   not added
+         */
+        bool update(ais_base::Position const& position);
+
+        /** Append the samples of a target within [from, to]
+         *
+         * The samples have their time, latitude, longitude, speed and course
+         * over ground and yaw set
+         *
+         * @return the number of samples appended
+         */
+        size_t getTrack(int mmsi, base::Time const& from, base::Time const& to,
+            std::vector<ais_base::Position>& samples) const;
+
+        /** Number of samples of a target, zero if it is not known */
+        size_t getSampleCount(int mmsi) const;
+
+        /** Remove a target's track
+         *
+         * @return false if the target is not known
+         */
+        bool remove(int mmsi);
+
+        /** Number of targets that have a track */
+        size_t size() const;
+
+        /** Maximum number of targets, as allowed by the memory budget */
+        size_t getMaxTrackCount() const;
+
+        /** Count of targets evicted to stay within the memory budget */
+        uint64_t getEvictionCount() const;
+
+        /** Estimated memory used by one target's track, in bytes */
+        static size_t getTrackMemorySize(uint32_t capacity);
+    };
+}
+
+#endif
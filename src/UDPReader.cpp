@@ -0,0 +1,250 @@
+#include <nmea0183/UDPReader.hpp>
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <nmea0183/Driver.hpp>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+UDPReader::UDPReader(int port,
+    string const& address,
+    size_t batch_size,
+    size_t datagram_size)
+    : m_datagram_size(datagram_size)
+{
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+    addrinfo* info = nullptr;
+    string service = to_string(port);
+    int ret = getaddrinfo(
+        address.empty() ? nullptr : address.c_str(), service.c_str(), &hints, &info);
+    if (ret != 0) {
+        throw system_error(EINVAL, system_category(),
+            "cannot resolve " + address + ": " + gai_strerror(ret));
+    }
+
+    int error = 0;
+    for (addrinfo* it = info; it; it = it->ai_next) {
+        m_fd = socket(it->ai_family, it->ai_socktype | SOCK_CLOEXEC, it->ai_protocol);
+        if (m_fd < 0) {
+            error = errno;
+            continue;
+        }
+        if (bind(m_fd, it->ai_addr, it->ai_addrlen) == 0) {
+            break;
+        }
+        error = errno;
+        close(m_fd);
+        m_fd = -1;
+    }
+    freeaddrinfo(info);
+    if (m_fd < 0) {
+        throw system_error(error, system_category(),
+            "cannot bind UDP socket on port " + service);
+    }
+
+    allocate(max<size_t>(1, batch_size));
+}
+
+UDPReader::~UDPReader()
+{
+    close(m_fd);
+}
+
+void UDPReader::allocate(size_t batch_size)
+{
+    // Room to terminate every line of a datagram with CR/LF: one more byte
+    // per bare LF, and two for an unterminated last line
+    size_t buffer_size = getBufferSize();
+    m_buffers.resize(batch_size * buffer_size);
+    m_sources.resize(batch_size);
+    m_iovecs.reset(new iovec[batch_size]);
+    m_headers.reset(new mmsghdr[batch_size]);
+
+    for (size_t i = 0; i < batch_size; ++i) {
+        m_iovecs[i].iov_base = &m_buffers[i * buffer_size];
+        m_iovecs[i].iov_len = m_datagram_size;
+
+        mmsghdr& header = m_headers[i];
+        memset(&header, 0, sizeof(header));
+        header.msg_hdr.msg_iov = &m_iovecs[i];
+        header.msg_hdr.msg_iovlen = 1;
+        header.msg_hdr.msg_name = &m_sources[i];
+    }
+}
+
+size_t UDPReader::receive(vector<UDPSentence>& sentences, base::Time const& timeout)
+{
+    pollfd pfd = {m_fd, POLLIN, 0};
+    int ret = poll(&pfd, 1, timeout.toMilliseconds());
+    if (ret < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        throw system_error(errno, system_category(), "poll failed");
+    }
+    else if (ret == 0) {
+        return 0;
+    }
+
+    size_t batch_size = m_sources.size();
+    for (size_t i = 0; i < batch_size; ++i) {
+        m_headers[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        m_headers[i].msg_hdr.msg_flags = 0;
+    }
+
+    int count = recvmmsg(m_fd, m_headers.get(), batch_size, MSG_DONTWAIT, nullptr);
+    if (count < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0;
+        }
+        throw system_error(errno, system_category(), "recvmmsg failed");
+    }
+
+    base::Time time = base::Time::now();
+    for (int i = 0; i < count; ++i) {
+        if (m_headers[i].msg_hdr.msg_flags & MSG_TRUNC) {
+            m_stats.truncated_datagrams++;
+        }
+        frameDatagram(i, m_headers[i].msg_len, time, sentences);
+    }
+    m_stats.datagrams += count;
+    return count;
+}
+
+void UDPReader::frameDatagram(size_t index,
+    size_t size,
+    base::Time const& time,
+    vector<UDPSentence>& sentences)
+{
+    size = min(size, m_datagram_size);
+    uint8_t* data = &m_buffers[index * getBufferSize()];
+    if (size == 0) {
+        return;
+    }
+    size = normalizeLineEndings(data, size);
+
+    uint32_t checksum_errors = 0;
+    size_t pos = 0;
+    while (pos < size) {
+        int sentence_size =
+            Driver::extractSentence(data + pos, size - pos, &checksum_errors);
+        if (sentence_size == 0) {
+            // Incomplete sentence at the end of the datagram
+            m_stats.rejected_bytes += size - pos;
+            break;
+        }
+        else if (sentence_size < 0) {
+            m_stats.rejected_bytes += -sentence_size;
+            pos += -sentence_size;
+            continue;
+        }
+
+        UDPSentence sentence;
+        sentence.time = time;
+        sentence.source = &m_sources[index];
+        sentence.data = data + pos;
+        sentence.size = sentence_size;
+        sentences.push_back(sentence);
+        m_stats.sentences++;
+        pos += sentence_size;
+    }
+    m_stats.checksum_errors += checksum_errors;
+}
+
+size_t UDPReader::getBufferSize() const
+{
+    return 2 * m_datagram_size + 2;
+}
+
+size_t UDPReader::normalizeLineEndings(uint8_t* data, size_t size)
+{
+    size_t bare_lf_count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        if (data[i] == '\n' && (i == 0 || data[i - 1] != '\r')) {
+            bare_lf_count++;
+        }
+    }
+
+    // Insert the missing CRs in place, from the end, so that every byte is
+    // read before it gets overwritten
+    size_t read = size;
+    size_t write = size + bare_lf_count;
+    while (write > read) {
+        --read;
+        bool bare_lf = data[read] == '\n' && (read == 0 || data[read - 1] != '\r');
+        data[--write] = data[read];
+        if (bare_lf) {
+            data[--write] = '\r';
+        }
+    }
+    size += bare_lf_count;
+
+    if (data[size - 1] != '\n') {
+        data[size++] = '\r';
+        data[size++] = '\n';
+    }
+    return size;
+}
+
+int UDPReader::getFileDescriptor() const
+{
+    return m_fd;
+}
+
+int UDPReader::getLocalPort() const
+{
+    sockaddr_storage address;
+    socklen_t size = sizeof(address);
+    if (getsockname(m_fd, reinterpret_cast<sockaddr*>(&address), &size) < 0) {
+        throw system_error(errno, system_category(), "getsockname failed");
+    }
+    if (address.ss_family == AF_INET6) {
+        return ntohs(reinterpret_cast<sockaddr_in6 const&>(address).sin6_port);
+    }
+    return ntohs(reinterpret_cast<sockaddr_in const&>(address).sin_port);
+}
+
+void UDPReader::setReceiveBufferSize(int size)
+{
+    if (setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size)) < 0) {
+        throw system_error(errno, system_category(), "cannot set SO_RCVBUF");
+    }
+}
+
+UDPReaderStatistics const& UDPReader::getStatistics() const
+{
+    return m_stats;
+}
+
+string UDPReader::formatAddress(sockaddr_storage const& address)
+{
+    char host[NI_MAXHOST];
+    char service[NI_MAXSERV];
+    socklen_t size = address.ss_family == AF_INET6 ? sizeof(sockaddr_in6)
+                                                   : sizeof(sockaddr_in);
+    int ret = getnameinfo(reinterpret_cast<sockaddr const*>(&address),
+        size,
+        host,
+        sizeof(host),
+        service,
+        sizeof(service),
+        NI_NUMERICHOST | NI_NUMERICSERV);
+    if (ret != 0) {
+        return "<unknown>";
+    }
+    if (address.ss_family == AF_INET6) {
+        return string("[") + host + "]:" + service;
+    }
+    return string(host) + ":" + service;
+}
@@ -0,0 +1,120 @@
+#ifndef NMEA0183_UDP_READER_HPP
+#define NMEA0183_UDP_READER_HPP
+
+#include <base/Time.hpp>
+#include <cstdint>
+#include <memory>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+
+namespace nmea0183 {
+    /** One sentence received by UDPReader
+     *
+     * data and source point into the reader's buffers. They are valid until
+     * the next call to UDPReader::receive
+     */
+    struct UDPSentence {
+        /** Time at which the datagram was received */
+        base::Time time;
+        /** The datagram's sender */
+        sockaddr_storage const* source = nullptr;
+        /** The sentence, including the trailing CR/LF */
+        uint8_t const* data = nullptr;
+        size_t size = 0;
+    };
+
+    struct UDPReaderStatistics {
+        uint64_t datagrams = 0;
+        uint64_t sentences = 0;
+        /** Bytes that were not part of a valid sentence */
+        uint64_t rejected_bytes = 0;
+        uint64_t checksum_errors = 0;
+        /** Datagrams that were bigger than the reader's datagram size */
+        uint64_t truncated_datagrams = 0;
+    };
+
+    /**
+     * Batched reception of NMEA sentences sent over UDP
+     *
+     * Network feeds (e.g. AIS providers) send one or more sentences per
+     * datagram. The reader receives up to a batch of datagrams per system
+     * call with recvmmsg, into preallocated buffers, and frames the
+     * sentences in place with Driver::extractSentence.
+     *
+     * Datagram boundaries are sentence boundaries: a sentence never spans
+     * two datagrams, and the last sentence of a datagram does not need its
+     * trailing CR/LF. Sentences terminated by LF only are accepted.
+     */
+    class UDPReader {
+        int m_fd = -1;
+        size_t m_datagram_size;
+        std::vector<uint8_t> m_buffers;
+        std::vector<sockaddr_storage> m_sources;
+        std::unique_ptr<iovec[]> m_iovecs;
+        std::unique_ptr<mmsghdr[]> m_headers;
+        UDPReaderStatistics m_stats;
+
+        void allocate(size_t batch_size);
+        size_t getBufferSize() const;
+
+        /** Terminate every line with the CR/LF that Driver::extractSentence
+         * expects, in place
+         *
+         * @return the new size, at most twice the original size plus two
+         */
+        static size_t normalizeLineEndings(uint8_t* data, size_t size);
+        void frameDatagram(size_t index, size_t size, base::Time const& time,
+            std::vector<UDPSentence>& sentences);
+
+    public:
+        /** Create a socket bound to the given port
+         *
+         * @param port the UDP port. Use 0 to let the system choose, and
+         *   getLocalPort to know which one was chosen
+         * @param address the local address to bind to. Empty to listen on
+         *   all interfaces
+         * @param batch_size the maximum number of datagrams received per
+         *   system call
+         * @param datagram_size the maximum datagram size. Datagrams that are
+         *   bigger get truncated
+         * @throw std::system_error if the socket cannot be created or bound
+         */
+        explicit UDPReader(int port,
+            std::string const& address = "",
+            size_t batch_size = 64,
+            size_t datagram_size = 2048);
+        ~UDPReader();
+
+        UDPReader(UDPReader const&) = delete;
+        UDPReader& operator=(UDPReader const&) = delete;
+
+        /** Wait for datagrams, and frame the sentences they contain
+         *
+         * @param sentences the received sentences are appended to it. The
+         *   entries of a previous call get invalidated
+         * @param timeout how long to wait for the first datagram
+         * @return the number of datagrams received, zero on timeout
+         * @throw std::system_error on socket errors
+         */
+        size_t receive(std::vector<UDPSentence>& sentences, base::Time const& timeout);
+
+        /** The socket, e.g. to wait on it with select() */
+        int getFileDescriptor() const;
+
+        /** The port the socket is bound to */
+        int getLocalPort() const;
+
+        /** Set the socket's receive buffer size (SO_RCVBUF) */
+        void setReceiveBufferSize(int size);
+
+        UDPReaderStatistics const& getStatistics() const;
+
+        /** Format an address as host:port */
+        static std::string formatAddress(sockaddr_storage const& address);
+    };
+}
+
+#endif
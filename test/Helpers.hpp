@@ -0,0 +1,31 @@
+#ifndef NMEA0183_TEST_HELPERS_HPP
+#define NMEA0183_TEST_HELPERS_HPP
+
+#include <ais_base/Position.hpp>
+
+namespace nmea0183 {
+    namespace test {
+        /** A position report, with the fields the tests do not set left unknown
+         *
+         * @param time in seconds
+         * @param course in degrees, counter-clockwise like all Rock angles. It
+         *   is used as both course over ground and heading
+         */
+        inline ais_base::Position makePosition(int mmsi, double time, double latitude,
+            double longitude, double course = base::unknown<double>(),
+            double speed = base::unknown<double>())
+        {
+            ais_base::Position position;
+            position.mmsi = mmsi;
+            position.time = base::Time::fromSeconds(time);
+            position.latitude = base::Angle::fromDeg(latitude);
+            position.longitude = base::Angle::fromDeg(longitude);
+            position.course_over_ground = base::Angle::fromDeg(course);
+            position.yaw = base::Angle::fromDeg(course);
+            position.speed_over_ground = speed;
+            return position;
+        }
+    }
+}
+
+#endif
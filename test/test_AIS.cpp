@@ -90,6 +90,151 @@ TEST_F(AISTest, it_drops_a_sentence_that_do_not_start_a_multisentence_message)
     ASSERT_EQ(1, ais.getDiscardedSentenceCount());
 }
 
+TEST_F(AISTest, tryReadMessage_returns_a_message_once_all_its_fragments_are_received)
+{
+    pushStringToDriver(ais_strings[0]);
+    ASSERT_EQ(nullptr, ais.tryReadMessage());
+    ASSERT_EQ(1, ais.getPendingFragmentCount());
+
+    pushStringToDriver(ais_strings[1]);
+    auto msg = ais.tryReadMessage();
+    ASSERT_EQ(marnav::ais::message_id::static_and_voyage_related_data, msg->type());
+    ASSERT_EQ(nullptr, ais.tryReadMessage());
+}
+
+TEST_F(AISTest, it_exposes_the_TAG_block_of_the_sentence_that_completed_the_message)
+{
+    pushStringToDriver("\\s:r003669945,c:1241544035*79\\"
+                       "!AIVDM,1,1,,B,15N4cJ`005Jrek0H@9nDW5608EP,0*73\r\n");
+    ais.readMessage();
+    ASSERT_TRUE(ais.getTagBlock().valid);
+    ASSERT_EQ("r003669945", ais.getTagBlock().source);
+    ASSERT_EQ(base::Time::fromSeconds(1241544035), ais.getTagBlock().time);
+
+    pushStringToDriver("!AIVDM,1,1,,B,15N4cJ`005Jrek0H@9nDW5608EP,0*73\r\n");
+    ASSERT_TRUE(ais.tryReadMessage());
+    ASSERT_FALSE(ais.getTagBlock().valid);
+}
+
+static std::pair<uint8_t const*, size_t> toBuffer(std::string const& sentence)
+{
+    return {reinterpret_cast<uint8_t const*>(sentence.data()), sentence.size()};
+}
+
+TEST_F(AISTest, it_reassembles_framed_sentences_without_parsing_them)
+{
+    AIS::Payloads payloads;
+    auto [buffer0, size0] = toBuffer(ais_strings[0]);
+    ASSERT_FALSE(ais.reassemble(buffer0, size0, payloads));
+    auto [buffer1, size1] = toBuffer(ais_strings[1]);
+    ASSERT_TRUE(ais.reassemble(buffer1, size1, payloads));
+
+    ASSERT_EQ(2, payloads.size());
+    ASSERT_EQ("55P5TL01VIaAL@7WKO@mBplU@<PDhh000000001S;AJ::4A80?4i@E53",
+        payloads[0].first);
+    ASSERT_EQ(0, payloads[0].second);
+    ASSERT_EQ("1@0000000000000", payloads[1].first);
+    ASSERT_EQ(2, payloads[1].second);
+    ASSERT_EQ(0, ais.getPendingFragmentCount());
+}
+
+TEST_F(AISTest, it_reuses_the_payloads_storage_for_single_fragment_messages)
+{
+    std::string sentence = "\\s:r003669945,c:1241544035*4A\\"
+                           "!AIVDM,1,1,,B,15N4cJ`005Jrek0H@9nDW5608EP,0*13\r\n";
+    AIS::Payloads payloads = {{std::string(64, 'x'), 4}, {"y", 2}};
+    char const* storage = payloads[0].first.data();
+
+    auto [buffer, size] = toBuffer(sentence);
+    ASSERT_TRUE(ais.reassemble(buffer, size, payloads));
+    ASSERT_EQ(1, payloads.size());
+    ASSERT_EQ("15N4cJ`005Jrek0H@9nDW5608EP", payloads[0].first);
+    ASSERT_EQ(0, payloads[0].second);
+    ASSERT_EQ(storage, payloads[0].first.data());
+}
+
+TEST_F(AISTest, it_ignores_framed_sentences_that_are_not_VDM)
+{
+    AIS::Payloads payloads;
+    std::string sentence = "$HEHDT,274.07,T*19\r\n";
+    auto [buffer, size] = toBuffer(sentence);
+    ASSERT_FALSE(ais.reassemble(buffer, size, payloads));
+    ASSERT_EQ(0, ais.getDiscardedSentenceCount());
+}
+
+TEST_F(AISTest, it_throws_MarnavParsingError_if_the_VDM_fields_of_a_framed_sentence_are_invalid)
+{
+    AIS::Payloads payloads;
+    std::string missing_field = "!AIVDM,1,1,,B,15N4cJ`005Jrek0H@9nDW5608EP*00\r\n";
+    auto [buffer0, size0] = toBuffer(missing_field);
+    ASSERT_THROW(ais.reassemble(buffer0, size0, payloads), MarnavParsingError);
+    std::string invalid_number = "!AIVDM,1,X,,B,15N4cJ`005Jrek0H@9nDW5608EP,0*00\r\n";
+    auto [buffer1, size1] = toBuffer(invalid_number);
+    ASSERT_THROW(ais.reassemble(buffer1, size1, payloads), MarnavParsingError);
+}
+
+TEST_F(AISTest, framed_reassembly_discards_fragments_that_do_not_follow_each_other)
+{
+    AIS::Payloads payloads;
+    auto [buffer0, size0] = toBuffer(ais_strings[0]);
+    auto [buffer1, size1] = toBuffer(ais_strings[1]);
+    ASSERT_FALSE(ais.reassemble(buffer1, size1, payloads));
+    ASSERT_FALSE(ais.reassemble(buffer0, size0, payloads));
+    ASSERT_FALSE(ais.reassemble(buffer0, size0, payloads));
+    ASSERT_TRUE(ais.reassemble(buffer1, size1, payloads));
+    ASSERT_EQ(2, ais.getDiscardedSentenceCount());
+}
+
+TEST_F(AISTest, it_joins_the_parts_of_class_B_static_data_reports)
+{
+    ais::message_24 part_a;
+    part_a.set_mmsi(utils::mmsi(227006760));
+    part_a.set_part_number(ais::message_24::part::A);
+    part_a.set_shipname("SAILING   ");
+    ais::message_24 part_b;
+    part_b.set_mmsi(utils::mmsi(227006760));
+    part_b.set_part_number(ais::message_24::part::B);
+    part_b.set_callsign("FABC   ");
+    part_b.set_shiptype(ais::ship_type::sailing);
+    part_b.set_to_bow(8);
+    part_b.set_to_stern(4);
+    part_b.set_to_port(1);
+    part_b.set_to_starboard(3);
+
+    ais_base::VesselInformation info;
+    ASSERT_FALSE(ais.processStaticDataReport(part_a, info));
+    ASSERT_TRUE(ais.processStaticDataReport(part_b, info));
+    ASSERT_EQ(227006760, info.mmsi);
+    ASSERT_EQ("SAILING", info.name);
+    ASSERT_EQ("FABC", info.call_sign);
+    ASSERT_EQ(ais_base::SHIP_TYPE_SAILING, info.ship_type);
+    ASSERT_FLOAT_EQ(12, info.length);
+    ASSERT_FLOAT_EQ(4, info.width);
+    ASSERT_FLOAT_EQ(-2, info.reference_position.x());
+    ASSERT_FLOAT_EQ(1, info.reference_position.y());
+    ASSERT_EQ(1, ais.getStaticDataCache().size());
+}
+
+TEST_F(AISTest, it_drops_the_messages_outside_of_the_geofence_before_decoding_them)
+{
+    // Type 1 at lat 47.582833, lon -122.345832, and type 5
+    std::string position = "!AIVDM,1,1,,A,177KQJ5000G?tO`K>RA1wUbN0TKH,0*5F\r\n";
+    auto [position_buffer, position_size] = toBuffer(position);
+    auto [static_buffer0, static_size0] = toBuffer(ais_strings[0]);
+    auto [static_buffer1, static_size1] = toBuffer(ais_strings[1]);
+
+    AIS::Payloads payloads;
+    ais.getGeofence().addBoundingBox(48, -123, 49, -122);
+    ASSERT_FALSE(ais.reassemble(position_buffer, position_size, payloads));
+    ASSERT_EQ(1, ais.getGeofenceRejectedCount());
+    ASSERT_FALSE(ais.reassemble(static_buffer0, static_size0, payloads));
+    ASSERT_TRUE(ais.reassemble(static_buffer1, static_size1, payloads));
+
+    ais.getGeofence().addBoundingBox(47, -123, 48, -122);
+    ASSERT_TRUE(ais.reassemble(position_buffer, position_size, payloads));
+    ASSERT_EQ(1, ais.getGeofenceRejectedCount());
+}
+
 TEST_F(AISTest, it_converts_marnav_message01_into_a_Position)
 {
     ais::message_01 msg;
@@ -499,6 +644,18 @@ TEST_F(AISTest, it_converts_Position_into_a_message01)
     ASSERT_EQ(message.get_radio_status(), 12345);
 }
 
+TEST_F(AISTest, it_converts_Position_angles_above_180_degrees_into_a_message01)
+{
+    ais_base::Position position;
+    position.course_over_ground = base::Angle::fromDeg(270);
+    position.yaw = base::Angle::fromDeg(200);
+
+    auto message = AIS::getMessageFromPosition(position);
+
+    ASSERT_NEAR(message.get_cog().value(), 270, 1e-6);
+    ASSERT_EQ(message.get_hdg().value(), 200);
+}
+
 TEST_F(AISTest,
     it_handles_unset_values_in_VesselInformation_when_converting_into_message05)
 {
@@ -540,3 +697,18 @@ TEST_F(AISTest, it_handles_unset_values_in_Position_when_converting_into_message
     ASSERT_FALSE(message.get_raim());
     ASSERT_EQ(message.get_radio_status(), 0);
 }
+
+TEST_F(AISTest, it_converts_the_rate_of_turn_of_message01_to_rock_convention)
+{
+    ais::message_01 msg;
+    msg.set_rot(ais::rate_of_turn(10.0));
+    ASSERT_NEAR(-10 * M_PI / 180 / 60, AIS::getRateOfTurn(msg), 1e-9);
+}
+
+TEST_F(AISTest, it_returns_an_unknown_rate_of_turn_if_message01_does_not_have_one)
+{
+    ais::message_01 msg;
+    ASSERT_TRUE(base::isUnknown(AIS::getRateOfTurn(msg)));
+    msg.set_rot(ais::rate_of_turn(static_cast<ais::rate_of_turn::value_type>(127)));
+    ASSERT_TRUE(base::isUnknown(AIS::getRateOfTurn(msg)));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <nmea0183/AISGeofence.hpp>
+#include <random>
+
+using namespace std;
+using namespace nmea0183;
+
+// Example from https://gpsd.gitlab.io/gpsd/AIVDM.html
+// MMSI 477553000, lon -122.345832, lat 47.582833
+static const string position_report = "177KQJ5000G?tO`K>RA1wUbN0TKH";
+
+/** An L-shaped, i.e. concave, area */
+static vector<GeofencePoint> makeLShape()
+{
+    return {{0, 0}, {0, 2}, {1, 2}, {1, 1}, {2, 1}, {2, 0}};
+}
+
+TEST(AISGeofenceTest, it_contains_the_points_inside_a_bounding_box)
+{
+    AISGeofence geofence;
+    geofence.addBoundingBox(47, -123, 48, -122);
+    ASSERT_TRUE(geofence.contains(47.5, -122.5));
+    ASSERT_FALSE(geofence.contains(48.5, -122.5));
+    ASSERT_FALSE(geofence.contains(47.5, -121.5));
+}
+
+TEST(AISGeofenceTest, it_handles_concave_polygons)
+{
+    AISGeofence geofence;
+    geofence.addPolygon(makeLShape());
+    ASSERT_TRUE(geofence.contains(0.5, 1.5));
+    ASSERT_TRUE(geofence.contains(1.5, 0.5));
+    ASSERT_FALSE(geofence.contains(1.5, 1.5));
+}
+
+TEST(AISGeofenceTest, it_contains_the_union_of_its_areas)
+{
+    AISGeofence geofence;
+    geofence.addBoundingBox(0, 0, 1, 1);
+    geofence.addBoundingBox(10, 10, 11, 11);
+    ASSERT_TRUE(geofence.contains(0.5, 0.5));
+    ASSERT_TRUE(geofence.contains(10.5, 10.5));
+    ASSERT_FALSE(geofence.contains(5, 5));
+}
+
+TEST(AISGeofenceTest, the_grid_gives_the_same_result_as_the_exact_test)
+{
+    // A single-cell grid always falls back to the exact test
+    AISGeofence exact(1);
+    AISGeofence geofence(16);
+    auto shape = makeLShape();
+    exact.addPolygon(shape);
+    geofence.addPolygon(shape);
+    for (auto& vertex : shape) {
+        vertex.latitude += 1.3;
+        vertex.longitude += 0.7;
+    }
+    exact.addPolygon(shape);
+    geofence.addPolygon(shape);
+
+    mt19937 rng(42);
+    uniform_real_distribution<double> distribution(-0.5, 4);
+    for (int i = 0; i < 100000; ++i) {
+        double latitude = distribution(rng);
+        double longitude = distribution(rng);
+        ASSERT_EQ(exact.contains(latitude, longitude),
+            geofence.contains(latitude, longitude))
+            << latitude << " " << longitude;
+    }
+}
+
+TEST(AISGeofenceTest, it_does_not_contain_NaN)
+{
+    AISGeofence geofence;
+    geofence.addBoundingBox(0, 0, 1, 1);
+    ASSERT_FALSE(geofence.contains(NAN, 0.5));
+    ASSERT_FALSE(geofence.contains(0.5, NAN));
+}
+
+TEST(AISGeofenceTest, it_rejects_invalid_areas)
+{
+    AISGeofence geofence;
+    ASSERT_THROW(geofence.addBoundingBox(1, 0, 0, 1), invalid_argument);
+    ASSERT_THROW(geofence.addPolygon({{0, 0}, {1, 1}}), invalid_argument);
+    ASSERT_THROW(AISGeofence(0), invalid_argument);
+}
+
+TEST(AISGeofenceTest, it_accepts_everything_when_empty)
+{
+    AISGeofence geofence;
+    ASSERT_TRUE(geofence.isEmpty());
+    ASSERT_TRUE(geofence.accept(position_report));
+}
+
+TEST(AISGeofenceTest, it_accepts_position_reports_inside_the_area)
+{
+    AISGeofence geofence;
+    geofence.addBoundingBox(47, -123, 48, -122);
+    ASSERT_TRUE(geofence.accept(position_report));
+}
+
+TEST(AISGeofenceTest, it_rejects_position_reports_outside_the_area)
+{
+    AISGeofence geofence;
+    geofence.addBoundingBox(48, -123, 49, -122);
+    ASSERT_FALSE(geofence.accept(position_report));
+}
+
+TEST(AISGeofenceTest, it_accepts_messages_without_position)
+{
+    AISGeofence geofence;
+    geofence.addBoundingBox(48, -123, 49, -122);
+    ASSERT_TRUE(geofence.accept("55P5TL01VIaAL@7WKO@mBplU@<PDhh000000001S;AJ::4A80?4i@E53"));
+}
@@ -0,0 +1,82 @@
+#include <cmath>
+#include <gtest/gtest.h>
+#include <nmea0183/AISPayload.hpp>
+
+using namespace std;
+using namespace nmea0183;
+
+// Example from https://gpsd.gitlab.io/gpsd/AIVDM.html
+// MMSI 477553000, lon -122.345832, lat 47.582833, COG 51, heading 181
+static const string position_report = "177KQJ5000G?tO`K>RA1wUbN0TKH";
+
+TEST(AISPayloadTest, it_extracts_the_message_type)
+{
+    ASSERT_EQ(1, AISPayload::getMessageType(position_report));
+}
+
+TEST(AISPayloadTest, it_returns_a_message_type_of_zero_for_an_empty_payload)
+{
+    ASSERT_EQ(0, AISPayload::getMessageType(""));
+}
+
+TEST(AISPayloadTest, it_extracts_the_MMSI)
+{
+    ASSERT_EQ(477553000, AISPayload::getMMSI(position_report));
+}
+
+TEST(AISPayloadTest, it_returns_an_MMSI_of_zero_if_the_payload_is_too_short)
+{
+    ASSERT_EQ(0, AISPayload::getMMSI("177KQJ"));
+}
+
+TEST(AISPayloadTest, it_extracts_signed_fields)
+{
+    ASSERT_NEAR(-122.345832, AISPayload::getSigned(position_report, 61, 28) / 600000.0, 1e-5);
+    ASSERT_NEAR(47.582833, AISPayload::getSigned(position_report, 89, 27) / 600000.0, 1e-5);
+}
+
+TEST(AISPayloadTest, it_extracts_unsigned_fields_that_are_not_aligned_on_characters)
+{
+    ASSERT_EQ(510, AISPayload::getUnsigned(position_report, 116, 12));
+    ASSERT_EQ(181, AISPayload::getUnsigned(position_report, 128, 9));
+}
+
+TEST(AISPayloadTest, it_throws_if_the_field_is_outside_the_payload)
+{
+    ASSERT_THROW(AISPayload::getUnsigned(position_report, 160, 9), out_of_range);
+}
+
+TEST(AISPayloadTest, it_rejects_empty_and_oversized_fields)
+{
+    ASSERT_THROW(AISPayload::getUnsigned(position_report, 0, 0), invalid_argument);
+    ASSERT_THROW(AISPayload::getUnsigned(position_report, 0, 33), invalid_argument);
+}
+
+TEST(AISPayloadTest, it_extracts_the_position_of_a_position_report)
+{
+    double latitude;
+    double longitude;
+    ASSERT_TRUE(AISPayload::getPosition(position_report, latitude, longitude));
+    ASSERT_NEAR(47.582833, latitude, 1e-5);
+    ASSERT_NEAR(-122.345832, longitude, 1e-5);
+}
+
+TEST(AISPayloadTest, it_returns_NaN_for_an_unavailable_position)
+{
+    // Type 1 with longitude 181 and latitude 91
+    string payload = "1000000000<tSF0l4Q@000000000";
+    double latitude;
+    double longitude;
+    ASSERT_TRUE(AISPayload::getPosition(payload, latitude, longitude));
+    ASSERT_TRUE(std::isnan(latitude));
+    ASSERT_TRUE(std::isnan(longitude));
+}
+
+TEST(AISPayloadTest, it_does_not_extract_a_position_from_other_messages)
+{
+    double latitude;
+    double longitude;
+    ASSERT_FALSE(AISPayload::getPosition(
+        "55P5TL01VIaAL@7WKO@mBplU@<PDhh000000001S;AJ::4A80?4i@E53", latitude, longitude));
+    ASSERT_FALSE(AISPayload::getPosition("177KQJ5000G?tO`K>R", latitude, longitude));
+}
@@ -0,0 +1,169 @@
+#include <condition_variable>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <map>
+#include <mutex>
+#include <nmea0183/AISPipeline.hpp>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+
+struct AISPipelineTest : public ::testing::Test, public iodrivers_base::Fixture<Driver> {
+    mutex lock;
+    condition_variable signal;
+    vector<pair<uint32_t, ais::message_id>> received;
+
+    AISPipelineTest()
+    {
+        driver.setReadTimeout(base::Time::fromMilliseconds(10));
+    }
+
+    void pushStringToDriver(string const& msg)
+    {
+        uint8_t const* msg_u8 = reinterpret_cast<uint8_t const*>(msg.c_str());
+        pushDataToDriver(msg_u8, msg_u8 + msg.size());
+    }
+
+    AISPipeline::Callback callback()
+    {
+        return [this](AISPipelineOutput& output) {
+            lock_guard<mutex> guard(lock);
+            received.emplace_back(output.mmsi, output.message->type());
+            signal.notify_all();
+        };
+    }
+
+    bool waitForMessages(size_t count)
+    {
+        unique_lock<mutex> guard(lock);
+        return signal.wait_for(guard, chrono::seconds(10), [&] {
+            return received.size() >= count;
+        });
+    }
+};
+
+static string armor(vector<bool> const& bits)
+{
+    string payload;
+    for (size_t i = 0; i < bits.size(); i += 6) {
+        uint8_t value = 0;
+        for (size_t j = i; j < i + 6; ++j) {
+            value = (value << 1) | (j < bits.size() && bits[j]);
+        }
+        payload.push_back(value < 40 ? value + 48 : value + 56);
+    }
+    return payload;
+}
+
+static void appendBits(vector<bool>& bits, uint32_t value, size_t count)
+{
+    for (size_t i = 0; i < count; ++i) {
+        bits.push_back((value >> (count - i - 1)) & 1);
+    }
+}
+
+/** A single-fragment position report of the given type (1, 2 or 3) */
+static string positionReport(uint32_t type, uint32_t mmsi)
+{
+    vector<bool> bits;
+    appendBits(bits, type, 6);
+    appendBits(bits, 0, 2);
+    appendBits(bits, mmsi, 30);
+    appendBits(bits, 0, 4 + 8 + 10 + 1);
+    appendBits(bits, 181 * 600000, 28);
+    appendBits(bits, 91 * 600000, 27);
+    appendBits(bits, 3600, 12);
+    appendBits(bits, 511, 9);
+    appendBits(bits, 0, 6 + 2 + 3 + 1 + 19);
+
+    string body = "AIVDM,1,1,,A," + armor(bits) + ",0";
+    uint8_t checksum = 0;
+    for (char c : body) {
+        checksum ^= c;
+    }
+    char checksum_str[3];
+    snprintf(checksum_str, sizeof(checksum_str), "%02X", checksum);
+    return "!" + body + "*" + checksum_str + "\r\n";
+}
+
+TEST_F(AISPipelineTest, it_delivers_the_messages_of_each_vessel_in_reception_order)
+{
+    // The message type is used as a marker of the reception order
+    map<uint32_t, vector<ais::message_id>> expected;
+    for (int i = 0; i < 200; ++i) {
+        uint32_t mmsi = 100000000 + i % 7;
+        uint32_t type = 1 + (i * 7 + i / 7) % 3;
+        pushStringToDriver(positionReport(type, mmsi));
+        expected[mmsi].push_back(static_cast<ais::message_id>(type));
+    }
+
+    AISPipeline pipeline(driver, callback(), 4);
+    pipeline.start();
+    ASSERT_TRUE(waitForMessages(200));
+    pipeline.stop();
+
+    map<uint32_t, vector<ais::message_id>> actual;
+    for (auto const& r : received) {
+        actual[r.first].push_back(r.second);
+    }
+    ASSERT_EQ(expected, actual);
+
+    auto stats = pipeline.getStatistics();
+    ASSERT_EQ(200, stats.sentences);
+    ASSERT_EQ(200, stats.messages);
+    ASSERT_EQ(0, stats.decode_errors);
+}
+
+TEST_F(AISPipelineTest, it_reassembles_multi_fragment_messages)
+{
+    pushStringToDriver(
+        "!AIVDM,2,1,3,B,55P5TL01VIaAL@7WKO@mBplU@<PDhh000000001S;AJ::4A80?4i@E53,0*3E\r\n");
+    pushStringToDriver("!AIVDM,2,2,3,B,1@0000000000000,2*55\r\n");
+
+    AISPipeline pipeline(driver, callback(), 2);
+    pipeline.start();
+    ASSERT_TRUE(waitForMessages(1));
+    pipeline.stop();
+
+    ASSERT_EQ(369190000, received[0].first);
+    ASSERT_EQ(ais::message_id::static_and_voyage_related_data, received[0].second);
+}
+
+TEST_F(AISPipelineTest, it_skips_messages_that_cannot_be_decoded_without_blocking_the_vessel)
+{
+    // Type 5 message that is too short
+    pushStringToDriver("!AIVDM,1,1,,B,55P5TL01VIaAL@7WKO@mBplU@<PD,0*40\r\n");
+    pushStringToDriver(positionReport(1, 369190000));
+
+    AISPipeline pipeline(driver, callback(), 2);
+    pipeline.start();
+    ASSERT_TRUE(waitForMessages(1));
+    pipeline.stop();
+
+    ASSERT_EQ(1, received.size());
+    ASSERT_EQ(ais::message_id::position_report_class_a, received[0].second);
+    ASSERT_EQ(1, pipeline.getStatistics().decode_errors);
+}
+
+TEST_F(AISPipelineTest, it_rethrows_errors_raised_by_the_callback_on_stop)
+{
+    pushStringToDriver(positionReport(1, 369190000));
+
+    bool called = false;
+    AISPipeline pipeline(driver, [&](AISPipelineOutput&) {
+        {
+            lock_guard<mutex> guard(lock);
+            called = true;
+        }
+        signal.notify_all();
+        throw runtime_error("callback error");
+    });
+    pipeline.start();
+    {
+        unique_lock<mutex> guard(lock);
+        ASSERT_TRUE(signal.wait_for(guard, chrono::seconds(10), [&] { return called; }));
+    }
+    ASSERT_THROW(pipeline.stop(), runtime_error);
+}
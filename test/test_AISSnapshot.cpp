@@ -0,0 +1,136 @@
+#include <fstream>
+#include <gtest/gtest.h>
+#include <nmea0183/AISSnapshot.hpp>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+struct AISSnapshotTest : public ::testing::Test {
+    string path;
+    AISTargetState state;
+    AIS ais;
+    base::Time snapshot_time = base::Time::fromSeconds(10000);
+
+    AISSnapshotTest()
+        : path("/tmp/nmea0183_test_snapshot." + to_string(getpid()))
+    {
+    }
+
+    ~AISSnapshotTest()
+    {
+        unlink(path.c_str());
+    }
+
+    void addPosition(int mmsi, double age)
+    {
+        ais_base::Position position;
+        position.mmsi = mmsi;
+        position.time = snapshot_time - base::Time::fromSeconds(age);
+        position.latitude = base::Angle::fromDeg(48);
+        position.longitude = base::Angle::fromDeg(-4);
+        state.update(position);
+    }
+
+    void addVesselInformation(int mmsi, double age)
+    {
+        ais_base::VesselInformation info;
+        info.mmsi = mmsi;
+        info.time = snapshot_time - base::Time::fromSeconds(age);
+        info.name = "VESSEL " + to_string(mmsi);
+        state.update(info);
+    }
+};
+
+TEST_F(AISSnapshotTest, it_restores_the_targets)
+{
+    addPosition(1, 10);
+    addVesselInformation(1, 20);
+    addVesselInformation(2, 30);
+    AISSnapshot::save(path, state, ais, snapshot_time);
+
+    AISTargetState restored;
+    AIS restored_ais;
+    auto stats = AISSnapshot::load(path, restored, restored_ais, snapshot_time);
+    ASSERT_EQ(snapshot_time, stats.time);
+    ASSERT_EQ(2, stats.restored_targets);
+    ASSERT_EQ(0, stats.expired_targets);
+    ASSERT_EQ(2, restored.size());
+
+    ais_base::Position position;
+    ASSERT_TRUE(restored.getPosition(1, position));
+    ASSERT_EQ(snapshot_time - base::Time::fromSeconds(10), position.time);
+    ASSERT_DOUBLE_EQ(48, position.latitude.getDeg());
+    ais_base::VesselInformation info;
+    ASSERT_TRUE(restored.getVesselInformation(2, info));
+    ASSERT_EQ("VESSEL 2", info.name);
+}
+
+TEST_F(AISSnapshotTest, it_drops_the_data_that_is_too_old_when_loaded)
+{
+    addPosition(1, 10);
+    addVesselInformation(1, 10);
+    addPosition(2, 10);
+    addVesselInformation(3, 10);
+    AISSnapshot::save(path, state, ais, snapshot_time);
+
+    AISSnapshotAging aging;
+    aging.max_position_age = base::Time::fromSeconds(60);
+    aging.max_vessel_information_age = base::Time::fromSeconds(600);
+    AISTargetState restored;
+    auto stats = AISSnapshot::load(
+        path, restored, ais, snapshot_time + base::Time::fromSeconds(100), aging);
+
+    ASSERT_EQ(2, stats.restored_targets);
+    ASSERT_EQ(1, stats.expired_targets);
+    ais_base::Position position;
+    ais_base::VesselInformation info;
+    ASSERT_FALSE(restored.getPosition(1, position));
+    ASSERT_TRUE(restored.getVesselInformation(1, info));
+    ASSERT_EQ(nullptr, restored.get(2));
+    ASSERT_TRUE(restored.getVesselInformation(3, info));
+}
+
+TEST_F(AISSnapshotTest, it_restores_the_pending_fragments_of_a_recent_snapshot)
+{
+    AIS::Payloads fragments = {{"55NBjP01mtGIL@CW;SM<D60P5Ld000000000000P0", 0}};
+    ais.setPendingFragments(fragments);
+    AISSnapshot::save(path, state, ais, snapshot_time);
+
+    AIS restored;
+    auto stats = AISSnapshot::load(
+        path, state, restored, snapshot_time + base::Time::fromSeconds(1));
+    ASSERT_EQ(1, stats.restored_fragments);
+    ASSERT_EQ(fragments, restored.getPendingFragments());
+}
+
+TEST_F(AISSnapshotTest, it_drops_the_pending_fragments_of_an_old_snapshot)
+{
+    ais.setPendingFragments({{"55NBjP01mtGIL@CW;SM<D60P5Ld000000000000P0", 0}});
+    AISSnapshot::save(path, state, ais, snapshot_time);
+
+    AIS restored;
+    auto stats = AISSnapshot::load(
+        path, state, restored, snapshot_time + base::Time::fromSeconds(60));
+    ASSERT_EQ(0, stats.restored_fragments);
+    ASSERT_EQ(0, restored.getPendingFragmentCount());
+}
+
+TEST_F(AISSnapshotTest, it_rejects_a_file_that_is_not_a_snapshot)
+{
+    ofstream(path) << "this is not a snapshot, but is long enough for a header";
+    ASSERT_THROW(AISSnapshot::load(path, state, ais), invalid_argument);
+}
+
+TEST_F(AISSnapshotTest, it_rejects_a_truncated_snapshot_without_changing_the_state)
+{
+    addPosition(1, 10);
+    addPosition(2, 10);
+    ais.setPendingFragments({{"55NBjP01mtGIL@CW;SM<D60P5Ld000000000000P0", 0}});
+    AISSnapshot::save(path, state, ais, snapshot_time);
+    truncate(path.c_str(), 40 + 2 * sizeof(AISTargetRecord) + 10);
+
+    AISTargetState restored;
+    ASSERT_THROW(AISSnapshot::load(path, restored, ais, snapshot_time), invalid_argument);
+    ASSERT_EQ(0, restored.size());
+}
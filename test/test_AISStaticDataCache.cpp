@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <nmea0183/AISStaticDataCache.hpp>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+
+static ais::message_24 makePartA(int mmsi, string const& name)
+{
+    ais::message_24 message;
+    message.set_mmsi(utils::mmsi(mmsi));
+    message.set_part_number(ais::message_24::part::A);
+    message.set_shipname(name);
+    return message;
+}
+
+static ais::message_24 makePartB(int mmsi, string const& call_sign)
+{
+    ais::message_24 message;
+    message.set_mmsi(utils::mmsi(mmsi));
+    message.set_part_number(ais::message_24::part::B);
+    message.set_callsign(call_sign);
+    message.set_to_bow(8);
+    message.set_to_stern(4);
+    message.set_to_port(2);
+    message.set_to_starboard(2);
+    return message;
+}
+
+static base::Time at(double seconds)
+{
+    return base::Time::fromSeconds(seconds);
+}
+
+TEST(AISStaticDataCacheTest, it_joins_parts_A_and_B)
+{
+    AISStaticDataCache cache;
+    ais_base::VesselInformation info;
+    ASSERT_FALSE(cache.process(makePartA(227006760, "SAILING   "), at(10), info));
+    ASSERT_TRUE(cache.process(makePartB(227006760, "FABC   "), at(15), info));
+
+    ASSERT_EQ(227006760, info.mmsi);
+    ASSERT_EQ(at(15), info.time);
+    ASSERT_EQ("SAILING", info.name);
+    ASSERT_EQ("FABC", info.call_sign);
+    ASSERT_FLOAT_EQ(12, info.length);
+    ASSERT_FLOAT_EQ(4, info.width);
+    ASSERT_FLOAT_EQ(-2, info.reference_position.x());
+    ASSERT_FLOAT_EQ(0, info.reference_position.y());
+}
+
+TEST(AISStaticDataCacheTest, it_joins_in_any_order)
+{
+    AISStaticDataCache cache;
+    ais_base::VesselInformation info;
+    ASSERT_FALSE(cache.process(makePartB(227006760, "FABC"), at(10), info));
+    ASSERT_TRUE(cache.process(makePartA(227006760, "SAILING"), at(15), info));
+    ASSERT_EQ("SAILING", info.name);
+    ASSERT_EQ("FABC", info.call_sign);
+}
+
+TEST(AISStaticDataCacheTest, it_does_not_join_parts_of_different_vessels)
+{
+    AISStaticDataCache cache;
+    ais_base::VesselInformation info;
+    ASSERT_FALSE(cache.process(makePartA(227006760, "SAILING"), at(10), info));
+    ASSERT_FALSE(cache.process(makePartB(227006761, "FABC"), at(15), info));
+    ASSERT_EQ(2, cache.size());
+}
+
+TEST(AISStaticDataCacheTest, it_emits_updates_once_both_parts_are_known)
+{
+    AISStaticDataCache cache;
+    ais_base::VesselInformation info;
+    cache.process(makePartA(227006760, "SAILING"), at(10), info);
+    cache.process(makePartB(227006760, "FABC"), at(15), info);
+    ASSERT_TRUE(cache.process(makePartA(227006760, "RENAMED"), at(370), info));
+    ASSERT_EQ("RENAMED", info.name);
+    ASSERT_EQ("FABC", info.call_sign);
+}
+
+TEST(AISStaticDataCacheTest, it_does_not_join_a_part_older_than_the_max_age)
+{
+    AISStaticDataCache cache(16, base::Time::fromSeconds(60));
+    ais_base::VesselInformation info;
+    cache.process(makePartA(227006760, "SAILING"), at(10), info);
+    ASSERT_FALSE(cache.process(makePartB(227006760, "FABC"), at(75), info));
+    ASSERT_EQ(1, cache.getExpiredCount());
+    ASSERT_EQ(1, cache.size());
+}
+
+TEST(AISStaticDataCacheTest, it_does_not_join_a_stale_part_of_a_live_entry)
+{
+    AISStaticDataCache cache(16, base::Time::fromSeconds(60));
+    ais_base::VesselInformation info;
+    cache.process(makePartA(227006760, "SAILING"), at(10), info);
+    cache.process(makePartB(227006760, "FABC"), at(20), info);
+    ASSERT_FALSE(cache.process(makePartB(227006760, "FABC"), at(75), info));
+    ASSERT_TRUE(cache.process(makePartA(227006760, "SAILING"), at(80), info));
+}
+
+TEST(AISStaticDataCacheTest, it_evicts_the_least_recently_updated_entry_when_full)
+{
+    AISStaticDataCache cache(2);
+    ais_base::VesselInformation info;
+    cache.process(makePartA(1, "ONE"), at(10), info);
+    cache.process(makePartA(2, "TWO"), at(11), info);
+    cache.process(makePartB(1, "F1"), at(12), info);
+    cache.process(makePartA(3, "THREE"), at(13), info);
+
+    ASSERT_EQ(2, cache.size());
+    ASSERT_EQ(1, cache.getEvictedCount());
+    ASSERT_TRUE(cache.process(makePartA(1, "ONE"), at(14), info));
+    ASSERT_FALSE(cache.process(makePartB(2, "F2"), at(15), info));
+}
+
+TEST(AISStaticDataCacheTest, it_evicts_entries_when_the_max_size_is_reduced)
+{
+    AISStaticDataCache cache;
+    ais_base::VesselInformation info;
+    for (int i = 0; i < 10; ++i) {
+        cache.process(makePartA(i + 1, "VESSEL"), at(i), info);
+    }
+    cache.setMaxSize(4);
+    ASSERT_EQ(4, cache.size());
+    ASSERT_EQ(6, cache.getEvictedCount());
+    ASSERT_THROW(cache.setMaxSize(0), invalid_argument);
+}
+
+TEST(AISStaticDataCacheTest, it_removes_entries_older_than_a_given_time)
+{
+    AISStaticDataCache cache;
+    ais_base::VesselInformation info;
+    cache.process(makePartA(1, "ONE"), at(10), info);
+    cache.process(makePartA(2, "TWO"), at(20), info);
+    cache.process(makePartB(1, "F1"), at(30), info);
+
+    ASSERT_EQ(1, cache.removeOlderThan(at(25)));
+    ASSERT_EQ(1, cache.size());
+    ASSERT_TRUE(cache.process(makePartA(1, "ONE"), at(35), info));
+}
+
+TEST(AISStaticDataCacheTest, it_does_not_set_the_dimensions_of_auxiliary_craft)
+{
+    AISStaticDataCache cache;
+    ais_base::VesselInformation info;
+    cache.process(makePartA(981234567, "TENDER"), at(10), info);
+    ASSERT_TRUE(cache.process(makePartB(981234567, "FABC"), at(15), info));
+    ASSERT_EQ("FABC", info.call_sign);
+    ASSERT_FLOAT_EQ(0, info.length);
+}
@@ -0,0 +1,172 @@
+#include "Helpers.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <nmea0183/AISTargetIndex.hpp>
+#include <random>
+
+using namespace std;
+using namespace nmea0183;
+using test::makePosition;
+
+static vector<int> getMMSIs(vector<ais_base::Position> const& positions)
+{
+    vector<int> result;
+    for (auto const& p : positions) {
+        result.push_back(p.mmsi);
+    }
+    sort(result.begin(), result.end());
+    return result;
+}
+
+static vector<int> queryRadius(AISTargetIndex const& index,
+    double latitude, double longitude, double radius)
+{
+    vector<ais_base::Position> result;
+    index.queryRadius(
+        base::Angle::fromDeg(latitude), base::Angle::fromDeg(longitude), radius, result);
+    return getMMSIs(result);
+}
+
+// One nautical mile of latitude, in degrees
+static const double NM = 1852.0 / 6371000 * 180 / M_PI;
+
+TEST(AISTargetIndexTest, it_returns_the_targets_within_a_radius)
+{
+    AISTargetIndex index;
+    index.update(makePosition(1, 1000, -22.9, -43.15));
+    index.update(makePosition(2, 1000, -22.9 + 0.9 * NM, -43.15));
+    index.update(makePosition(3, 1000, -22.9 + 1.1 * NM, -43.15));
+    index.update(makePosition(4, 1000, 10, 10));
+
+    ASSERT_EQ(vector<int>({1, 2}), queryRadius(index, -22.9, -43.15, 1852));
+    ASSERT_EQ(vector<int>({1, 2, 3}), queryRadius(index, -22.9, -43.15, 3 * 1852));
+}
+
+TEST(AISTargetIndexTest, it_moves_a_target_when_its_position_is_updated)
+{
+    AISTargetIndex index;
+    index.update(makePosition(1, 1000, -22.9, -43.15));
+    index.update(makePosition(1, 1000, 10, 10));
+    ASSERT_EQ(1, index.size());
+    ASSERT_TRUE(queryRadius(index, -22.9, -43.15, 1852).empty());
+    ASSERT_EQ(vector<int>({1}), queryRadius(index, 10, 10, 1852));
+    ASSERT_DOUBLE_EQ(10, index.get(1)->latitude.getDeg());
+}
+
+TEST(AISTargetIndexTest, it_ignores_positions_that_are_not_available)
+{
+    AISTargetIndex index;
+    ais_base::Position position = makePosition(1, 1000, 0, 0);
+    position.latitude = base::Angle::unknown();
+    ASSERT_FALSE(index.update(position));
+    ASSERT_EQ(0, index.size());
+}
+
+TEST(AISTargetIndexTest, it_finds_targets_across_the_antimeridian)
+{
+    AISTargetIndex index;
+    index.update(makePosition(1, 1000, 10, -179.99));
+    index.update(makePosition(2, 1000, 10, 179.99));
+    ASSERT_EQ(vector<int>({1, 2}), queryRadius(index, 10, 179.995, 5 * 1852));
+    ASSERT_EQ(vector<int>({1, 2}), queryRadius(index, 10, -179.995, 5 * 1852));
+}
+
+TEST(AISTargetIndexTest, it_finds_targets_across_a_pole)
+{
+    AISTargetIndex index;
+    index.update(makePosition(1, 1000, 89.99, 0));
+    index.update(makePosition(2, 1000, 89.99, 180 - 1e-6));
+    ASSERT_EQ(vector<int>({1, 2}), queryRadius(index, 89.99, 90, 5 * 1852));
+}
+
+TEST(AISTargetIndexTest, it_returns_the_targets_within_a_box)
+{
+    AISTargetIndex index;
+    index.update(makePosition(1, 1000, 10, 10));
+    index.update(makePosition(2, 1000, 10.5, 10.5));
+    index.update(makePosition(3, 1000, 11.5, 10.5));
+    index.update(makePosition(4, 1000, 10.5, 179.5));
+    index.update(makePosition(5, 1000, 10.5, -179.5));
+
+    vector<ais_base::Position> result;
+    index.queryBox(base::Angle::fromDeg(9.5),
+        base::Angle::fromDeg(9.5),
+        base::Angle::fromDeg(11),
+        base::Angle::fromDeg(11),
+        result);
+    ASSERT_EQ(vector<int>({1, 2}), getMMSIs(result));
+
+    result.clear();
+    index.queryBox(base::Angle::fromDeg(10),
+        base::Angle::fromDeg(179),
+        base::Angle::fromDeg(11),
+        base::Angle::fromDeg(-179),
+        result);
+    ASSERT_EQ(vector<int>({4, 5}), getMMSIs(result));
+}
+
+TEST(AISTargetIndexTest, it_removes_targets)
+{
+    AISTargetIndex index;
+    index.update(makePosition(1, 1000, 10, 10));
+    index.update(makePosition(2, 1000, 10, 10.001));
+    index.update(makePosition(3, 1000, 10, 10.002));
+    ASSERT_TRUE(index.remove(1));
+    ASSERT_FALSE(index.remove(1));
+    ASSERT_EQ(2, index.size());
+    ASSERT_EQ(nullptr, index.get(1));
+    ASSERT_EQ(vector<int>({2, 3}), queryRadius(index, 10, 10, 1852));
+}
+
+TEST(AISTargetIndexTest, it_removes_the_targets_older_than_a_given_time)
+{
+    AISTargetIndex index;
+    index.update(makePosition(1, 10, 10, 10));
+    index.update(makePosition(2, 20, 10, 10));
+    index.update(makePosition(3, 5, 10, 10));
+    ASSERT_EQ(2, index.removeOlderThan(base::Time::fromSeconds(15)));
+    ASSERT_EQ(vector<int>({2}), queryRadius(index, 10, 10, 1852));
+}
+
+TEST(AISTargetIndexTest, it_matches_a_linear_search_after_random_updates)
+{
+    AISTargetIndex index(base::Angle::fromDeg(0.05));
+    vector<ais_base::Position> targets(500);
+    mt19937 rng(42);
+    uniform_real_distribution<double> latitude(59, 60);
+    uniform_real_distribution<double> longitude(10, 12);
+    uniform_int_distribution<int> mmsi(0, targets.size() - 1);
+
+    for (int i = 0; i < 5000; ++i) {
+        int id = mmsi(rng);
+        if (i % 10 == 0) {
+            index.remove(id + 1);
+            targets[id] = ais_base::Position();
+            continue;
+        }
+        targets[id] = makePosition(id + 1, 1000, latitude(rng), longitude(rng));
+        index.update(targets[id]);
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        double lat = latitude(rng);
+        double lon = longitude(rng);
+        double radius = 10000;
+        vector<int> expected;
+        for (auto const& target : targets) {
+            if (target.mmsi != 0 &&
+                AISTargetIndex::distance(base::Angle::fromDeg(lat),
+                    base::Angle::fromDeg(lon),
+                    target.latitude,
+                    target.longitude) <= radius) {
+                expected.push_back(target.mmsi);
+            }
+        }
+        ASSERT_EQ(expected, queryRadius(index, lat, lon, radius));
+    }
+}
+
+TEST(AISTargetIndexTest, it_rejects_an_invalid_cell_size)
+{
+    ASSERT_THROW(AISTargetIndex(base::Angle::fromDeg(0)), invalid_argument);
+}
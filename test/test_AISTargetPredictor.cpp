@@ -0,0 +1,122 @@
+#include "Helpers.hpp"
+#include <gtest/gtest.h>
+#include <nmea0183/AISTargetPredictor.hpp>
+
+using namespace std;
+using namespace nmea0183;
+using test::makePosition;
+
+static const double EARTH_RADIUS = 6371000;
+
+static double getNorth(ais_base::Position const& position)
+{
+    return (position.latitude.getRad() - M_PI / 4) * EARTH_RADIUS;
+}
+
+static double getWest(ais_base::Position const& position)
+{
+    return -(position.longitude.getRad() - 10 * M_PI / 180) * EARTH_RADIUS *
+           cos(M_PI / 4);
+}
+
+TEST(AISTargetPredictorTest, it_predicts_a_straight_line_without_rate_of_turn)
+{
+    AISTargetPredictor predictor;
+    predictor.update(makePosition(1, 100, 45, 10, 0, 5));
+    predictor.update(makePosition(2, 100, 45, 10, -90, 2));
+
+    vector<ais_base::Position> predicted;
+    predictor.predict(base::Time::fromSeconds(200), predicted);
+    ASSERT_EQ(2, predicted.size());
+    ASSERT_NEAR(500, getNorth(predicted[0]), 1e-3);
+    ASSERT_NEAR(0, getWest(predicted[0]), 1e-3);
+    ASSERT_NEAR(0, getNorth(predicted[1]), 1e-3);
+    ASSERT_NEAR(-200, getWest(predicted[1]), 1e-3);
+    ASSERT_EQ(base::Time::fromSeconds(200), predicted[0].time);
+    ASSERT_FLOAT_EQ(0, predicted[0].course_over_ground.getDeg());
+}
+
+TEST(AISTargetPredictorTest, it_predicts_an_arc_of_circle_with_a_rate_of_turn)
+{
+    AISTargetPredictor predictor(base::Time::fromSeconds(120));
+    // 1 deg/s to port, 90 degrees in 90s
+    double rate = M_PI / 180;
+    predictor.update(makePosition(1, 100, 45, 10, 0, 5), rate);
+
+    ais_base::Position predicted;
+    ASSERT_TRUE(predictor.predict(1, base::Time::fromSeconds(190), predicted));
+    double radius = 5 / rate;
+    ASSERT_NEAR(radius, getNorth(predicted), 1e-2);
+    ASSERT_NEAR(radius, getWest(predicted), 1e-2);
+    ASSERT_NEAR(90, predicted.course_over_ground.getDeg(), 1e-6);
+    ASSERT_NEAR(90, predicted.yaw.getDeg(), 1e-6);
+}
+
+TEST(AISTargetPredictorTest, it_goes_straight_after_the_maximum_turn_duration)
+{
+    AISTargetPredictor predictor(base::Time::fromSeconds(90));
+    double rate = -M_PI / 180;
+    predictor.update(makePosition(1, 100, 45, 10, 0, 5), rate);
+
+    ais_base::Position predicted;
+    predictor.predict(1, base::Time::fromSeconds(290), predicted);
+    // Quarter circle to starboard, then 100s east
+    double radius = 5 / -rate;
+    ASSERT_NEAR(radius, getNorth(predicted), 1e-2);
+    ASSERT_NEAR(-radius - 500, getWest(predicted), 1e-2);
+    ASSERT_NEAR(-90, predicted.course_over_ground.getDeg(), 1e-6);
+}
+
+TEST(AISTargetPredictorTest, it_keeps_targets_without_speed_or_course_in_place)
+{
+    AISTargetPredictor predictor;
+    auto position = makePosition(1, 100, 45, 10, 0, 5);
+    position.course_over_ground = base::Angle();
+    predictor.update(position);
+
+    ais_base::Position predicted;
+    predictor.predict(1, base::Time::fromSeconds(1000), predicted);
+    ASSERT_DOUBLE_EQ(45, predicted.latitude.getDeg());
+    ASSERT_DOUBLE_EQ(10, predicted.longitude.getDeg());
+}
+
+TEST(AISTargetPredictorTest, it_replaces_the_motion_state_on_a_new_report)
+{
+    AISTargetPredictor predictor;
+    predictor.update(makePosition(1, 100, 45, 10, 0, 5), M_PI / 180);
+    predictor.update(makePosition(1, 100, 45, 10, 180, 5));
+    ASSERT_EQ(1, predictor.size());
+
+    ais_base::Position predicted;
+    predictor.predict(1, base::Time::fromSeconds(200), predicted);
+    ASSERT_NEAR(-500, getNorth(predicted), 1e-3);
+    ASSERT_NEAR(0, getWest(predicted), 1e-3);
+}
+
+TEST(AISTargetPredictorTest, it_ignores_positions_that_are_not_available)
+{
+    AISTargetPredictor predictor;
+    auto position = makePosition(1, 100, 45, 10, 0, 5);
+    position.longitude = base::Angle();
+    ASSERT_FALSE(predictor.update(position));
+    ASSERT_EQ(0, predictor.size());
+}
+
+TEST(AISTargetPredictorTest, it_removes_targets)
+{
+    AISTargetPredictor predictor;
+    for (int i = 1; i <= 3; ++i) {
+        auto position = makePosition(i, 100, 45, 10, 0, 5);
+        position.time = base::Time::fromSeconds(i * 10);
+        predictor.update(position);
+    }
+
+    ASSERT_TRUE(predictor.remove(1));
+    ASSERT_FALSE(predictor.remove(1));
+    ASSERT_EQ(1, predictor.removeOlderThan(base::Time::fromSeconds(25)));
+
+    ais_base::Position predicted;
+    ASSERT_FALSE(predictor.predict(2, base::Time::fromSeconds(100), predicted));
+    ASSERT_TRUE(predictor.predict(3, base::Time::fromSeconds(100), predicted));
+    ASSERT_EQ(3, predicted.mmsi);
+}
@@ -0,0 +1,143 @@
+#include "Helpers.hpp"
+#include <gtest/gtest.h>
+#include <nmea0183/AISTargetState.hpp>
+
+using namespace std;
+using namespace nmea0183;
+using test::makePosition;
+
+static ais_base::VesselInformation makeVesselInformation(int mmsi, double time)
+{
+    ais_base::VesselInformation info;
+    info.mmsi = mmsi;
+    info.time = base::Time::fromSeconds(time);
+    info.imo = 9876543;
+    info.name = "SOME VESSEL";
+    info.call_sign = "FABC";
+    info.length = 120;
+    info.width = 20;
+    info.draft = 7.5;
+    info.reference_position = base::Vector3d(10, -2, 0);
+    return info;
+}
+
+TEST(AISTargetStateTest, it_restores_a_position)
+{
+    AISTargetState state;
+    auto original = makePosition(1, 100, 48.5, -4.25, -30, 6.5);
+    original.yaw = base::Angle::fromDeg(-32);
+    original.status = ais_base::STATUS_AT_ANCHOR;
+    original.high_accuracy_position = true;
+    original.radio_status = 1234;
+    state.update(original);
+
+    ais_base::Position position;
+    ASSERT_TRUE(state.getPosition(1, position));
+    ASSERT_EQ(1, position.mmsi);
+    ASSERT_EQ(base::Time::fromSeconds(100), position.time);
+    ASSERT_DOUBLE_EQ(48.5, position.latitude.getDeg());
+    ASSERT_DOUBLE_EQ(-4.25, position.longitude.getDeg());
+    ASSERT_NEAR(-30, position.course_over_ground.getDeg(), 1e-4);
+    ASSERT_NEAR(-32, position.yaw.getDeg(), 1e-4);
+    ASSERT_FLOAT_EQ(6.5, position.speed_over_ground);
+    ASSERT_EQ(ais_base::STATUS_AT_ANCHOR, position.status);
+    ASSERT_TRUE(position.high_accuracy_position);
+    ASSERT_FALSE(position.raim);
+    ASSERT_EQ(1234, position.radio_status);
+}
+
+TEST(AISTargetStateTest, it_restores_the_vessel_information)
+{
+    AISTargetState state;
+    state.update(makeVesselInformation(1, 100));
+
+    ais_base::VesselInformation info;
+    ASSERT_TRUE(state.getVesselInformation(1, info));
+    ASSERT_EQ(1, info.mmsi);
+    ASSERT_EQ(base::Time::fromSeconds(100), info.time);
+    ASSERT_EQ(9876543, info.imo);
+    ASSERT_EQ("SOME VESSEL", info.name);
+    ASSERT_EQ("FABC", info.call_sign);
+    ASSERT_FLOAT_EQ(120, info.length);
+    ASSERT_FLOAT_EQ(20, info.width);
+    ASSERT_FLOAT_EQ(7.5, info.draft);
+    ASSERT_EQ(base::Vector3d(10, -2, 0), info.reference_position);
+}
+
+TEST(AISTargetStateTest, it_truncates_strings_that_are_longer_than_the_AIS_fields)
+{
+    AISTargetState state;
+    auto info = makeVesselInformation(1, 100);
+    info.name = "A NAME THAT IS WAY TOO LONG FOR AIS";
+    info.call_sign = "CALLSIGN";
+    state.update(info);
+
+    ASSERT_TRUE(state.getVesselInformation(1, info));
+    ASSERT_EQ("A NAME THAT IS WAY T", info.name);
+    ASSERT_EQ("CALLSIG", info.call_sign);
+}
+
+TEST(AISTargetStateTest, it_keeps_the_position_and_vessel_information_in_the_same_record)
+{
+    AISTargetState state;
+    state.update(makePosition(1, 100, 48.5, -4.25));
+    state.update(makeVesselInformation(1, 50));
+
+    ASSERT_EQ(1, state.size());
+    auto record = state.get(1);
+    ASSERT_TRUE(record->flags & AISTargetRecord::HAS_POSITION);
+    ASSERT_TRUE(record->flags & AISTargetRecord::HAS_VESSEL_INFORMATION);
+}
+
+TEST(AISTargetStateTest, it_reports_missing_data)
+{
+    AISTargetState state;
+    state.update(makePosition(1, 100, 48.5, -4.25));
+
+    ais_base::Position position;
+    ais_base::VesselInformation info;
+    ASSERT_FALSE(state.getVesselInformation(1, info));
+    ASSERT_FALSE(state.getPosition(2, position));
+    ASSERT_EQ(nullptr, state.get(2));
+}
+
+TEST(AISTargetStateTest, it_removes_a_target)
+{
+    AISTargetState state;
+    state.update(makePosition(1, 100, 48.5, -4.25));
+    state.update(makePosition(2, 100, 48.5, -4.25));
+
+    ASSERT_TRUE(state.remove(1));
+    ASSERT_FALSE(state.remove(1));
+    ASSERT_EQ(1, state.size());
+    ASSERT_EQ(nullptr, state.get(1));
+    ASSERT_EQ(2, state.get(2)->mmsi);
+}
+
+TEST(AISTargetStateTest, it_removes_the_targets_whose_last_update_is_too_old)
+{
+    AISTargetState state;
+    state.update(makePosition(1, 100, 48.5, -4.25));
+    state.update(makePosition(2, 50, 48.5, -4.25));
+    state.update(makeVesselInformation(2, 150));
+    state.update(makePosition(3, 50, 48.5, -4.25));
+
+    ASSERT_EQ(1, state.removeOlderThan(base::Time::fromSeconds(75)));
+    ASSERT_EQ(2, state.size());
+    ASSERT_EQ(nullptr, state.get(3));
+}
+
+TEST(AISTargetStateTest, it_replaces_a_target_from_its_record)
+{
+    AISTargetState state;
+    state.update(makePosition(1, 100, 48.5, -4.25));
+
+    AISTargetState other;
+    other.update(makeVesselInformation(1, 200));
+    state.set(*other.get(1));
+
+    ais_base::Position position;
+    ais_base::VesselInformation info;
+    ASSERT_FALSE(state.getPosition(1, position));
+    ASSERT_TRUE(state.getVesselInformation(1, info));
+}
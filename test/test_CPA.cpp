@@ -0,0 +1,120 @@
+#include "Helpers.hpp"
+#include <gtest/gtest.h>
+#include <nmea0183/CPA.hpp>
+
+using namespace std;
+using namespace nmea0183;
+
+// One meter of latitude, in degrees
+static const double METER = 1.0 / 6371000 * 180 / M_PI;
+
+/** A position in meters from the origin, with a clockwise course in degrees */
+static ais_base::Position makeLocalPosition(int mmsi, double north, double east,
+    double course, double speed, double time = 100)
+{
+    // Rock angles are counter-clockwise
+    return test::makePosition(mmsi, time, north * METER, east * METER, -course, speed);
+}
+
+struct CPATest : public ::testing::Test {
+    ais_base::Position own = makeLocalPosition(0, 0, 0, 0, 5);
+    CPATargets targets;
+    CPAResults results;
+
+    void compute(base::Time const& time = base::Time::fromSeconds(100))
+    {
+        CPA::compute(own, targets, time, results);
+    }
+};
+
+TEST_F(CPATest, it_computes_the_CPA_of_a_head_on_target)
+{
+    targets.add(makeLocalPosition(1, 1000, 0, 180, 5));
+    compute();
+    ASSERT_NEAR(0, results.distance[0], 1e-3);
+    ASSERT_NEAR(100, results.time[0], 1e-3);
+}
+
+TEST_F(CPATest, it_computes_the_CPA_of_a_crossing_target)
+{
+    // Target going west at 5 m/s, the relative velocity is (-5, -5) in
+    // north/east
+    targets.add(makeLocalPosition(1, 1000, 1000, 270, 5));
+    compute();
+    ASSERT_NEAR(0, results.distance[0], 1e-2);
+    ASSERT_NEAR(200, results.time[0], 1e-3);
+
+    targets.clear();
+    targets.add(makeLocalPosition(1, 1000, 500, 270, 5));
+    compute();
+    ASSERT_NEAR(500 / sqrt(2), results.distance[0], 1e-2);
+    ASSERT_NEAR(150, results.time[0], 1e-3);
+}
+
+TEST_F(CPATest, it_reports_the_current_distance_of_a_diverging_target)
+{
+    targets.add(makeLocalPosition(1, -1000, 0, 180, 5));
+    compute();
+    ASSERT_NEAR(1000, results.distance[0], 1e-2);
+    ASSERT_EQ(0, results.time[0]);
+}
+
+TEST_F(CPATest, it_handles_targets_with_no_relative_motion)
+{
+    targets.add(makeLocalPosition(1, 300, 400, 0, 5));
+    compute();
+    ASSERT_NEAR(500, results.distance[0], 1e-2);
+    ASSERT_EQ(0, results.time[0]);
+}
+
+TEST_F(CPATest, it_assumes_that_targets_without_course_are_stationary)
+{
+    auto target = makeLocalPosition(1, 1000, 0, 0, 5);
+    target.course_over_ground = base::Angle();
+    targets.add(target);
+    compute();
+    ASSERT_NEAR(0, results.distance[0], 1e-3);
+    ASSERT_NEAR(200, results.time[0], 1e-3);
+}
+
+TEST_F(CPATest, it_extrapolates_the_positions_to_the_requested_time)
+{
+    targets.add(makeLocalPosition(1, 1000, 0, 180, 5, 90));
+    compute(base::Time::fromSeconds(110));
+    // Own ship moved 50m north, the target 100m south
+    ASSERT_NEAR(0, results.distance[0], 1e-3);
+    ASSERT_NEAR(85, results.time[0], 1e-3);
+}
+
+TEST_F(CPATest, it_handles_targets_across_the_antimeridian)
+{
+    own.longitude = base::Angle::fromDeg(179.999);
+    auto target = makeLocalPosition(1, 0, 0, 90, 0);
+    target.longitude = base::Angle::fromDeg(-179.999);
+    targets.add(target);
+    compute();
+    ASSERT_NEAR(0.002 / METER, results.distance[0], 1);
+}
+
+TEST_F(CPATest, it_skips_targets_without_position)
+{
+    auto target = makeLocalPosition(1, 0, 0, 0, 0);
+    target.latitude = base::Angle();
+    ASSERT_FALSE(targets.add(target));
+    ASSERT_EQ(0, targets.size());
+}
+
+TEST_F(CPATest, it_screens_the_targets_by_distance_and_time)
+{
+    targets.add(makeLocalPosition(1, 1000, 0, 180, 5));  // CPA 0m in 100s
+    targets.add(makeLocalPosition(2, 10000, 0, 180, 5)); // CPA 0m in 1000s
+    targets.add(makeLocalPosition(3, 0, 500, 0, 5));     // CPA 500m now
+    targets.add(makeLocalPosition(4, 0, 100, 0, 5));     // CPA 100m now
+    compute();
+
+    vector<uint32_t> indices;
+    ASSERT_EQ(2, CPA::screen(results, 200, base::Time::fromSeconds(600), indices));
+    ASSERT_EQ(vector<uint32_t>({0, 3}), indices);
+    ASSERT_EQ(3, CPA::screen(results, 200, base::Time::fromSeconds(3600), indices));
+    ASSERT_EQ(vector<uint32_t>({0, 1, 3}), indices);
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <nmea0183/Capture.hpp>
+#include <nmea0183/Driver.hpp>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+struct CaptureTest : public ::testing::Test {
+    string path;
+
+    CaptureTest()
+        : path("/tmp/nmea0183_test_capture." + to_string(getpid()))
+    {
+    }
+
+    ~CaptureTest()
+    {
+        unlink(path.c_str());
+        unlink((path + ".idx").c_str());
+    }
+
+    void write(CaptureWriter& writer, uint64_t time, uint16_t source, string const& data)
+    {
+        writer.write(time,
+            source,
+            CAPTURE_RAW_READ,
+            reinterpret_cast<uint8_t const*>(data.data()),
+            data.size());
+    }
+
+    string recordData(CaptureRecord const& record)
+    {
+        return string(reinterpret_cast<char const*>(record.data), record.size);
+    }
+};
+
+TEST_F(CaptureTest, it_reads_back_the_records_in_order)
+{
+    {
+        CaptureWriter writer(path);
+        write(writer, 10, 1, "first");
+        write(writer, 20, 2, "second");
+    }
+
+    CaptureReader reader(path);
+    CaptureRecord record;
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(10, record.time);
+    ASSERT_EQ(1, record.source);
+    ASSERT_EQ(CAPTURE_RAW_READ, record.type);
+    ASSERT_EQ("first", recordData(record));
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(20, record.time);
+    ASSERT_EQ(2, record.source);
+    ASSERT_EQ("second", recordData(record));
+    ASSERT_FALSE(reader.next(record));
+}
+
+TEST_F(CaptureTest, it_rejects_non_monotonic_times)
+{
+    CaptureWriter writer(path);
+    write(writer, 10, 0, "first");
+    ASSERT_THROW(write(writer, 9, 0, "second"), invalid_argument);
+}
+
+TEST_F(CaptureTest, it_seeks_to_the_first_record_at_or_after_a_given_time)
+{
+    {
+        CaptureWriter writer(path, 100);
+        for (uint64_t t = 0; t < 1000; t += 10) {
+            write(writer, t, 0, to_string(t));
+        }
+    }
+
+    CaptureReader reader(path);
+    CaptureRecord record;
+    reader.seek(505);
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(510, record.time);
+    reader.seek(700);
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(700, record.time);
+    reader.seek(0);
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(0, record.time);
+    reader.seek(1000);
+    ASSERT_FALSE(reader.next(record));
+}
+
+TEST_F(CaptureTest, it_seeks_without_the_index)
+{
+    {
+        CaptureWriter writer(path, 100);
+        for (uint64_t t = 0; t < 1000; t += 10) {
+            write(writer, t, 0, to_string(t));
+        }
+    }
+    unlink((path + ".idx").c_str());
+
+    CaptureReader reader(path);
+    CaptureRecord record;
+    reader.seek(505);
+    ASSERT_TRUE(reader.next(record));
+    ASSERT_EQ(510, record.time);
+}
+
+TEST_F(CaptureTest, it_feeds_a_capture_to_the_driver)
+{
+    {
+        CaptureWriter writer(path);
+        write(writer, 10, 0, "$GPAPB,A,A,0.10,R,N,V,V,11.0");
+        write(writer, 20, 1, "garbage");
+        write(writer, 30, 0, ",M,DEST,11.0,M,11.0,M*12\r\n");
+    }
+
+    CaptureReader reader(path);
+    auto stream = new CaptureStream(reader, 0);
+    Driver driver;
+    driver.setMainStream(stream);
+
+    auto sentence = driver.readSentence();
+    ASSERT_EQ("APB", sentence->tag());
+    ASSERT_EQ(30, stream->getCurrentTime());
+    ASSERT_THROW(driver.readSentence(), iodrivers_base::TimeoutError);
+}
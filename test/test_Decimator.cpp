@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <nmea0183/Decimator.hpp>
+
+using namespace std;
+using namespace nmea0183;
+
+static const string HDT = "$HEHDT,274.07,T*19\r\n";
+static const string ROT = "$HEROT,1.2,A*28\r\n";
+
+static bool accept(Decimator& decimator, string const& sentence, double time)
+{
+    return decimator.accept(reinterpret_cast<uint8_t const*>(sentence.data()),
+        sentence.size(),
+        base::Time::fromSeconds(time));
+}
+
+TEST(DecimatorTest, it_keeps_sentences_that_have_no_policy)
+{
+    Decimator decimator;
+    decimator.keepEveryNth("ROT", 10);
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(accept(decimator, HDT, i));
+    }
+    ASSERT_EQ(0, decimator.getDroppedCount());
+}
+
+TEST(DecimatorTest, it_keeps_every_nth_sentence)
+{
+    Decimator decimator;
+    decimator.keepEveryNth("HDT", 3);
+    vector<bool> expected = {true, false, false, true, false, false, true};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(expected[i], accept(decimator, HDT, i)) << i;
+    }
+
+    auto stats = decimator.getStatistics("HDT");
+    ASSERT_EQ(3, stats.kept);
+    ASSERT_EQ(4, stats.dropped);
+    ASSERT_EQ(4, decimator.getDroppedCount());
+}
+
+TEST(DecimatorTest, it_limits_the_rate_of_a_tag)
+{
+    Decimator decimator;
+    decimator.setMaxRate("HDT", 5);
+
+    // 20 Hz input for one second
+    size_t kept = 0;
+    for (int i = 0; i < 20; ++i) {
+        kept += accept(decimator, HDT, i * 0.05) ? 1 : 0;
+    }
+    ASSERT_EQ(5, kept);
+    ASSERT_EQ(15, decimator.getStatistics("HDT").dropped);
+}
+
+TEST(DecimatorTest, it_does_not_let_jitter_lower_the_output_rate)
+{
+    Decimator decimator;
+    decimator.setMaxRate("HDT", 5);
+
+    // 20 Hz input for ten seconds, every sentence a bit early or late
+    size_t kept = 0;
+    for (int i = 0; i < 200; ++i) {
+        double jitter = (i % 2) ? 0.002 : -0.002;
+        kept += accept(decimator, HDT, 1 + i * 0.05 + jitter) ? 1 : 0;
+    }
+    ASSERT_EQ(50, kept);
+}
+
+TEST(DecimatorTest, it_keeps_the_first_sentence_after_a_gap)
+{
+    Decimator decimator;
+    decimator.setMaxRate("HDT", 1);
+    ASSERT_TRUE(accept(decimator, HDT, 0));
+    ASSERT_FALSE(accept(decimator, HDT, 0.5));
+    ASSERT_TRUE(accept(decimator, HDT, 10.2));
+    ASSERT_FALSE(accept(decimator, HDT, 11));
+    ASSERT_TRUE(accept(decimator, HDT, 11.2));
+}
+
+TEST(DecimatorTest, it_replaces_the_policy_of_a_tag)
+{
+    Decimator decimator;
+    decimator.keepEveryNth("HDT", 10);
+    decimator.setMaxRate("HDT", 100);
+    ASSERT_TRUE(accept(decimator, HDT, 0));
+    ASSERT_TRUE(accept(decimator, HDT, 1));
+}
+
+TEST(DecimatorTest, it_removes_the_policy_of_a_tag)
+{
+    Decimator decimator;
+    decimator.keepEveryNth("HDT", 10);
+    decimator.keepEveryNth("ROT", 10);
+    decimator.remove("HDT");
+    ASSERT_TRUE(accept(decimator, HDT, 0));
+    ASSERT_TRUE(accept(decimator, HDT, 1));
+    ASSERT_TRUE(accept(decimator, ROT, 0));
+    ASSERT_FALSE(accept(decimator, ROT, 1));
+}
+
+TEST(DecimatorTest, it_rejects_invalid_policies)
+{
+    Decimator decimator;
+    ASSERT_THROW(decimator.keepEveryNth("HDT", 0), invalid_argument);
+    ASSERT_THROW(decimator.setMaxRate("HDT", 0), invalid_argument);
+    ASSERT_THROW(decimator.keepEveryNth("hdt", 2), invalid_argument);
+}
@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <nmea0183/Driver.hpp>
 #include <iodrivers_base/FixtureGTest.hpp>
+#include <iodrivers_base/TestStream.hpp>
+#include <unistd.h>
 
 using namespace std;
 using namespace nmea0183;
@@ -48,6 +50,28 @@ TEST_F(DriverTest, it_rejects_an_NMEA_sentence_whose_checksum_is_invalid) {
     string msg = "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*11\r\n";
     pushStringToDriver(msg);
     ASSERT_THROW(driver.readSentence(), iodrivers_base::TimeoutError);
+    ASSERT_EQ(1, driver.getChecksumErrorCount());
+}
+
+TEST_F(DriverTest, it_rejects_an_NMEA_sentence_whose_checksum_is_not_hexadecimal) {
+    string msg = "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*1X\r\n"
+                 "$\r\n"
+                 "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    pushStringToDriver(msg);
+    auto sentence = driver.readSentence();
+    ASSERT_TRUE(sentence);
+    ASSERT_EQ("APB", sentence->tag());
+    ASSERT_EQ(0, driver.getChecksumErrorCount());
+}
+
+TEST_F(DriverTest, it_parses_a_packet_extracted_by_readPacket) {
+    string msg = "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    pushStringToDriver(msg);
+    uint8_t buffer[Driver::BUFFER_SIZE];
+    int size = driver.readPacket(buffer, Driver::BUFFER_SIZE);
+    auto sentence = Driver::parseSentence(buffer, size);
+    ASSERT_TRUE(sentence);
+    ASSERT_EQ("APB", sentence->tag());
 }
 
 TEST_F(DriverTest, it_skips_garbage) {
@@ -67,9 +91,265 @@ TEST_F(DriverTest, it_skips_a_message_start_if_the_message_is_bigger_than_NMEA_m
                  "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabcdea"
                  "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabcdea"
                  "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabcdea"
+                 "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabcdea"
+                 "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabcdea"
                  "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
     pushStringToDriver(msg);
     auto sentence = driver.readSentence();
     ASSERT_TRUE(sentence);
     ASSERT_EQ("APB", sentence->tag());
 }
+
+TEST_F(DriverTest, it_peeks_at_the_tag_of_a_framed_sentence) {
+    string msg = "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    auto buffer = reinterpret_cast<uint8_t const*>(msg.data());
+    ASSERT_EQ("APB", Driver::peekSentenceTag(buffer, msg.size()));
+    ASSERT_EQ("", Driver::peekSentenceTag(buffer, 5));
+
+    string proprietary = "$PGRME,15.0,M,45.0,M,25.0,M*1C\r\n";
+    ASSERT_EQ("", Driver::peekSentenceTag(
+        reinterpret_cast<uint8_t const*>(proprietary.data()), proprietary.size()));
+}
+
+TEST_F(DriverTest, it_reads_a_sentence_prefixed_by_a_TAG_block) {
+    string msg = "\\s:r1,c:1241544035*7A\\"
+                 "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    pushStringToDriver(msg);
+    auto sentence = driver.readSentence();
+    ASSERT_TRUE(sentence);
+    ASSERT_EQ("APB", sentence->tag());
+
+    auto const& tag_block = driver.getTagBlock();
+    ASSERT_TRUE(tag_block.valid);
+    ASSERT_EQ("r1", tag_block.source);
+    ASSERT_EQ(base::Time::fromSeconds(1241544035), tag_block.time);
+}
+
+TEST_F(DriverTest, it_resets_the_TAG_block_on_a_sentence_without_one) {
+    string msg = "\\s:r1,c:1241544035*7A\\"
+                 "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n"
+                 "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    pushStringToDriver(msg);
+    driver.readSentence();
+    ASSERT_TRUE(driver.getTagBlock().valid);
+    driver.readSentence();
+    ASSERT_FALSE(driver.getTagBlock().valid);
+}
+
+TEST_F(DriverTest, it_accepts_the_sentence_alone_if_its_TAG_block_is_invalid) {
+    string msg = "\\s:r1,c:1241544035*7B\\"
+                 "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    pushStringToDriver(msg);
+    auto sentence = driver.readSentence();
+    ASSERT_TRUE(sentence);
+    ASSERT_EQ("APB", sentence->tag());
+    ASSERT_FALSE(driver.getTagBlock().valid);
+    ASSERT_EQ(1, driver.getChecksumErrorCount());
+}
+
+TEST_F(DriverTest, it_counts_a_checksum_error_after_a_valid_TAG_block_once) {
+    string msg = "\\s:r1,c:1241544035*7A\\"
+                 "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*11\r\n";
+    pushStringToDriver(msg);
+    ASSERT_THROW(driver.readSentence(), iodrivers_base::TimeoutError);
+    ASSERT_EQ(1, driver.getChecksumErrorCount());
+}
+
+TEST_F(DriverTest, it_handles_a_partial_TAG_block) {
+    string msg = "\\s:r1,c:1241544035*7A\\"
+                 "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    for (size_t i = 0; i < msg.size() - 1; ++i) {
+        pushCharToDriver(msg[i]);
+        ASSERT_THROW(driver.readSentence(), iodrivers_base::TimeoutError);
+    }
+    pushCharToDriver('\n');
+    ASSERT_TRUE(driver.readSentence());
+    ASSERT_TRUE(driver.getTagBlock().valid);
+}
+
+TEST_F(DriverTest, it_skips_the_TAG_block_when_peeking_at_the_tag) {
+    string msg = "\\s:r1,c:1241544035*7A\\"
+                 "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    auto buffer = reinterpret_cast<uint8_t const*>(msg.data());
+    ASSERT_EQ(msg.size(), Driver::extractSentence(buffer, msg.size()));
+    ASSERT_EQ("APB", Driver::peekSentenceTag(buffer, msg.size()));
+}
+
+static string toString(vector<uint8_t> const& data) {
+    return string(data.begin(), data.end());
+}
+
+TEST_F(DriverTest, it_writes_a_sentence_with_its_checksum) {
+    driver.writeSentence("$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M");
+    ASSERT_EQ("$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n",
+              toString(readDataFromDriver()));
+    ASSERT_EQ(0, driver.getPendingOutputSize());
+}
+
+TEST_F(DriverTest, it_writes_a_batch_of_sentences_at_once) {
+    vector<string_view> sentences = { "$HEHDT,274.07,T", "$HEHDT,274.08,T" };
+    driver.writeSentences(sentences);
+    ASSERT_EQ("$HEHDT,274.07,T*19\r\n$HEHDT,274.08,T*16\r\n",
+              toString(readDataFromDriver()));
+}
+
+TEST_F(DriverTest, it_rejects_a_sentence_that_does_not_start_with_a_sentence_marker) {
+    ASSERT_THROW(driver.writeSentence("HEHDT,274.07,T"), invalid_argument);
+    ASSERT_THROW(driver.writeSentence(""), invalid_argument);
+}
+
+TEST_F(DriverTest, it_rejects_a_sentence_that_is_too_long) {
+    ASSERT_THROW(driver.writeSentence("$" + string(Driver::MAX_SENTENCE_LENGTH, 'a')),
+                 invalid_argument);
+}
+
+TEST_F(DriverTest, it_holds_sentences_until_the_flush_latency_is_reached) {
+    driver.setFlushPolicy(base::Time::fromSeconds(10));
+    driver.writeSentence("$HEHDT,274.07,T");
+    driver.writeSentence("$HEHDT,274.08,T");
+    ASSERT_TRUE(readDataFromDriver().empty());
+    ASSERT_EQ(40, driver.getPendingOutputSize());
+    ASSERT_FALSE(driver.flushIfDue());
+    ASSERT_FALSE(driver.getFlushDeadline().isNull());
+
+    driver.flush();
+    ASSERT_EQ("$HEHDT,274.07,T*19\r\n$HEHDT,274.08,T*16\r\n",
+              toString(readDataFromDriver()));
+    ASSERT_TRUE(driver.getFlushDeadline().isNull());
+}
+
+TEST_F(DriverTest, it_writes_sentences_whose_flush_latency_is_exceeded) {
+    driver.setFlushPolicy(base::Time::fromMicroseconds(1));
+    driver.writeSentence("$HEHDT,274.07,T");
+    usleep(1000);
+    ASSERT_TRUE(driver.flushIfDue());
+    ASSERT_EQ("$HEHDT,274.07,T*19\r\n", toString(readDataFromDriver()));
+}
+
+TEST_F(DriverTest, it_writes_sentences_once_the_flush_size_is_reached) {
+    driver.setFlushPolicy(base::Time::fromSeconds(10), 50);
+    driver.writeSentence("$HEHDT,274.07,T");
+    driver.writeSentence("$HEHDT,274.08,T");
+    ASSERT_TRUE(readDataFromDriver().empty());
+    // Would overflow the threshold, writes the first two and queues the
+    // third
+    driver.writeSentence("$HEHDT,274.09,T");
+    ASSERT_EQ("$HEHDT,274.07,T*19\r\n$HEHDT,274.08,T*16\r\n",
+              toString(readDataFromDriver()));
+    ASSERT_EQ(20, driver.getPendingOutputSize());
+}
+
+TEST_F(DriverTest, it_rejects_an_invalid_flush_size) {
+    ASSERT_THROW(driver.setFlushPolicy(base::Time(), 0), invalid_argument);
+    ASSERT_THROW(driver.setFlushPolicy(base::Time(), Driver::OUTPUT_BUFFER_SIZE + 1),
+                 invalid_argument);
+}
+
+TEST_F(DriverTest, it_skips_the_sentences_dropped_by_the_decimator) {
+    driver.getDecimator().keepEveryNth("HDT", 2);
+    pushStringToDriver("$HEHDT,274.07,T*19\r\n"
+                       "$HEHDT,274.08,T*16\r\n"
+                       "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n"
+                       "$HEHDT,274.09,T*17\r\n");
+    ASSERT_EQ("HDT", driver.readSentence()->tag());
+    ASSERT_EQ("APB", driver.readSentence()->tag());
+    ASSERT_EQ("HDT", driver.readSentence()->tag());
+    ASSERT_EQ(1, driver.getDecimator().getDroppedCount());
+}
+
+TEST_F(DriverTest, tryReadSentence_returns_null_if_there_is_no_data) {
+    ASSERT_EQ(nullptr, driver.tryReadSentence());
+}
+
+TEST_F(DriverTest, tryReadSentence_returns_null_on_a_partial_sentence) {
+    pushStringToDriver("$HEHDT,274.07");
+    ASSERT_EQ(nullptr, driver.tryReadSentence());
+    pushStringToDriver(",T*19\r\n");
+    ASSERT_EQ("HDT", driver.tryReadSentence()->tag());
+}
+
+/** Test stream that counts the timeouts it raises */
+struct CountingTestStream : public iodrivers_base::TestStream {
+    int timeout_count = 0;
+
+    void waitRead(base::Time const& timeout) override {
+        try {
+            iodrivers_base::TestStream::waitRead(timeout);
+        }
+        catch (iodrivers_base::TimeoutError const&) {
+            timeout_count++;
+            throw;
+        }
+    }
+};
+
+TEST_F(DriverTest, tryReadSentence_does_not_use_exceptions_on_a_partial_sentence) {
+    auto stream = new CountingTestStream;
+    driver.setMainStream(stream);
+    pushStringToDriver("$HEHDT,274.07");
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_EQ(nullptr, driver.tryReadSentence());
+    }
+    pushStringToDriver(",T*19\r\n");
+    ASSERT_EQ("HDT", driver.tryReadSentence()->tag());
+    ASSERT_EQ(nullptr, driver.tryReadSentence());
+    ASSERT_EQ(0, stream->timeout_count);
+}
+
+TEST_F(DriverTest, readSentence_completes_a_partial_sentence_read_by_tryReadSentence) {
+    pushStringToDriver("$HEHDT,274.07");
+    ASSERT_EQ(nullptr, driver.tryReadSentence());
+    pushStringToDriver(",T*19\r\n$HEHDT,274.08,T*16\r\n");
+    ASSERT_EQ("HDT", driver.readSentence()->tag());
+    ASSERT_EQ("HDT", driver.readSentence()->tag());
+    ASSERT_THROW(driver.readSentence(), iodrivers_base::TimeoutError);
+}
+
+TEST_F(DriverTest, tryReadSentence_returns_the_buffered_sentences_one_by_one) {
+    pushStringToDriver("$HEHDT,274.07,T*19\r\n"
+                       "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n");
+    ASSERT_EQ("HDT", driver.tryReadSentence()->tag());
+    ASSERT_EQ("APB", driver.tryReadSentence()->tag());
+    ASSERT_EQ(nullptr, driver.tryReadSentence());
+}
+
+TEST_F(DriverTest, tryReadSentence_counts_a_checksum_error_once) {
+    // The second sentence is already in the driver's internal buffer when
+    // tryReadSentence gets to it
+    pushStringToDriver("$HEHDT,274.07,T*19\r\n"
+                       "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*11\r\n");
+    ASSERT_EQ("HDT", driver.tryReadSentence()->tag());
+    ASSERT_EQ(nullptr, driver.tryReadSentence());
+    ASSERT_EQ(1, driver.getChecksumErrorCount());
+}
+
+TEST_F(DriverTest, tryReadSentence_skips_the_sentences_dropped_by_the_decimator) {
+    driver.getDecimator().keepEveryNth("HDT", 2);
+    pushStringToDriver("$HEHDT,274.07,T*19\r\n"
+                       "$HEHDT,274.08,T*16\r\n");
+    ASSERT_EQ("HDT", driver.tryReadSentence()->tag());
+    ASSERT_EQ(nullptr, driver.tryReadSentence());
+}
+
+TEST_F(DriverTest, tryReadSentence_frames_a_sentence_without_parsing_it) {
+    FramedSentence sentence;
+    ASSERT_FALSE(driver.tryReadSentence(sentence));
+    pushStringToDriver("$HEHDT,274.07,T*19\r\n");
+    ASSERT_TRUE(driver.tryReadSentence(sentence));
+    ASSERT_EQ("HDT", sentence.parse()->tag());
+}
+
+TEST_F(DriverTest, it_sheds_low_priority_sentences_when_a_backlog_builds_up) {
+    driver.getLoadShedder().setMaxBacklog(PRIORITY_LOW, 0);
+    pushStringToDriver(
+        "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+        "!AIVDM,1,1,,A,B52K>;h00Fc>jpUlNV@ikwpUoP06,0*4C\r\n"
+        "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+        "!AIVDM,1,1,,A,B52K>;h00Fc>jpUlNV@ikwpUoP06,0*4C\r\n");
+    ASSERT_EQ("RMC", driver.readSentence()->tag());
+    ASSERT_EQ("RMC", driver.readSentence()->tag());
+    // Nothing is left behind the last sentence
+    ASSERT_EQ("VDM", driver.readSentence()->tag());
+    ASSERT_EQ(1, driver.getLoadShedder().getStatistics(PRIORITY_LOW).shed);
+    ASSERT_EQ(0, driver.getBacklog());
+}
@@ -99,4 +99,105 @@ TEST_F(GPSTest, it_accepts_messages_without_mode_indicator)
     gsa.set_satellite_id(1, 155);
     auto gps_solution = GPS::getSolution(rmc, gsa);
     ASSERT_EQ(gps_solution.positionType, gps_base::GPS_SOLUTION_TYPES::INVALID);
-}
\ No newline at end of file
+}
+
+static uint8_t const* bytes(std::string const& data)
+{
+    return reinterpret_cast<uint8_t const*>(data.data());
+}
+
+TEST_F(GPSTest, it_parses_a_framed_rmc_in_place)
+{
+    std::string sentence = "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,"
+                           "230394,003.1,W,A*07\r\n";
+    GPS::RMC rmc;
+    ASSERT_TRUE(GPS::parseRMC(bytes(sentence), sentence.size(), rmc));
+    ASSERT_TRUE(rmc.valid);
+    ASSERT_NEAR(48.1173, rmc.latitude, 1e-6);
+    ASSERT_NEAR(11.516667, rmc.longitude, 1e-6);
+    ASSERT_DOUBLE_EQ(22.4, rmc.speed_over_ground);
+    ASSERT_DOUBLE_EQ(84.4, rmc.course_over_ground);
+    ASSERT_EQ(nmea::mode_indicator::autonomous, rmc.mode_indicator);
+}
+
+TEST_F(GPSTest, it_parses_a_framed_rmc_with_empty_fields_and_southern_coordinates)
+{
+    GPS::RMC rmc;
+    ASSERT_TRUE(GPS::parseRMC(bytes(rmc_string), rmc_string.size(), rmc));
+    ASSERT_FALSE(rmc.valid);
+    ASSERT_NEAR(-22.897742, rmc.latitude, 1e-6);
+    ASSERT_NEAR(-43.201467, rmc.longitude, 1e-6);
+    ASSERT_TRUE(base::isNaN(rmc.speed_over_ground));
+    ASSERT_TRUE(base::isNaN(rmc.course_over_ground));
+    ASSERT_EQ(nmea::mode_indicator::data_not_valid, rmc.mode_indicator);
+}
+
+TEST_F(GPSTest, it_parses_a_framed_rmc_without_mode_indicator)
+{
+    std::string sentence = "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,"
+                           "230394,003.1,W*6A\r\n";
+    GPS::RMC rmc;
+    rmc.mode_indicator = nmea::mode_indicator::autonomous;
+    ASSERT_TRUE(GPS::parseRMC(bytes(sentence), sentence.size(), rmc));
+    ASSERT_FALSE(rmc.mode_indicator.has_value());
+}
+
+TEST_F(GPSTest, it_leaves_the_rmc_unchanged_if_the_sentence_is_not_a_rmc)
+{
+    GPS::RMC rmc;
+    rmc.latitude = 10;
+    ASSERT_FALSE(GPS::parseRMC(bytes(gsa_string), gsa_string.size(), rmc));
+    ASSERT_EQ(10, rmc.latitude);
+}
+
+TEST_F(GPSTest, it_leaves_the_rmc_unchanged_if_a_field_is_invalid)
+{
+    std::string invalid_hemisphere = "$GPRMC,123519,A,4807.038,X,01131.000,E,022.4,"
+                                     "084.4,230394,003.1,W,A*11\r\n";
+    std::string invalid_number = "$GPRMC,123519,A,48O7.038,N,01131.000,E,022.4,"
+                                 "084.4,230394,003.1,W,A*78\r\n";
+    GPS::RMC rmc;
+    rmc.latitude = 10;
+    ASSERT_THROW(GPS::parseRMC(bytes(invalid_hemisphere), invalid_hemisphere.size(), rmc),
+        MarnavParsingError);
+    ASSERT_THROW(GPS::parseRMC(bytes(invalid_number), invalid_number.size(), rmc),
+        MarnavParsingError);
+    ASSERT_EQ(10, rmc.latitude);
+}
+
+TEST_F(GPSTest, it_parses_a_framed_gsa_with_a_TAG_block_in_place)
+{
+    std::string sentence = "\\s:r1,c:1241544035*7A\\"
+                           "$GNGSA,A,3,05,12,,,,,,,,,,,2.5,1.3,2.1*2C\r\n";
+    GPS::GSA gsa;
+    gsa.satellite_count = 4;
+    ASSERT_TRUE(GPS::parseGSA(bytes(sentence), sentence.size(), gsa));
+    ASSERT_EQ(3, gsa.fix_mode);
+    ASSERT_EQ(2, gsa.satellite_count);
+    ASSERT_EQ(5, gsa.satellite_ids[0]);
+    ASSERT_EQ(12, gsa.satellite_ids[1]);
+    ASSERT_DOUBLE_EQ(2.5, gsa.pdop);
+    ASSERT_DOUBLE_EQ(1.3, gsa.hdop);
+    ASSERT_DOUBLE_EQ(2.1, gsa.vdop);
+}
+
+TEST_F(GPSTest, it_builds_a_solution_from_framed_rmc_and_gsa)
+{
+    std::string rmc_sentence = "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,"
+                               "230394,003.1,W,A*07\r\n";
+    std::string gsa_sentence = "$GNGSA,A,3,05,12,,,,,,,,,,,2.5,1.3,2.1*2C\r\n";
+    GPS::RMC rmc;
+    GPS::GSA gsa;
+    GPS::parseRMC(bytes(rmc_sentence), rmc_sentence.size(), rmc);
+    GPS::parseGSA(bytes(gsa_sentence), gsa_sentence.size(), gsa);
+
+    auto solution = GPS::getSolution(rmc, gsa);
+    ASSERT_NEAR(48.1173, solution.latitude, 1e-6);
+    ASSERT_NEAR(11.516667, solution.longitude, 1e-6);
+    ASSERT_EQ(2, solution.noOfSatellites);
+    ASSERT_EQ(gps_base::GPS_SOLUTION_TYPES::AUTONOMOUS, solution.positionType);
+
+    auto quality = GPS::getSolutionQuality(gsa);
+    ASSERT_EQ(std::vector<int>({5, 12}), quality.usedSatellites);
+    ASSERT_DOUBLE_EQ(1.3, quality.hdop);
+}
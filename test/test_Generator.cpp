@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <nmea0183/AIS.hpp>
+#include <nmea0183/Generator.hpp>
+
+using namespace std;
+using namespace nmea0183;
+
+struct Framed {
+    vector<string> sentences;
+    uint32_t checksum_errors = 0;
+    size_t rejected_bytes = 0;
+};
+
+static Framed frame(string const& data)
+{
+    Framed result;
+    auto buffer = reinterpret_cast<uint8_t const*>(data.data());
+    size_t pos = 0;
+    while (pos < data.size()) {
+        int size =
+            Driver::extractSentence(buffer + pos, data.size() - pos, &result.checksum_errors);
+        if (size == 0) {
+            result.rejected_bytes += data.size() - pos;
+            break;
+        }
+        else if (size < 0) {
+            result.rejected_bytes += -size;
+            pos += -size;
+            continue;
+        }
+        result.sentences.push_back(data.substr(pos, size));
+        pos += size;
+    }
+    return result;
+}
+
+static GeneratorConfig gnssOnly()
+{
+    GeneratorConfig config;
+    config.vessel_count = 0;
+    return config;
+}
+
+static string generate(Generator& generator, double duration)
+{
+    string data;
+    while (generator.next(data).toSeconds() < duration) {
+    }
+    return data;
+}
+
+TEST(GeneratorTest, it_appends_the_checksum_to_a_sentence)
+{
+    ASSERT_EQ("$HEHDT,274.07,T*19\r\n", Generator::finalizeSentence("$HEHDT,274.07,T"));
+}
+
+TEST(GeneratorTest, it_rejects_unsupported_GNSS_sentences)
+{
+    GeneratorConfig config = gnssOnly();
+    config.gnss_sentences = {"RMC", "XYZ"};
+    ASSERT_THROW(Generator generator(config), invalid_argument);
+}
+
+TEST(GeneratorTest, it_generates_the_configured_GNSS_sentences_at_each_epoch)
+{
+    GeneratorConfig config = gnssOnly();
+    config.gnss_sentences = {"RMC", "GGA", "HDT"};
+    Generator generator(config);
+
+    string data;
+    ASSERT_EQ(base::Time(), generator.next(data));
+    ASSERT_EQ(base::Time::fromSeconds(1), generator.next(data));
+
+    auto framed = frame(data);
+    ASSERT_EQ(0, framed.rejected_bytes);
+    ASSERT_EQ(6, framed.sentences.size());
+    vector<string> expected = {"RMC", "GGA", "HDT", "RMC", "GGA", "HDT"};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        auto const& sentence = framed.sentences[i];
+        ASSERT_EQ(expected[i],
+            Driver::peekSentenceTag(
+                reinterpret_cast<uint8_t const*>(sentence.data()), sentence.size()));
+    }
+    ASSERT_EQ(2, generator.getStatistics().gnss_epochs);
+    ASSERT_EQ(6, generator.getStatistics().sentences);
+    ASSERT_EQ(data.size(), generator.getStatistics().bytes);
+}
+
+TEST(GeneratorTest, it_corrupts_checksums)
+{
+    GeneratorConfig config = gnssOnly();
+    config.checksum_error_rate = 1;
+    Generator generator(config);
+    auto framed = frame(generate(generator, 10));
+
+    ASSERT_TRUE(framed.sentences.empty());
+    ASSERT_EQ(generator.getStatistics().sentences, framed.checksum_errors);
+    ASSERT_EQ(generator.getStatistics().sentences,
+        generator.getStatistics().checksum_errors);
+}
+
+TEST(GeneratorTest, it_inserts_garbage_that_the_driver_skips)
+{
+    GeneratorConfig config = gnssOnly();
+    config.garbage_rate = 1;
+    Generator generator(config);
+    auto framed = frame(generate(generator, 10));
+
+    auto const& stats = generator.getStatistics();
+    ASSERT_EQ(stats.sentences, framed.sentences.size());
+    ASSERT_EQ(stats.garbage_bytes, framed.rejected_bytes);
+}
+
+TEST(GeneratorTest, it_is_deterministic_for_a_given_seed)
+{
+    GeneratorConfig config;
+    config.vessel_count = 10;
+    config.garbage_rate = 0.1;
+    config.checksum_error_rate = 0.1;
+    config.seed = 42;
+
+    Generator first(config);
+    Generator second(config);
+    ASSERT_EQ(generate(first, 60), generate(second, 60));
+}
+
+TEST(GeneratorTest, it_generates_AIS_messages_that_can_be_decoded)
+{
+    GeneratorConfig config;
+    config.vessel_count = 10;
+    config.static_period = base::Time::fromSeconds(30);
+    config.gnss_period = base::Time();
+    Generator generator(config);
+    auto framed = frame(generate(generator, 120));
+
+    AIS ais;
+    size_t positions = 0;
+    size_t statics = 0;
+    for (auto const& sentence : framed.sentences) {
+        auto parsed = Driver::parseSentence(
+            reinterpret_cast<uint8_t const*>(sentence.data()), sentence.size());
+        auto message = ais.processSentence(*parsed);
+        if (!message) {
+            continue;
+        }
+
+        if (message->type() == marnav::ais::message_id::position_report_class_a) {
+            auto position = AIS::getPosition(
+                *marnav::ais::message_cast<marnav::ais::message_01>(message.get()));
+            ASSERT_NEAR(-22.9, position.latitude.getDeg(), 0.5);
+            ASSERT_NEAR(-43.15, position.longitude.getDeg(), 0.5);
+            positions++;
+        }
+        else if (message->type() ==
+                 marnav::ais::message_id::static_and_voyage_related_data) {
+            statics++;
+        }
+    }
+
+    ASSERT_EQ(0, ais.getDiscardedSentenceCount());
+    ASSERT_EQ(generator.getStatistics().ais_messages, positions + statics);
+    ASSERT_GE(positions, 110);
+    ASSERT_GE(statics, 30);
+}
+
+TEST(GeneratorTest, it_leaves_the_sequence_id_of_single_fragment_messages_empty)
+{
+    GeneratorConfig config;
+    config.vessel_count = 1;
+    config.gnss_period = base::Time();
+    Generator generator(config);
+    auto framed = frame(generate(generator, 60));
+
+    size_t single_fragments = 0;
+    for (auto const& sentence : framed.sentences) {
+        if (sentence.compare(0, 11, "!AIVDM,1,1,") == 0) {
+            ASSERT_EQ("!AIVDM,1,1,,A,", sentence.substr(0, 14));
+            single_fragments++;
+        }
+    }
+    ASSERT_GT(single_fragments, 0);
+}
+
+TEST(GeneratorTest, it_interleaves_multi_fragment_messages)
+{
+    GeneratorConfig config;
+    config.vessel_count = 10;
+    config.static_period = base::Time::fromSeconds(30);
+    config.gnss_period = base::Time();
+    config.interleave_rate = 1;
+    Generator generator(config);
+    auto framed = frame(generate(generator, 120));
+
+    AIS ais;
+    for (auto const& sentence : framed.sentences) {
+        ais.processSentence(*Driver::parseSentence(
+            reinterpret_cast<uint8_t const*>(sentence.data()), sentence.size()));
+    }
+    ASSERT_GT(generator.getStatistics().interleaved_messages, 0);
+    ASSERT_GT(ais.getDiscardedSentenceCount(), 0);
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <nmea0183/LoadShedder.hpp>
+
+using namespace std;
+using namespace nmea0183;
+
+static const string RMC =
+    "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n";
+static const string XDR = "$GPXDR,C,19.5,C,AIRTEMP*1C\r\n";
+static const string PROPRIETARY = "$PGRMZ,246,f,3*1B\r\n";
+static const string CLASS_A_POSITION =
+    "!AIVDM,1,1,,A,15M67FC000G?ufbE`FepT@3n00Sa,0*5F\r\n";
+static const string CLASS_B_POSITION =
+    "!AIVDM,1,1,,A,B52K>;h00Fc>jpUlNV@ikwpUoP06,0*4C\r\n";
+static const string STATIC_DATA_1 =
+    "!AIVDM,2,1,3,B,55P5TL01VIaAL@7WKO@mBplU@<PDhh000000001S;AJ::4A80?4i@E53,0*3E\r\n";
+static const string STATIC_DATA_2 = "!AIVDM,2,2,3,B,1@0000000000000,2*55\r\n";
+
+struct LoadShedderTest : public ::testing::Test {
+    LoadShedder shedder;
+
+    SentencePriority classify(string const& sentence)
+    {
+        return shedder.classify(
+            reinterpret_cast<uint8_t const*>(sentence.data()), sentence.size());
+    }
+
+    bool accept(string const& sentence, size_t backlog, double time = 0)
+    {
+        return shedder.accept(reinterpret_cast<uint8_t const*>(sentence.data()),
+            sentence.size(),
+            backlog,
+            base::Time::fromSeconds(1000 + time));
+    }
+};
+
+TEST_F(LoadShedderTest, it_gives_a_high_priority_to_own_ship_navigation_sentences)
+{
+    ASSERT_EQ(PRIORITY_HIGH, classify(RMC));
+    ASSERT_EQ(PRIORITY_NORMAL, classify(XDR));
+    ASSERT_EQ(PRIORITY_NORMAL, classify(PROPRIETARY));
+}
+
+TEST_F(LoadShedderTest, it_gives_a_low_priority_to_AIS_class_B_messages)
+{
+    ASSERT_EQ(PRIORITY_NORMAL, classify(CLASS_A_POSITION));
+    ASSERT_EQ(PRIORITY_LOW, classify(CLASS_B_POSITION));
+}
+
+TEST_F(LoadShedderTest, it_classifies_sentences_with_a_tag_block)
+{
+    ASSERT_EQ(PRIORITY_LOW, classify("\\s:station*5B\\" + CLASS_B_POSITION));
+}
+
+TEST_F(LoadShedderTest, it_allows_to_change_the_priorities)
+{
+    shedder.setPriority("XDR", PRIORITY_LOW);
+    shedder.setPriority("VDM", PRIORITY_HIGH);
+    shedder.setAISPriority(18, PRIORITY_NORMAL);
+    ASSERT_EQ(PRIORITY_LOW, classify(XDR));
+    ASSERT_EQ(PRIORITY_HIGH, classify(CLASS_A_POSITION));
+    ASSERT_EQ(PRIORITY_NORMAL, classify(CLASS_B_POSITION));
+}
+
+TEST_F(LoadShedderTest, it_rejects_invalid_tags_and_message_types)
+{
+    ASSERT_THROW(shedder.setPriority("rmc", PRIORITY_HIGH), invalid_argument);
+    ASSERT_THROW(shedder.setAISPriority(0, PRIORITY_HIGH), invalid_argument);
+    ASSERT_THROW(shedder.setAISPriority(64, PRIORITY_HIGH), invalid_argument);
+}
+
+TEST_F(LoadShedderTest, it_is_disabled_until_a_threshold_is_set)
+{
+    ASSERT_FALSE(shedder.isEnabled());
+    shedder.setMaxBacklog(PRIORITY_LOW, 1000);
+    ASSERT_TRUE(shedder.isEnabled());
+    shedder.disable();
+    ASSERT_FALSE(shedder.isEnabled());
+}
+
+TEST_F(LoadShedderTest, it_sheds_the_priorities_whose_backlog_threshold_is_exceeded)
+{
+    shedder.setMaxBacklog(PRIORITY_NORMAL, 4000);
+    shedder.setMaxBacklog(PRIORITY_LOW, 1000);
+
+    ASSERT_TRUE(accept(CLASS_B_POSITION, 1000));
+    ASSERT_FALSE(accept(CLASS_B_POSITION, 1001));
+    ASSERT_TRUE(accept(CLASS_A_POSITION, 1001));
+    ASSERT_FALSE(accept(CLASS_A_POSITION, 4001));
+    ASSERT_TRUE(accept(RMC, 100000));
+
+    ASSERT_EQ(1, shedder.getStatistics(PRIORITY_LOW).kept);
+    ASSERT_EQ(1, shedder.getStatistics(PRIORITY_LOW).shed);
+    ASSERT_EQ(1, shedder.getStatistics(PRIORITY_NORMAL).kept);
+    ASSERT_EQ(1, shedder.getStatistics(PRIORITY_NORMAL).shed);
+    ASSERT_EQ(1, shedder.getStatistics(PRIORITY_HIGH).kept);
+    ASSERT_EQ(2, shedder.getShedCount());
+}
+
+TEST_F(LoadShedderTest, it_applies_the_decision_for_the_first_fragment_to_the_whole_message)
+{
+    shedder.setMaxBacklog(PRIORITY_NORMAL, 1000);
+
+    ASSERT_FALSE(accept(STATIC_DATA_1, 2000));
+    ASSERT_FALSE(accept(STATIC_DATA_2, 0));
+    ASSERT_TRUE(accept(STATIC_DATA_1, 0));
+    ASSERT_TRUE(accept(STATIC_DATA_2, 2000));
+    ASSERT_EQ(2, shedder.getStatistics(PRIORITY_NORMAL).shed);
+}
+
+TEST_F(LoadShedderTest, it_converts_latency_thresholds_with_the_consumption_rate)
+{
+    shedder.setMaxLatency(PRIORITY_LOW, base::Time::fromMilliseconds(100));
+
+    // 1000 bytes consumed in one second
+    for (int i = 0; i < 10; ++i) {
+        accept(string(100, 'x'), 0, i * 0.1);
+    }
+    accept(string(100, 'x'), 0, 1);
+    ASSERT_DOUBLE_EQ(1100, shedder.getConsumptionRate());
+
+    ASSERT_TRUE(accept(CLASS_B_POSITION, 100, 1.1));
+    ASSERT_FALSE(accept(CLASS_B_POSITION, 120, 1.2));
+}
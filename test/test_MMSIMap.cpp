@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <nmea0183/MMSIMap.hpp>
+
+using namespace std;
+using namespace nmea0183;
+
+TEST(MMSIMapTest, it_finds_the_inserted_values)
+{
+    MMSIMap<double> map;
+    ASSERT_EQ(0, map.insert(1, 0.1));
+    ASSERT_EQ(1, map.insert(2, 0.2));
+
+    ASSERT_EQ(1, map.find(2));
+    ASSERT_EQ(0.1, *map.get(1));
+    ASSERT_EQ(MMSIMap<double>::NOT_FOUND, map.find(3));
+    ASSERT_EQ(nullptr, map.get(3));
+}
+
+TEST(MMSIMapTest, it_moves_the_last_value_in_the_slot_of_a_removed_one)
+{
+    MMSIMap<double> map;
+    map.insert(1, 0.1);
+    map.insert(2, 0.2);
+    map.insert(3, 0.3);
+
+    ASSERT_TRUE(map.removeAt(0));
+    ASSERT_EQ(2, map.size());
+    ASSERT_EQ(MMSIMap<double>::NOT_FOUND, map.find(1));
+    ASSERT_EQ(0, map.find(3));
+    ASSERT_EQ(0.3, map[0]);
+    ASSERT_EQ(0.2, *map.get(2));
+}
+
+TEST(MMSIMapTest, it_does_not_move_anything_when_removing_the_last_value)
+{
+    MMSIMap<double> map;
+    map.insert(1, 0.1);
+    map.insert(2, 0.2);
+
+    ASSERT_FALSE(map.removeAt(1));
+    ASSERT_EQ(1, map.size());
+    ASSERT_EQ(0, map.find(1));
+}
+
+TEST(MMSIMapTest, it_removes_the_matching_values_including_moved_ones)
+{
+    MMSIMap<int> map;
+    for (int i = 0; i < 6; ++i) {
+        map.insert(i, i);
+    }
+    map.insert(6, 6);
+
+    // Removing 0 moves 6 to index 0, which must be removed as well
+    ASSERT_EQ(4, map.removeIf([](int value) { return value % 2 == 0; }));
+    ASSERT_EQ(3, map.size());
+    for (int mmsi : {1, 3, 5}) {
+        ASSERT_EQ(mmsi, *map.get(mmsi));
+    }
+    for (int mmsi : {0, 2, 4, 6}) {
+        ASSERT_EQ(nullptr, map.get(mmsi));
+    }
+}
+
+TEST(MMSIMapTest, it_calls_the_remove_function_with_the_matching_indices)
+{
+    MMSIMap<int> map;
+    map.insert(1, 1);
+    map.insert(2, 2);
+
+    vector<uint32_t> removed;
+    ASSERT_EQ(1, map.removeIf([](int value) { return value == 1; },
+        [&](uint32_t index) {
+            removed.push_back(index);
+            map.removeAt(index);
+        }));
+    ASSERT_EQ(vector<uint32_t>{0}, removed);
+    ASSERT_EQ(0, map.find(2));
+}
@@ -0,0 +1,147 @@
+#include <fstream>
+#include <gtest/gtest.h>
+#include <nmea0183/OfflineParser.hpp>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+struct OfflineParserTest : public ::testing::Test {
+    string path;
+
+    OfflineParserTest()
+        : path("/tmp/nmea0183_test_offline_parser." + to_string(getpid()))
+    {
+    }
+
+    ~OfflineParserTest()
+    {
+        unlink(path.c_str());
+    }
+
+    void writeLog(string const& contents)
+    {
+        ofstream file(path, ios::binary);
+        file << contents;
+    }
+
+    vector<OfflineEntry> parse(OfflineParser& parser, OfflineStatistics& stats)
+    {
+        vector<OfflineEntry> entries;
+        stats = parser.process([&entries](OfflineEntry& entry) {
+            entries.push_back(move(entry));
+        });
+        return entries;
+    }
+};
+
+static const string apb = "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+static const vector<string> ais_strings = {
+    "!AIVDM,2,1,3,B,55P5TL01VIaAL@7WKO@mBplU@<PDhh000000001S;AJ::4A80?4i@E53,0*3E\r\n",
+    "!AIVDM,2,2,3,B,1@0000000000000,2*55\r\n"};
+
+TEST_F(OfflineParserTest, it_returns_the_sentences_in_file_order)
+{
+    string log;
+    for (int i = 0; i < 100; ++i) {
+        log += apb + ais_strings[0] + ais_strings[1];
+    }
+    writeLog(log);
+
+    // Use chunks smaller than a sentence, so that every AIS message crosses
+    // a chunk boundary
+    OfflineParser parser(path);
+    parser.setThreadCount(4);
+    parser.setChunkSize(10);
+    OfflineStatistics stats;
+    auto entries = parse(parser, stats);
+
+    ASSERT_EQ(300, entries.size());
+    ASSERT_EQ(300, stats.sentences);
+    ASSERT_EQ(100, stats.messages);
+    ASSERT_EQ(0, stats.discarded_fragments);
+    uint64_t offset = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        ASSERT_EQ(offset, entries[i].offset);
+        offset += (i % 3 == 0) ? apb.size() : ais_strings[i % 3 - 1].size();
+        ASSERT_EQ(i % 3 == 2, static_cast<bool>(entries[i].message));
+    }
+    ASSERT_EQ(marnav::ais::message_id::static_and_voyage_related_data,
+        entries[2].message->type());
+}
+
+TEST_F(OfflineParserTest, it_skips_sentences_that_are_not_terminated_by_CRLF)
+{
+    string lf_only = apb.substr(0, apb.size() - 2) + "\n";
+    string log;
+    for (int i = 0; i < 1000; ++i) {
+        log += lf_only;
+    }
+    writeLog(log + apb);
+
+    OfflineParser parser(path);
+    OfflineStatistics stats;
+    auto entries = parse(parser, stats);
+
+    ASSERT_EQ(1, entries.size());
+    ASSERT_EQ(log.size(), entries[0].offset);
+    ASSERT_EQ(log.size(), stats.rejected_bytes);
+}
+
+TEST_F(OfflineParserTest, it_reassembles_messages_whose_fragments_span_multiple_chunks)
+{
+    // Sentences in between the fragments make the message span more than
+    // one chunk, with chunks that contain no message start
+    writeLog(ais_strings[0] + apb + apb + apb + ais_strings[1]);
+
+    OfflineParser parser(path);
+    parser.setThreadCount(2);
+    parser.setChunkSize(1);
+    OfflineStatistics stats;
+    auto entries = parse(parser, stats);
+
+    ASSERT_EQ(5, entries.size());
+    ASSERT_EQ(1, stats.messages);
+    ASSERT_TRUE(entries[4].message);
+}
+
+TEST_F(OfflineParserTest, it_counts_fragments_discarded_across_chunk_boundaries)
+{
+    writeLog(ais_strings[0] + ais_strings[0] + ais_strings[1] + ais_strings[1]);
+
+    OfflineParser parser(path);
+    parser.setChunkSize(1);
+    OfflineStatistics stats;
+    auto entries = parse(parser, stats);
+
+    ASSERT_EQ(4, entries.size());
+    ASSERT_EQ(1, stats.messages);
+    ASSERT_EQ(2, stats.discarded_fragments);
+    ASSERT_TRUE(entries[2].message);
+}
+
+TEST_F(OfflineParserTest, it_skips_garbage_and_invalid_checksums)
+{
+    string invalid = apb;
+    invalid[invalid.size() - 3] = '3';
+    writeLog("garbage\r\n" + invalid + apb + "$GPAPB,A,A");
+
+    OfflineParser parser(path);
+    OfflineStatistics stats;
+    auto entries = parse(parser, stats);
+
+    ASSERT_EQ(1, entries.size());
+    ASSERT_EQ(9 + invalid.size(), entries[0].offset);
+    ASSERT_EQ(1, stats.checksum_errors);
+    ASSERT_EQ(9 + invalid.size() + 10, stats.rejected_bytes);
+}
+
+TEST_F(OfflineParserTest, it_handles_an_empty_file)
+{
+    writeLog("");
+
+    OfflineParser parser(path);
+    OfflineStatistics stats;
+    auto entries = parse(parser, stats);
+    ASSERT_TRUE(entries.empty());
+}
@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <nmea0183/Driver.hpp>
+#include <nmea0183/SPSCQueue.hpp>
+#include <thread>
+
+using namespace std;
+using namespace nmea0183;
+
+TEST(SPSCQueueTest, it_rounds_the_capacity_up_to_a_power_of_two)
+{
+    SPSCQueue<int> queue(10);
+    ASSERT_EQ(16, queue.capacity());
+}
+
+TEST(SPSCQueueTest, it_returns_the_values_in_push_order)
+{
+    SPSCQueue<int> queue(4);
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(queue.push(int(i)));
+    }
+    ASSERT_EQ(3, queue.size());
+
+    int value;
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_FALSE(queue.pop(value));
+}
+
+TEST(SPSCQueueTest, it_drops_the_newest_value_when_full)
+{
+    SPSCQueue<int> queue(2);
+    ASSERT_TRUE(queue.push(1));
+    ASSERT_TRUE(queue.push(2));
+    ASSERT_FALSE(queue.push(3));
+    ASSERT_EQ(1, queue.getDroppedCount());
+
+    int value;
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(1, value);
+    ASSERT_TRUE(queue.push(4));
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(2, value);
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(4, value);
+}
+
+TEST(SPSCQueueTest, it_allows_to_fill_and_read_the_slots_in_place)
+{
+    SPSCQueue<vector<int>> queue(2);
+    vector<int>* slot = queue.beginPush();
+    ASSERT_TRUE(slot);
+    slot->assign({1, 2, 3});
+    ASSERT_FALSE(queue.front());
+    queue.commitPush();
+
+    vector<int>* front = queue.front();
+    ASSERT_EQ(slot, front);
+    ASSERT_EQ((vector<int>{1, 2, 3}), *front);
+    queue.release();
+    ASSERT_FALSE(queue.front());
+}
+
+TEST(SPSCQueueTest, it_times_out_when_waiting_on_an_empty_queue)
+{
+    SPSCQueue<int> queue(2);
+    auto start = chrono::steady_clock::now();
+    ASSERT_FALSE(queue.waitForData(20));
+    ASSERT_GE(chrono::steady_clock::now() - start, chrono::milliseconds(20));
+}
+
+TEST(SPSCQueueTest, it_wakes_up_the_consumer_when_data_is_pushed)
+{
+    SPSCQueue<int> queue(2);
+    thread producer([&] {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        queue.push(42);
+    });
+    ASSERT_TRUE(queue.waitForData(-1));
+    producer.join();
+
+    int value;
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(42, value);
+}
+
+TEST(SPSCQueueTest, it_wakes_up_the_consumer_when_closed)
+{
+    SPSCQueue<int> queue(2);
+    thread producer([&] {
+        this_thread::sleep_for(chrono::milliseconds(20));
+        queue.close();
+    });
+    ASSERT_FALSE(queue.waitForData(-1));
+    producer.join();
+}
+
+TEST(SPSCQueueTest, it_blocks_the_producer_when_full_with_the_block_policy)
+{
+    SPSCQueue<int> queue(16, SPSC_BLOCK);
+    int const count = 100000;
+    thread producer([&] {
+        for (int i = 0; i < count; ++i) {
+            queue.push(int(i));
+        }
+    });
+
+    for (int i = 0; i < count; ++i) {
+        ASSERT_TRUE(queue.waitForData(-1));
+        int value;
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(i, value);
+    }
+    producer.join();
+    ASSERT_EQ(0, queue.getDroppedCount());
+}
+
+struct SPSCQueueDriverTest : public ::testing::Test,
+                             public iodrivers_base::Fixture<Driver> {
+    void pushStringToDriver(string const& msg)
+    {
+        uint8_t const* msg_u8 = reinterpret_cast<uint8_t const*>(msg.c_str());
+        pushDataToDriver(msg_u8, msg_u8 + msg.size());
+    }
+};
+
+TEST_F(SPSCQueueDriverTest, it_transfers_framed_sentences)
+{
+    string msg = "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+    pushStringToDriver(msg);
+
+    SPSCQueue<FramedSentence> queue(4);
+    driver.readSentence(*queue.beginPush());
+    queue.commitPush();
+
+    FramedSentence const* sentence = queue.front();
+    ASSERT_EQ(msg, string(sentence->data, sentence->data + sentence->size));
+    ASSERT_EQ("APB", sentence->parse()->tag());
+    queue.release();
+}
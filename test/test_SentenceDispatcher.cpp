@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <iodrivers_base/FixtureGTest.hpp>
+#include <marnav/nmea/hdt.hpp>
+#include <marnav/nmea/rmc.hpp>
+#include <nmea0183/SentenceDispatcher.hpp>
+
+using namespace std;
+using namespace marnav;
+using namespace nmea0183;
+
+static const string rmc_string =
+    "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n";
+static const string hdt_string = "$HEHDT,274.07,T*19\r\n";
+
+static bool dispatch(SentenceDispatcher& dispatcher, string const& sentence)
+{
+    return dispatcher.dispatch(
+        reinterpret_cast<uint8_t const*>(sentence.data()), sentence.size());
+}
+
+TEST(SentenceDispatcherTest, it_computes_the_tag_index_at_compile_time)
+{
+    static_assert(SentenceDispatcher::tagIndex("AAA") == 0, "");
+    static_assert(SentenceDispatcher::tagIndex("ZZZ") == 26 * 26 * 26 - 1, "");
+    static_assert(SentenceDispatcher::tagIndex("RmC") == -1, "");
+    ASSERT_EQ(-1, SentenceDispatcher::tagIndex(string_view("RMCX")));
+}
+
+TEST(SentenceDispatcherTest, it_calls_the_handler_registered_for_the_sentence_type)
+{
+    SentenceDispatcher dispatcher;
+    int rmc_count = 0;
+    int hdt_count = 0;
+    dispatcher.on<nmea::rmc>([&](nmea::rmc const& rmc) {
+        ASSERT_EQ("RMC", rmc.tag());
+        rmc_count++;
+    });
+    dispatcher.on<nmea::hdt>([&](nmea::hdt const&) { hdt_count++; });
+
+    ASSERT_TRUE(dispatch(dispatcher, rmc_string));
+    ASSERT_TRUE(dispatch(dispatcher, hdt_string));
+    ASSERT_TRUE(dispatch(dispatcher, rmc_string));
+    ASSERT_EQ(2, rmc_count);
+    ASSERT_EQ(1, hdt_count);
+}
+
+TEST(SentenceDispatcherTest, it_does_not_parse_sentences_without_a_handler)
+{
+    SentenceDispatcher dispatcher;
+    dispatcher.on<nmea::rmc>([&](nmea::rmc const&) {});
+
+    // Would throw MarnavParsingError if it got parsed
+    ASSERT_FALSE(dispatch(dispatcher, "$GPZDA,-1,-1*48\r\n"));
+    ASSERT_EQ(1, dispatcher.getUnhandledCount());
+}
+
+TEST(SentenceDispatcherTest, it_ignores_proprietary_sentences)
+{
+    SentenceDispatcher dispatcher;
+    dispatcher.on("GRM", [](nmea::sentence const&) { FAIL(); });
+    ASSERT_FALSE(dispatch(dispatcher, "$PGRME,15.0,M,45.0,M,25.0,M*1C\r\n"));
+}
+
+TEST(SentenceDispatcherTest, it_replaces_and_removes_handlers)
+{
+    SentenceDispatcher dispatcher;
+    int first = 0;
+    int second = 0;
+    dispatcher.on<nmea::hdt>([&](nmea::hdt const&) { first++; });
+    dispatcher.on("HDT", [&](nmea::sentence const&) { second++; });
+    ASSERT_TRUE(dispatch(dispatcher, hdt_string));
+    ASSERT_EQ(0, first);
+    ASSERT_EQ(1, second);
+
+    dispatcher.remove("HDT");
+    ASSERT_FALSE(dispatch(dispatcher, hdt_string));
+    ASSERT_EQ(1, second);
+}
+
+TEST(SentenceDispatcherTest, it_rejects_invalid_tags)
+{
+    SentenceDispatcher dispatcher;
+    ASSERT_THROW(dispatcher.on("rmc", [](nmea::sentence const&) {}), invalid_argument);
+}
+
+struct SentenceDispatcherDriverTest : public ::testing::Test,
+                                      public iodrivers_base::Fixture<Driver> {
+    void pushStringToDriver(string const& msg)
+    {
+        uint8_t const* msg_u8 = reinterpret_cast<uint8_t const*>(msg.c_str());
+        pushDataToDriver(msg_u8, msg_u8 + msg.size());
+    }
+};
+
+TEST_F(SentenceDispatcherDriverTest, it_reads_and_dispatches_sentences_from_a_driver)
+{
+    SentenceDispatcher dispatcher;
+    int count = 0;
+    dispatcher.on<nmea::hdt>([&](nmea::hdt const&) { count++; });
+
+    pushStringToDriver(rmc_string + hdt_string);
+    ASSERT_FALSE(dispatcher.readSentence(driver));
+    ASSERT_TRUE(dispatcher.readSentence(driver));
+    ASSERT_EQ(1, count);
+}
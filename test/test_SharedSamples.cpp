@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <nmea0183/SharedSamples.hpp>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+struct SharedSamplesTest : public ::testing::Test {
+    string name = "/nmea0183_test_samples." + to_string(getpid());
+
+    gps_base::Solution makeSolution(double latitude)
+    {
+        gps_base::Solution solution;
+        solution.time = base::Time::fromSeconds(1000);
+        solution.latitude = latitude;
+        solution.longitude = -4.5;
+        solution.altitude = 12;
+        solution.positionType = gps_base::DIFFERENTIAL;
+        solution.noOfSatellites = 9;
+        return solution;
+    }
+};
+
+TEST_F(SharedSamplesTest, it_transmits_a_solution)
+{
+    SharedSamplePublisher publisher(name, 16);
+    SharedSampleReader reader(name);
+    publisher.publish(makeSolution(48.25));
+
+    SharedSample sample;
+    ASSERT_TRUE(reader.read(sample));
+    ASSERT_EQ(SHARED_SAMPLE_SOLUTION, sample.type);
+    auto solution = sample.getSolution();
+    ASSERT_EQ(base::Time::fromSeconds(1000), solution.time);
+    ASSERT_EQ(48.25, solution.latitude);
+    ASSERT_EQ(-4.5, solution.longitude);
+    ASSERT_EQ(12, solution.altitude);
+    ASSERT_EQ(gps_base::DIFFERENTIAL, solution.positionType);
+    ASSERT_EQ(9, solution.noOfSatellites);
+    ASSERT_FALSE(reader.read(sample));
+}
+
+TEST_F(SharedSamplesTest, it_transmits_AIS_positions_and_vessel_information)
+{
+    SharedSamplePublisher publisher(name, 16);
+    SharedSampleReader reader(name);
+
+    ais_base::Position position;
+    position.mmsi = 123;
+    position.latitude = base::Angle::fromDeg(48);
+    position.longitude = base::Angle::fromDeg(-4);
+    publisher.publish(position);
+    ais_base::VesselInformation info;
+    info.mmsi = 456;
+    info.name = "VESSEL";
+    publisher.publish(info);
+
+    SharedSample sample;
+    ASSERT_TRUE(reader.read(sample));
+    ASSERT_EQ(SHARED_SAMPLE_POSITION, sample.type);
+    ASSERT_EQ(123, sample.getPosition().mmsi);
+    ASSERT_DOUBLE_EQ(48, sample.getPosition().latitude.getDeg());
+    ASSERT_TRUE(reader.read(sample));
+    ASSERT_EQ(SHARED_SAMPLE_VESSEL_INFORMATION, sample.type);
+    ASSERT_EQ(456, sample.getVesselInformation().mmsi);
+    ASSERT_EQ("VESSEL", sample.getVesselInformation().name);
+}
+
+TEST_F(SharedSamplesTest, it_starts_reading_at_the_samples_published_after_the_reader_creation)
+{
+    SharedSamplePublisher publisher(name, 16);
+    publisher.publish(makeSolution(1));
+    SharedSampleReader reader(name);
+    publisher.publish(makeSolution(2));
+
+    SharedSample sample;
+    ASSERT_TRUE(reader.read(sample));
+    ASSERT_EQ(2, sample.solution.latitude);
+    ASSERT_EQ(1, sample.index);
+}
+
+TEST_F(SharedSamplesTest, it_supports_multiple_readers)
+{
+    SharedSamplePublisher publisher(name, 16);
+    SharedSampleReader reader0(name);
+    SharedSampleReader reader1(name);
+    publisher.publish(makeSolution(1));
+
+    SharedSample sample;
+    ASSERT_TRUE(reader0.read(sample));
+    ASSERT_TRUE(reader1.read(sample));
+    ASSERT_EQ(1, sample.solution.latitude);
+}
+
+TEST_F(SharedSamplesTest, it_counts_the_samples_that_are_overwritten_before_being_read)
+{
+    SharedSamplePublisher publisher(name, 4);
+    SharedSampleReader reader(name);
+    for (int i = 0; i < 10; ++i) {
+        publisher.publish(makeSolution(i));
+    }
+
+    SharedSample sample;
+    ASSERT_TRUE(reader.read(sample));
+    ASSERT_EQ(6, sample.solution.latitude);
+    ASSERT_EQ(6, reader.getLostCount());
+    ASSERT_EQ(10, publisher.getPublishedCount());
+}
+
+TEST_F(SharedSamplesTest, it_seeks_to_the_oldest_sample_in_the_ring)
+{
+    SharedSamplePublisher publisher(name, 4);
+    for (int i = 0; i < 6; ++i) {
+        publisher.publish(makeSolution(i));
+    }
+    SharedSampleReader reader(name);
+    reader.seekToOldest();
+
+    SharedSample sample;
+    ASSERT_TRUE(reader.read(sample));
+    ASSERT_EQ(2, sample.solution.latitude);
+}
+
+TEST_F(SharedSamplesTest, it_throws_if_the_segment_does_not_exist)
+{
+    ASSERT_THROW(SharedSampleReader reader(name), system_error);
+}
+
+TEST_F(SharedSamplesTest, it_never_returns_a_torn_sample)
+{
+    SharedSamplePublisher publisher(name, 8);
+    SharedSampleReader reader(name);
+
+    const int count = 200000;
+    thread writer([&] {
+        for (int i = 0; i < count; ++i) {
+            auto solution = makeSolution(i);
+            solution.longitude = -i;
+            solution.noOfSatellites = i;
+            publisher.publish(solution);
+        }
+    });
+
+    uint64_t received = 0;
+    int64_t last = -1;
+    SharedSample sample;
+    while (last < count - 1) {
+        if (!reader.read(sample)) {
+            continue;
+        }
+        received++;
+        ASSERT_GT(static_cast<int64_t>(sample.index), last);
+        ASSERT_EQ(sample.index, sample.solution.latitude);
+        ASSERT_EQ(-sample.solution.latitude, sample.solution.longitude);
+        ASSERT_EQ(sample.index, sample.solution.satellite_count);
+        last = sample.index;
+    }
+    writer.join();
+    ASSERT_EQ(count, received + reader.getLostCount());
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <nmea0183/TagBlock.hpp>
+
+using namespace std;
+using namespace nmea0183;
+
+static uint8_t const* bytes(string const& data)
+{
+    return reinterpret_cast<uint8_t const*>(data.data());
+}
+
+TEST(TagBlockTest, it_extracts_a_valid_block)
+{
+    string data = "\\s:r1,c:1241544035*7A\\!AIVDM";
+    ASSERT_EQ(22, TagBlock::extract(bytes(data), data.size()));
+}
+
+TEST(TagBlockTest, it_waits_for_the_end_of_an_incomplete_block)
+{
+    string data = "\\s:r1,c:1241";
+    ASSERT_EQ(0, TagBlock::extract(bytes(data), data.size()));
+}
+
+TEST(TagBlockTest, it_rejects_a_block_that_is_too_long)
+{
+    string data = "\\s:" + string(TagBlock::MAX_LENGTH, 'a');
+    ASSERT_EQ(-1, TagBlock::extract(bytes(data), data.size()));
+}
+
+TEST(TagBlockTest, it_rejects_a_block_interrupted_by_a_sentence_start)
+{
+    string data = "\\s:r1$GPAPB";
+    ASSERT_EQ(-1, TagBlock::extract(bytes(data), data.size()));
+}
+
+TEST(TagBlockTest, it_rejects_and_counts_a_block_with_an_invalid_checksum)
+{
+    string data = "\\s:r1,c:1241544035*7B\\";
+    uint32_t errors = 0;
+    ASSERT_EQ(-1, TagBlock::extract(bytes(data), data.size(), &errors));
+    ASSERT_EQ(1, errors);
+}
+
+TEST(TagBlockTest, it_rejects_a_block_without_checksum)
+{
+    string data = "\\s:r1,c:1241544035\\";
+    uint32_t errors = 0;
+    ASSERT_EQ(-1, TagBlock::extract(bytes(data), data.size(), &errors));
+    ASSERT_EQ(0, errors);
+}
+
+TEST(TagBlockTest, it_parses_the_block_fields)
+{
+    string data = "\\g:1-2-73874,n:157036,s:r003669945,c:1241544035*4A\\!AIVDM";
+    auto block = TagBlock::parse(bytes(data), data.size());
+    ASSERT_TRUE(block.valid);
+    ASSERT_EQ("r003669945", block.source);
+    ASSERT_EQ(base::Time::fromSeconds(1241544035), block.time);
+    ASSERT_EQ(157036, block.line_count);
+    ASSERT_EQ(1, block.group_sentence);
+    ASSERT_EQ(2, block.group_size);
+    ASSERT_EQ(73874, block.group_id);
+    ASSERT_TRUE(block.destination.empty());
+    ASSERT_TRUE(block.text.empty());
+}
+
+TEST(TagBlockTest, it_interprets_large_timestamps_as_milliseconds)
+{
+    string data = "\\s:station1,c:1700000000123*41\\";
+    auto block = TagBlock::parse(bytes(data), data.size());
+    ASSERT_EQ(base::Time::fromMilliseconds(1700000000123), block.time);
+}
+
+TEST(TagBlockTest, it_leaves_absent_fields_at_their_defaults)
+{
+    string data = "\\s:r1*00\\";
+    auto block = TagBlock::parse(bytes(data), data.size());
+    ASSERT_TRUE(block.valid);
+    ASSERT_EQ("r1", block.source);
+    ASSERT_TRUE(block.time.isNull());
+    ASSERT_EQ(-1, block.line_count);
+    ASSERT_EQ(0, block.group_size);
+}
+
+TEST(TagBlockTest, it_reports_no_block_on_a_plain_sentence)
+{
+    string data = "$GPAPB,A*00\r\n";
+    ASSERT_EQ(0, TagBlock::getSize(bytes(data), data.size()));
+    ASSERT_FALSE(TagBlock::parse(bytes(data), data.size()).valid);
+}
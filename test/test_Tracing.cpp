@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include <nmea0183/Tracing.hpp>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+using namespace nmea0183;
+using namespace nmea0183::tracing;
+
+struct TracingTest : public ::testing::Test {
+    TracingTest()
+    {
+        clear();
+        setEnabled(true);
+    }
+    ~TracingTest()
+    {
+        clear();
+        setEnabled(true);
+    }
+};
+
+TEST_F(TracingTest, it_returns_the_recorded_events)
+{
+    record(STAGE_PARSE, 42, 1000, 1500);
+    record(STAGE_DECODE, 42, 1500, 1700);
+
+    auto events = getEvents();
+    ASSERT_EQ(2, events.size());
+    ASSERT_EQ(STAGE_PARSE, events[0].stage);
+    ASSERT_EQ(42, events[0].id);
+    ASSERT_EQ(1000, events[0].start);
+    ASSERT_EQ(500, events[0].duration);
+    ASSERT_EQ(STAGE_DECODE, events[1].stage);
+    ASSERT_EQ(200, events[1].duration);
+}
+
+TEST_F(TracingTest, it_records_a_scope_with_the_current_id)
+{
+    setCurrentId(12);
+    {
+        Scope scope(STAGE_POSITION);
+    }
+
+    auto events = getEvents();
+    ASSERT_EQ(1, events.size());
+    ASSERT_EQ(STAGE_POSITION, events[0].stage);
+    ASSERT_EQ(12, events[0].id);
+}
+
+TEST_F(TracingTest, it_generates_unique_ids)
+{
+    uint64_t first = newId();
+    uint64_t second = newId();
+    ASSERT_NE(0, first);
+    ASSERT_NE(first, second);
+}
+
+TEST_F(TracingTest, it_keeps_the_current_id_per_thread)
+{
+    setCurrentId(1);
+    thread t([] {
+        ASSERT_EQ(0, getCurrentId());
+        setCurrentId(2);
+    });
+    t.join();
+    ASSERT_EQ(1, getCurrentId());
+}
+
+TEST_F(TracingTest, it_records_the_events_of_each_thread_in_its_own_ring)
+{
+    record(STAGE_READ, 1, 0, 10);
+    thread t([] { record(STAGE_QUEUE, 1, 10, 30); });
+    t.join();
+
+    auto events = getEvents();
+    ASSERT_EQ(2, events.size());
+    ASSERT_NE(events[0].thread, events[1].thread);
+}
+
+TEST_F(TracingTest, it_only_keeps_the_most_recent_events)
+{
+    for (uint32_t i = 0; i < RING_SIZE + 10; ++i) {
+        record(STAGE_EXTRACT, i, i, i + 1);
+    }
+
+    auto events = getEvents();
+    ASSERT_EQ(RING_SIZE - 1, events.size());
+    ASSERT_EQ(11, events.front().id);
+    ASSERT_EQ(RING_SIZE + 9, events.back().id);
+}
+
+TEST_F(TracingTest, it_drops_the_events_on_clear)
+{
+    record(STAGE_READ, 1, 0, 10);
+    clear();
+    record(STAGE_READ, 2, 0, 10);
+
+    auto events = getEvents();
+    ASSERT_EQ(1, events.size());
+    ASSERT_EQ(2, events[0].id);
+}
+
+TEST_F(TracingTest, it_does_not_record_when_disabled)
+{
+    setEnabled(false);
+    record(STAGE_READ, 1, 0, 10);
+    ASSERT_TRUE(getEvents().empty());
+}
+
+TEST_F(TracingTest, it_computes_per_stage_statistics)
+{
+    vector<Event> events;
+    for (uint32_t i = 1; i <= 100; ++i) {
+        events.push_back(Event{i, 0, i * 10, STAGE_DECODE, 0});
+    }
+    events.push_back(Event{0, 0, 5, STAGE_READ, 0});
+
+    auto summary = getSummary(events);
+    ASSERT_EQ(2, summary.size());
+    ASSERT_EQ(STAGE_READ, summary[0].stage);
+    ASSERT_EQ(1, summary[0].count);
+    ASSERT_EQ(5, summary[0].p99);
+
+    auto const& decode = summary[1];
+    ASSERT_EQ(STAGE_DECODE, decode.stage);
+    ASSERT_EQ(100, decode.count);
+    ASSERT_EQ(10, decode.min);
+    ASSERT_EQ(505, decode.mean);
+    ASSERT_EQ(500, decode.p50);
+    ASSERT_EQ(900, decode.p90);
+    ASSERT_EQ(990, decode.p99);
+    ASSERT_EQ(1000, decode.max);
+}
+
+TEST_F(TracingTest, it_exports_the_events_in_the_chrome_trace_format)
+{
+    vector<Event> events = {Event{7, 2000, 1500, STAGE_PARSE, 3}};
+    ostringstream out;
+    writeChromeTrace(out, events);
+
+    string json = out.str();
+    ASSERT_EQ(0, json.find("{\"traceEvents\":["));
+    ASSERT_NE(string::npos,
+        json.find("{\"name\":\"parse\",\"cat\":\"nmea0183\",\"ph\":\"X\",\"pid\":1,"
+                  "\"tid\":3,\"ts\":2.000,\"dur\":1.500,\"args\":{\"id\":7}}"));
+}
+
+TEST_F(TracingTest, it_writes_the_summary_in_microseconds)
+{
+    vector<Event> events = {Event{7, 2000, 1500, STAGE_PARSE, 3}};
+    ostringstream out;
+    writeSummary(out, getSummary(events));
+
+    string text = out.str();
+    ASSERT_NE(string::npos, text.find("parse"));
+    ASSERT_NE(string::npos, text.find("1.500"));
+}
@@ -0,0 +1,169 @@
+#include "Helpers.hpp"
+#include <gtest/gtest.h>
+#include <nmea0183/TrackHistory.hpp>
+
+using namespace std;
+using namespace nmea0183;
+using test::makePosition;
+
+static vector<ais_base::Position> getAll(TrackHistory const& history, int mmsi)
+{
+    vector<ais_base::Position> samples;
+    history.getTrack(mmsi, base::Time(), base::Time::fromSeconds(1e9), samples);
+    return samples;
+}
+
+static const size_t LARGE_BUDGET = 1 << 20;
+
+TEST(TrackHistoryTest, it_restores_the_samples_at_the_quantization_resolution)
+{
+    TrackHistory history(10, LARGE_BUDGET);
+    for (int i = 0; i < 5; ++i) {
+        auto position =
+            makePosition(1, 1000 + i * 10.01, 59 + i * 1e-3, 10.5 - i * 1e-3, -45.5, 5.25);
+        position.yaw = base::Angle::fromDeg(120);
+        history.update(position);
+    }
+
+    auto samples = getAll(history, 1);
+    ASSERT_EQ(5, samples.size());
+    for (int i = 0; i < 5; ++i) {
+        auto const& sample = samples[i];
+        ASSERT_EQ(1, sample.mmsi);
+        ASSERT_NEAR(1000 + i * 10.01, sample.time.toSeconds(), 0.05);
+        ASSERT_NEAR(59 + i * 1e-3, sample.latitude.getDeg(), 1e-5);
+        ASSERT_NEAR(10.5 - i * 1e-3, sample.longitude.getDeg(), 1e-5);
+        ASSERT_NEAR(5.25, sample.speed_over_ground, 0.01);
+        ASSERT_NEAR(-45.5, sample.course_over_ground.getDeg(), 0.01);
+        ASSERT_NEAR(120, sample.yaw.getDeg(), 0.01);
+    }
+}
+
+TEST(TrackHistoryTest, it_keeps_the_most_recent_samples_up_to_its_capacity)
+{
+    TrackHistory history(4, LARGE_BUDGET);
+    for (int i = 0; i < 10; ++i) {
+        history.update(makePosition(1, i, 59 + i * 1e-3, 10));
+    }
+
+    auto samples = getAll(history, 1);
+    ASSERT_EQ(4, samples.size());
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_NEAR(6 + i, samples[i].time.toSeconds(), 1e-6);
+        ASSERT_NEAR(59 + (6 + i) * 1e-3, samples[i].latitude.getDeg(), 1e-5);
+    }
+}
+
+TEST(TrackHistoryTest, it_keeps_the_last_sample_with_a_capacity_of_one)
+{
+    TrackHistory history(1, LARGE_BUDGET);
+    for (int i = 0; i < 3; ++i) {
+        history.update(makePosition(1, i, 59 + i * 1e-3, 10 - i * 1e-3, i * 10, i));
+    }
+
+    auto samples = getAll(history, 1);
+    ASSERT_EQ(1, samples.size());
+    ASSERT_NEAR(2, samples[0].time.toSeconds(), 1e-6);
+    ASSERT_NEAR(59.002, samples[0].latitude.getDeg(), 1e-5);
+    ASSERT_NEAR(9.998, samples[0].longitude.getDeg(), 1e-5);
+    ASSERT_NEAR(2, samples[0].speed_over_ground, 0.01);
+    ASSERT_NEAR(20, samples[0].course_over_ground.getDeg(), 0.01);
+}
+
+TEST(TrackHistoryTest, it_extracts_a_time_range)
+{
+    TrackHistory history(100, LARGE_BUDGET);
+    for (int i = 0; i < 50; ++i) {
+        history.update(makePosition(1, i, 59, 10));
+    }
+
+    vector<ais_base::Position> samples;
+    ASSERT_EQ(11, history.getTrack(1,
+                      base::Time::fromSeconds(10),
+                      base::Time::fromSeconds(20),
+                      samples));
+    ASSERT_NEAR(10, samples.front().time.toSeconds(), 1e-6);
+    ASSERT_NEAR(20, samples.back().time.toSeconds(), 1e-6);
+}
+
+TEST(TrackHistoryTest, it_preserves_unknown_fields)
+{
+    TrackHistory history(10, LARGE_BUDGET);
+    history.update(makePosition(1, 0, 59, 10));
+
+    auto sample = getAll(history, 1).at(0);
+    ASSERT_TRUE(std::isnan(sample.speed_over_ground));
+    ASSERT_TRUE(std::isnan(sample.course_over_ground.getRad()));
+    ASSERT_TRUE(std::isnan(sample.yaw.getRad()));
+}
+
+TEST(TrackHistoryTest, it_follows_a_target_across_the_antimeridian)
+{
+    TrackHistory history(3, LARGE_BUDGET);
+    history.update(makePosition(1, 0, 10, 179.999));
+    history.update(makePosition(1, 1, 10, -179.999));
+    history.update(makePosition(1, 2, 10, -179.998));
+    history.update(makePosition(1, 3, 10, -179.997));
+
+    auto samples = getAll(history, 1);
+    ASSERT_EQ(3, samples.size());
+    ASSERT_NEAR(-179.999, samples[0].longitude.getDeg(), 1e-5);
+    ASSERT_NEAR(-179.997, samples[2].longitude.getDeg(), 1e-5);
+}
+
+TEST(TrackHistoryTest, it_restarts_a_track_if_the_delta_to_the_last_sample_is_too_large)
+{
+    TrackHistory history(10, LARGE_BUDGET);
+    history.update(makePosition(1, 0, 59, 10));
+    history.update(makePosition(1, 10, 59, 10));
+    history.update(makePosition(1, 20, 60, 10));
+    history.update(makePosition(1, 10000, 60, 10));
+
+    auto samples = getAll(history, 1);
+    ASSERT_EQ(1, samples.size());
+    ASSERT_NEAR(10000, samples[0].time.toSeconds(), 1e-6);
+}
+
+TEST(TrackHistoryTest, it_rejects_samples_older_than_the_last_one)
+{
+    TrackHistory history(10, LARGE_BUDGET);
+    ASSERT_TRUE(history.update(makePosition(1, 10, 59, 10)));
+    ASSERT_FALSE(history.update(makePosition(1, 5, 59, 10)));
+    ASSERT_EQ(1, history.getSampleCount(1));
+}
+
+TEST(TrackHistoryTest, it_evicts_the_least_recently_updated_target_when_over_budget)
+{
+    TrackHistory history(10, 3 * TrackHistory::getTrackMemorySize(10));
+    ASSERT_EQ(3, history.getMaxTrackCount());
+    history.update(makePosition(1, 0, 59, 10));
+    history.update(makePosition(2, 1, 59, 10));
+    history.update(makePosition(3, 2, 59, 10));
+    history.update(makePosition(1, 3, 59, 10));
+    history.update(makePosition(4, 4, 59, 10));
+
+    ASSERT_EQ(3, history.size());
+    ASSERT_EQ(1, history.getEvictionCount());
+    ASSERT_EQ(0, history.getSampleCount(2));
+    ASSERT_EQ(2, history.getSampleCount(1));
+    ASSERT_EQ(1, history.getSampleCount(3));
+    ASSERT_EQ(1, history.getSampleCount(4));
+}
+
+TEST(TrackHistoryTest, it_reuses_the_storage_of_removed_targets)
+{
+    TrackHistory history(10, LARGE_BUDGET);
+    history.update(makePosition(1, 0, 59, 10));
+    ASSERT_TRUE(history.remove(1));
+    ASSERT_FALSE(history.remove(1));
+    history.update(makePosition(2, 10, 60, 11));
+    ASSERT_EQ(1, history.size());
+    ASSERT_EQ(0, history.getSampleCount(1));
+    ASSERT_NEAR(60, getAll(history, 2).at(0).latitude.getDeg(), 1e-5);
+}
+
+TEST(TrackHistoryTest, it_rejects_a_budget_too_small_for_a_single_track)
+{
+    ASSERT_THROW(TrackHistory(10, 10), invalid_argument);
+    ASSERT_THROW(TrackHistory(0, LARGE_BUDGET), invalid_argument);
+}
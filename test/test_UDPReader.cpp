@@ -0,0 +1,155 @@
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <nmea0183/UDPReader.hpp>
+#include <unistd.h>
+
+using namespace std;
+using namespace nmea0183;
+
+static const string apb = "$GPAPB,A,A,0.10,R,N,V,V,11.0,M,DEST,11.0,M,11.0,M*12\r\n";
+static const string hdt = "$HEHDT,274.07,T*19\r\n";
+
+struct UDPReaderTest : public ::testing::Test {
+    UDPReader reader;
+    int sender;
+    sockaddr_in destination = {};
+
+    UDPReaderTest()
+        : reader(0, "127.0.0.1", 4, 256)
+    {
+        sender = socket(AF_INET, SOCK_DGRAM, 0);
+        destination.sin_family = AF_INET;
+        destination.sin_port = htons(reader.getLocalPort());
+        destination.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+
+    ~UDPReaderTest()
+    {
+        close(sender);
+    }
+
+    void send(string const& datagram)
+    {
+        sendto(sender,
+            datagram.data(),
+            datagram.size(),
+            0,
+            reinterpret_cast<sockaddr const*>(&destination),
+            sizeof(destination));
+    }
+
+    size_t receive(vector<UDPSentence>& sentences)
+    {
+        return reader.receive(sentences, base::Time::fromSeconds(1));
+    }
+
+    static string toString(UDPSentence const& sentence)
+    {
+        return string(sentence.data, sentence.data + sentence.size);
+    }
+};
+
+TEST_F(UDPReaderTest, it_frames_all_sentences_of_a_datagram)
+{
+    send(apb + hdt + apb);
+
+    vector<UDPSentence> sentences;
+    ASSERT_EQ(1, receive(sentences));
+    ASSERT_EQ(3, sentences.size());
+    ASSERT_EQ(apb, toString(sentences[0]));
+    ASSERT_EQ(hdt, toString(sentences[1]));
+    ASSERT_EQ(apb, toString(sentences[2]));
+}
+
+TEST_F(UDPReaderTest, it_receives_several_datagrams_at_once)
+{
+    for (int i = 0; i < 3; ++i) {
+        send(hdt);
+    }
+
+    vector<UDPSentence> sentences;
+    size_t datagrams = 0;
+    while (datagrams < 3) {
+        size_t count = receive(sentences);
+        ASSERT_GT(count, 0);
+        datagrams += count;
+    }
+    ASSERT_EQ(3, sentences.size());
+    ASSERT_EQ(3, reader.getStatistics().datagrams);
+}
+
+TEST_F(UDPReaderTest, it_accepts_a_last_sentence_without_CRLF)
+{
+    send(apb + hdt.substr(0, hdt.size() - 2));
+
+    vector<UDPSentence> sentences;
+    ASSERT_EQ(1, receive(sentences));
+    ASSERT_EQ(2, sentences.size());
+    ASSERT_EQ(hdt, toString(sentences[1]));
+}
+
+TEST_F(UDPReaderTest, it_accepts_a_last_sentence_terminated_by_LF_only)
+{
+    send(hdt.substr(0, hdt.size() - 2) + "\n");
+
+    vector<UDPSentence> sentences;
+    ASSERT_EQ(1, receive(sentences));
+    ASSERT_EQ(1, sentences.size());
+    ASSERT_EQ(hdt, toString(sentences[0]));
+    ASSERT_EQ(0, reader.getStatistics().rejected_bytes);
+}
+
+TEST_F(UDPReaderTest, it_accepts_several_sentences_terminated_by_LF_only)
+{
+    send(apb.substr(0, apb.size() - 2) + "\n" + hdt.substr(0, hdt.size() - 2) + "\n");
+
+    vector<UDPSentence> sentences;
+    ASSERT_EQ(1, receive(sentences));
+    ASSERT_EQ(2, sentences.size());
+    ASSERT_EQ(apb, toString(sentences[0]));
+    ASSERT_EQ(hdt, toString(sentences[1]));
+    ASSERT_EQ(0, reader.getStatistics().rejected_bytes);
+    ASSERT_EQ(0, reader.getStatistics().checksum_errors);
+}
+
+TEST_F(UDPReaderTest, it_does_not_join_sentences_across_datagrams)
+{
+    send(apb.substr(0, 20));
+    send(apb.substr(20));
+
+    vector<UDPSentence> sentences;
+    size_t datagrams = 0;
+    while (datagrams < 2) {
+        datagrams += receive(sentences);
+    }
+    ASSERT_TRUE(sentences.empty());
+    ASSERT_EQ(apb.size() + 2, reader.getStatistics().rejected_bytes);
+}
+
+TEST_F(UDPReaderTest, it_keeps_the_source_address_of_each_sentence)
+{
+    sockaddr_in local;
+    socklen_t size = sizeof(local);
+    send(hdt);
+    getsockname(sender, reinterpret_cast<sockaddr*>(&local), &size);
+
+    vector<UDPSentence> sentences;
+    ASSERT_EQ(1, receive(sentences));
+    ASSERT_EQ("127.0.0.1:" + to_string(ntohs(local.sin_port)),
+        UDPReader::formatAddress(*sentences[0].source));
+}
+
+TEST_F(UDPReaderTest, it_counts_truncated_datagrams)
+{
+    send(string(300, 'x'));
+
+    vector<UDPSentence> sentences;
+    ASSERT_EQ(1, receive(sentences));
+    ASSERT_EQ(1, reader.getStatistics().truncated_datagrams);
+}
+
+TEST_F(UDPReaderTest, it_returns_zero_on_timeout)
+{
+    vector<UDPSentence> sentences;
+    ASSERT_EQ(0, reader.receive(sentences, base::Time::fromMilliseconds(10)));
+}